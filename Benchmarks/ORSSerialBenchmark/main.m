@@ -0,0 +1,499 @@
+//
+//  main.m
+//  ORSSerialBenchmark
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//	Drives ORSSerialPorts through pseudo terminal pairs and prints one JSON object per
+//	configuration (JSON Lines) to stdout. Progress goes to stderr.
+//
+//	Usage: swift run -c release ORSSerialBenchmark [-descriptorCounts 1,8,64] [-packetSizes 16,256]
+//	       [-chunkSizes 64,4096] [-portCounts 1,8,256] [-reactor off,on] [-packetCount 20000]
+//	       [-requestCount 2000]
+//
+
+#import <Foundation/Foundation.h>
+#import <ORSSerial/ORSSerial.h>
+#import <mach/mach.h>
+#import <mach/mach_time.h>
+#import <malloc/malloc.h>
+#import <sys/resource.h>
+#import <stdatomic.h>
+#import <unistd.h>
+
+#pragma mark - Measurement
+
+static uint64_t ORSBenchmarkNanoseconds(void)
+{
+	static mach_timebase_info_data_t timebase;
+	if (timebase.denom == 0) mach_timebase_info(&timebase);
+	return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+static double ORSBenchmarkCPUSeconds(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (double)usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + (double)usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// Allocations are counted by wrapping the default malloc zone's allocation functions. This counts
+// everything in the process, including the writer and responder threads, so it's an upper bound.
+static atomic_uint_fast64_t ORSBenchmarkAllocationCount;
+static void *(*ORSBenchmarkZoneMalloc)(malloc_zone_t *zone, size_t size);
+static void *(*ORSBenchmarkZoneCalloc)(malloc_zone_t *zone, size_t count, size_t size);
+static void *(*ORSBenchmarkZoneRealloc)(malloc_zone_t *zone, void *pointer, size_t size);
+
+static void *ORSBenchmarkCountingMalloc(malloc_zone_t *zone, size_t size)
+{
+	atomic_fetch_add_explicit(&ORSBenchmarkAllocationCount, 1, memory_order_relaxed);
+	return ORSBenchmarkZoneMalloc(zone, size);
+}
+
+static void *ORSBenchmarkCountingCalloc(malloc_zone_t *zone, size_t count, size_t size)
+{
+	atomic_fetch_add_explicit(&ORSBenchmarkAllocationCount, 1, memory_order_relaxed);
+	return ORSBenchmarkZoneCalloc(zone, count, size);
+}
+
+static void *ORSBenchmarkCountingRealloc(malloc_zone_t *zone, void *pointer, size_t size)
+{
+	atomic_fetch_add_explicit(&ORSBenchmarkAllocationCount, 1, memory_order_relaxed);
+	return ORSBenchmarkZoneRealloc(zone, pointer, size);
+}
+
+static void ORSBenchmarkStartCountingAllocations(void)
+{
+	vm_address_t *zones = NULL;
+	unsigned int zoneCount = 0;
+	if (malloc_get_all_zones(mach_task_self(), NULL, &zones, &zoneCount) != KERN_SUCCESS || zoneCount == 0) return;
+	malloc_zone_t *zone = (malloc_zone_t *)zones[0]; // Where malloc() goes
+
+	// Zone structures are read-only, so make the page writable just long enough to swap in the counters
+	vm_address_t page = trunc_page((vm_address_t)zone);
+	if (vm_protect(mach_task_self(), page, vm_page_size, 0, VM_PROT_READ | VM_PROT_WRITE) != KERN_SUCCESS) return;
+	ORSBenchmarkZoneMalloc = zone->malloc;
+	ORSBenchmarkZoneCalloc = zone->calloc;
+	ORSBenchmarkZoneRealloc = zone->realloc;
+	zone->malloc = ORSBenchmarkCountingMalloc;
+	zone->calloc = ORSBenchmarkCountingCalloc;
+	zone->realloc = ORSBenchmarkCountingRealloc;
+	vm_protect(mach_task_self(), page, vm_page_size, 0, VM_PROT_READ);
+}
+
+static uint64_t ORSBenchmarkAllocations(void)
+{
+	return atomic_load_explicit(&ORSBenchmarkAllocationCount, memory_order_relaxed);
+}
+
+static NSData *ORSBenchmarkPacket(char first, char fill, NSUInteger length)
+{
+	NSMutableData *packet = [NSMutableData dataWithLength:length];
+	uint8_t *bytes = [packet mutableBytes];
+	memset(bytes, fill, length);
+	bytes[0] = first;
+	bytes[length - 1] = ';';
+	return packet;
+}
+
+static BOOL ORSBenchmarkWriteAll(int descriptor, const uint8_t *bytes, NSUInteger length)
+{
+	while (length > 0) {
+		ssize_t written = write(descriptor, bytes, length);
+		if (written < 0) {
+			if (errno == EINTR) continue;
+			return NO;
+		}
+		bytes += written;
+		length -= written;
+	}
+	return YES;
+}
+
+#pragma mark - Client
+
+// One port under test and the pseudo terminal that drives it
+@interface ORSBenchmarkClient : NSObject <ORSSerialPortDelegate>
+{
+	atomic_uint_fast64_t _receivedPacketCount;
+	uint64_t *_latencies; // Nanoseconds
+	uint64_t _requestSentTime;
+}
+
+- (instancetype)initWithDelegateQueue:(dispatch_queue_t)delegateQueue;
+
+@property (nonatomic, strong, readonly) ORSSerialPseudoTerminalTransport *transport;
+@property (nonatomic, strong, readonly) ORSSerialPort *port;
+
+// Throughput
+- (void)resetReceivedPacketCount;
+@property (nonatomic) uint64_t expectedPacketCount;
+@property (nonatomic, strong) dispatch_group_t group; // Left once every expected packet has been received
+
+// Latency
+@property (nonatomic) NSUInteger requestCount;
+@property (nonatomic) NSUInteger completedRequestCount;
+@property (nonatomic, copy) NSData *requestData;
+@property (nonatomic, strong) ORSSerialPacketDescriptor *responseDescriptor;
+@property (nonatomic, readonly) uint64_t *latencies;
+
+@end
+
+@implementation ORSBenchmarkClient
+
+- (instancetype)initWithDelegateQueue:(dispatch_queue_t)delegateQueue
+{
+	self = [super init];
+	if (self) {
+		_transport = [[ORSSerialPseudoTerminalTransport alloc] init];
+		if (!_transport) return nil;
+		_port = [ORSSerialPort serialPortWithTransport:_transport];
+		_port.delegateQueue = delegateQueue;
+		_port.delegate = self;
+		atomic_init(&_receivedPacketCount, 0);
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_latencies);
+}
+
+- (uint64_t *)latencies { return _latencies; }
+
+- (void)resetReceivedPacketCount { atomic_store(&_receivedPacketCount, 0); }
+
+- (void)sendNextRequest
+{
+	_requestSentTime = ORSBenchmarkNanoseconds();
+	[self.port sendRequest:[ORSSerialRequest requestWithDataToSend:self.requestData userInfo:nil timeoutInterval:5.0 responseDescriptor:self.responseDescriptor]];
+}
+
+- (void)startRequests
+{
+	free(_latencies);
+	_latencies = calloc(self.requestCount, sizeof(uint64_t));
+	self.completedRequestCount = 0;
+	[self sendNextRequest];
+}
+
+#pragma mark ORSSerialPortDelegate
+
+- (void)serialPortWasRemovedFromSystem:(ORSSerialPort *)serialPort {}
+
+- (void)serialPort:(ORSSerialPort *)serialPort didEncounterError:(NSError *)error
+{
+	fprintf(stderr, "%s: %s\n", [serialPort.path UTF8String], [[error localizedDescription] UTF8String]);
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort didReceivePacket:(NSData *)packetData matchingDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	uint64_t count = atomic_fetch_add_explicit(&_receivedPacketCount, 1, memory_order_relaxed) + 1;
+	if (count == self.expectedPacketCount) dispatch_group_leave(self.group);
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort didReceiveResponse:(NSData *)responseData toRequest:(ORSSerialRequest *)request
+{
+	_latencies[self.completedRequestCount++] = ORSBenchmarkNanoseconds() - _requestSentTime;
+	if (self.completedRequestCount < self.requestCount) {
+		[self sendNextRequest];
+	} else {
+		dispatch_group_leave(self.group);
+	}
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort requestDidTimeout:(ORSSerialRequest *)request
+{
+	fprintf(stderr, "%s: request timed out\n", [serialPort.path UTF8String]);
+	dispatch_group_leave(self.group);
+}
+
+@end
+
+#pragma mark - Benchmarks
+
+static NSArray *ORSBenchmarkClients(NSUInteger count, BOOL usesSharedReactor)
+{
+	NSMutableArray *clients = [NSMutableArray array];
+	for (NSUInteger i = 0; i < count; i++) {
+		dispatch_queue_t queue = dispatch_queue_create("com.openreelsoftware.ORSSerialBenchmark.delegateQueue", 0);
+		ORSBenchmarkClient *client = [[ORSBenchmarkClient alloc] initWithDelegateQueue:queue];
+		if (!client) {
+			fprintf(stderr, "Couldn't create a pseudo terminal: %s\n", strerror(errno));
+			exit(EXIT_FAILURE);
+		}
+		client.port.usesSharedReactor = usesSharedReactor;
+		[client.port open];
+		[clients addObject:client];
+	}
+	return clients;
+}
+
+static void ORSBenchmarkCloseClients(NSArray *clients)
+{
+	for (ORSBenchmarkClient *client in clients) [client.port close];
+}
+
+static NSDictionary *ORSBenchmarkThroughput(NSUInteger descriptorCount, NSUInteger packetSize, NSUInteger chunkSize, NSUInteger portCount, BOOL usesSharedReactor, NSUInteger packetCount)
+{
+	NSArray *clients = ORSBenchmarkClients(portCount, usesSharedReactor);
+	for (ORSBenchmarkClient *client in clients) {
+		client.port.maximumReadLength = chunkSize;
+		[client.port startListeningForPacketsMatchingDescriptor:[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:packetSize userInfo:nil]];
+		for (NSUInteger i = 1; i < descriptorCount; i++) {
+			// Never match, but are still installed while the stream is scanned
+			NSString *prefix = [NSString stringWithFormat:@"#%lu", (unsigned long)i];
+			[client.port startListeningForPacketsMatchingDescriptor:[[ORSSerialPacketDescriptor alloc] initWithPrefixString:prefix suffixString:@";" maximumPacketLength:packetSize userInfo:nil]];
+		}
+	}
+
+	NSMutableData *stream = [NSMutableData dataWithCapacity:packetSize * packetCount];
+	NSData *packet = ORSBenchmarkPacket('!', 'a', packetSize);
+	for (NSUInteger i = 0; i < packetCount; i++) [stream appendData:packet];
+
+	dispatch_group_t group = dispatch_group_create();
+	for (ORSBenchmarkClient *client in clients) {
+		[client resetReceivedPacketCount];
+		client.expectedPacketCount = packetCount;
+		client.group = group;
+		dispatch_group_enter(group);
+	}
+
+	uint64_t allocationsBefore = ORSBenchmarkAllocations();
+	double cpuBefore = ORSBenchmarkCPUSeconds();
+	uint64_t start = ORSBenchmarkNanoseconds();
+	dispatch_apply(portCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t index) {
+		ORSBenchmarkClient *client = clients[index];
+		int peer = client.transport.peerFileDescriptor;
+		const uint8_t *bytes = [stream bytes];
+		for (NSUInteger offset = 0; offset < [stream length]; offset += chunkSize) {
+			if (!ORSBenchmarkWriteAll(peer, bytes + offset, MIN(chunkSize, [stream length] - offset))) break;
+		}
+	});
+	BOOL finished = dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 120 * NSEC_PER_SEC)) == 0;
+	double seconds = (ORSBenchmarkNanoseconds() - start) / 1e9;
+	double cpuSeconds = ORSBenchmarkCPUSeconds() - cpuBefore;
+	uint64_t allocations = ORSBenchmarkAllocations() - allocationsBefore;
+	ORSBenchmarkCloseClients(clients);
+
+	double totalPackets = (double)packetCount * portCount;
+	double totalBytes = totalPackets * packetSize;
+	return @{@"benchmark": @"throughput",
+			 @"descriptorCount": @(descriptorCount),
+			 @"packetSize": @(packetSize),
+			 @"chunkSize": @(chunkSize),
+			 @"portCount": @(portCount),
+			 @"usesSharedReactor": @(usesSharedReactor),
+			 @"packetCount": @(packetCount),
+			 @"finished": @(finished),
+			 @"seconds": @(seconds),
+			 @"bytesPerSecond": @(totalBytes / seconds),
+			 @"packetsPerSecond": @(totalPackets / seconds),
+			 @"cpuSecondsPerMB": @(cpuSeconds / (totalBytes / 1e6)),
+			 @"allocationsPerPacket": @(allocations / totalPackets)};
+}
+
+static NSDictionary *ORSBenchmarkLatency(NSUInteger packetSize, NSUInteger portCount, BOOL usesSharedReactor, NSUInteger requestCount)
+{
+	NSArray *clients = ORSBenchmarkClients(portCount, usesSharedReactor);
+	dispatch_group_t group = dispatch_group_create();
+	NSData *response = ORSBenchmarkPacket('!', 'r', packetSize);
+	NSMutableArray *responders = [NSMutableArray array];
+	for (ORSBenchmarkClient *client in clients) {
+		client.requestCount = requestCount;
+		client.requestData = ORSBenchmarkPacket('?', 'q', packetSize);
+		client.responseDescriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:packetSize userInfo:nil];
+		client.group = group;
+		dispatch_group_enter(group);
+
+		// Answer each request as soon as its last byte arrives. A read source rather than a
+		// blocked thread per peer, so hundreds of ports don't exhaust the global queues' threads.
+		int peer = client.transport.peerFileDescriptor;
+		dispatch_queue_t responderQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0);
+		dispatch_source_t responder = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, peer, 0, responderQueue);
+		dispatch_source_set_event_handler(responder, ^{
+			uint8_t buffer[4096];
+			ssize_t length = read(peer, buffer, MIN(sizeof(buffer), MAX(dispatch_source_get_data(responder), (unsigned long)1)));
+			for (ssize_t i = 0; i < length; i++) {
+				if (buffer[i] != ';') continue;
+				if (!ORSBenchmarkWriteAll(peer, [response bytes], [response length])) {
+					dispatch_source_cancel(responder);
+					return;
+				}
+			}
+		});
+		dispatch_resume(responder);
+		[responders addObject:responder];
+	}
+
+	uint64_t allocationsBefore = ORSBenchmarkAllocations();
+	double cpuBefore = ORSBenchmarkCPUSeconds();
+	uint64_t start = ORSBenchmarkNanoseconds();
+	for (ORSBenchmarkClient *client in clients) {
+		dispatch_async(client.port.delegateQueue, ^{ [client startRequests]; });
+	}
+	BOOL finished = dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 120 * NSEC_PER_SEC)) == 0;
+	double seconds = (ORSBenchmarkNanoseconds() - start) / 1e9;
+	double cpuSeconds = ORSBenchmarkCPUSeconds() - cpuBefore;
+	uint64_t allocations = ORSBenchmarkAllocations() - allocationsBefore;
+
+	// Wait for the delegate queues to be done with the latencies before reading them
+	NSMutableData *latencies = [NSMutableData data];
+	NSUInteger completed = 0;
+	for (ORSBenchmarkClient *client in clients) {
+		dispatch_sync(client.port.delegateQueue, ^{});
+		[latencies appendBytes:client.latencies length:client.completedRequestCount * sizeof(uint64_t)];
+		completed += client.completedRequestCount;
+	}
+	for (dispatch_source_t responder in responders) dispatch_source_cancel(responder);
+	ORSBenchmarkCloseClients(clients);
+
+	uint64_t *sorted = [latencies mutableBytes];
+	qsort_b(sorted, completed, sizeof(uint64_t), ^int(const void *a, const void *b) {
+		uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+		return x < y ? -1 : x > y;
+	});
+	double (^percentile)(double) = ^double(double p) {
+		if (completed == 0) return 0;
+		NSUInteger index = MIN((NSUInteger)(p * completed), completed - 1);
+		return sorted[index] / 1e3;
+	};
+
+	double totalBytes = (double)completed * packetSize * 2;
+	return @{@"benchmark": @"latency",
+			 @"packetSize": @(packetSize),
+			 @"portCount": @(portCount),
+			 @"usesSharedReactor": @(usesSharedReactor),
+			 @"requestCount": @(requestCount),
+			 @"finished": @(finished),
+			 @"seconds": @(seconds),
+			 @"requestsPerSecond": @(completed / seconds),
+			 @"p50Microseconds": @(percentile(0.5)),
+			 @"p99Microseconds": @(percentile(0.99)),
+			 @"p999Microseconds": @(percentile(0.999)),
+			 @"cpuSecondsPerMB": @(totalBytes > 0 ? cpuSeconds / (totalBytes / 1e6) : 0),
+			 @"allocationsPerPacket": @(completed ? allocations / (completed * 2.0) : 0)};
+}
+
+#pragma mark - Main
+
+static NSArray *ORSBenchmarkSweep(NSString *key, NSArray *defaultValues)
+{
+	NSString *string = [[NSUserDefaults standardUserDefaults] stringForKey:key];
+	if (![string length]) return defaultValues;
+
+	NSMutableArray *values = [NSMutableArray array];
+	for (NSString *component in [string componentsSeparatedByString:@","]) {
+		NSInteger value = [component integerValue];
+		if (value > 0) [values addObject:@(value)];
+	}
+	return [values count] ? values : defaultValues;
+}
+
+// Accepts off/on, no/yes or 0/1
+static NSArray *ORSBenchmarkBooleanSweep(NSString *key, NSArray *defaultValues)
+{
+	NSString *string = [[NSUserDefaults standardUserDefaults] stringForKey:key];
+	if (![string length]) return defaultValues;
+
+	NSMutableArray *values = [NSMutableArray array];
+	for (NSString *component in [string componentsSeparatedByString:@","]) {
+		NSString *value = [[component stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] lowercaseString];
+		if ([@[@"on", @"yes", @"1"] containsObject:value]) [values addObject:@YES];
+		if ([@[@"off", @"no", @"0"] containsObject:value]) [values addObject:@NO];
+	}
+	return [values count] ? values : defaultValues;
+}
+
+// Each port needs a pseudo terminal pair plus descriptors of its own, so hundreds of ports
+// need more than the default soft limit of 256 open files.
+static void ORSBenchmarkRaiseOpenFileLimit(NSUInteger portCount)
+{
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+	rlim_t needed = (rlim_t)portCount * 4 + 64;
+	if (limit.rlim_cur >= needed) return;
+	limit.rlim_cur = MIN(needed, MIN(limit.rlim_max, (rlim_t)OPEN_MAX));
+	if (setrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur < needed) {
+		fprintf(stderr, "Couldn't raise the open file limit to %llu; large port counts may fail\n", (unsigned long long)needed);
+	}
+}
+
+static NSUInteger ORSBenchmarkSetting(NSString *key, NSUInteger defaultValue)
+{
+	NSInteger value = [[NSUserDefaults standardUserDefaults] integerForKey:key];
+	return value > 0 ? (NSUInteger)value : defaultValue;
+}
+
+static void ORSBenchmarkPrintResult(NSDictionary *result)
+{
+	NSMutableDictionary *line = [result mutableCopy];
+	line[@"timestamp"] = @([[NSDate date] timeIntervalSince1970]);
+	NSData *json = [NSJSONSerialization dataWithJSONObject:line options:0 error:NULL];
+	fwrite([json bytes], 1, [json length], stdout);
+	fputc('\n', stdout);
+	fflush(stdout);
+}
+
+int main(int argc, const char * argv[])
+{
+	@autoreleasepool {
+		NSArray *descriptorCounts = ORSBenchmarkSweep(@"descriptorCounts", @[@1, @8, @64]);
+		NSArray *packetSizes = ORSBenchmarkSweep(@"packetSizes", @[@16, @256]);
+		NSArray *chunkSizes = ORSBenchmarkSweep(@"chunkSizes", @[@64, @4096]);
+		NSArray *portCounts = ORSBenchmarkSweep(@"portCounts", @[@1, @8, @256]);
+		NSArray *reactorSettings = ORSBenchmarkBooleanSweep(@"reactor", @[@NO, @YES]);
+		NSUInteger packetCount = ORSBenchmarkSetting(@"packetCount", 20000);
+		NSUInteger requestCount = ORSBenchmarkSetting(@"requestCount", 2000);
+
+		ORSBenchmarkRaiseOpenFileLimit([[portCounts valueForKeyPath:@"@max.unsignedIntegerValue"] unsignedIntegerValue]);
+		ORSBenchmarkStartCountingAllocations();
+
+		for (NSNumber *descriptorCount in descriptorCounts) {
+			for (NSNumber *packetSize in packetSizes) {
+				for (NSNumber *chunkSize in chunkSizes) {
+					for (NSNumber *portCount in portCounts) {
+						for (NSNumber *reactor in reactorSettings) {
+							@autoreleasepool {
+								fprintf(stderr, "throughput: %lu descriptors, %lu byte packets, %lu byte chunks, %lu ports, shared reactor %s\n", [descriptorCount unsignedLongValue], [packetSize unsignedLongValue], [chunkSize unsignedLongValue], [portCount unsignedLongValue], [reactor boolValue] ? "on" : "off");
+								ORSBenchmarkPrintResult(ORSBenchmarkThroughput([descriptorCount unsignedIntegerValue], MAX([packetSize unsignedIntegerValue], (NSUInteger)3), [chunkSize unsignedIntegerValue], [portCount unsignedIntegerValue], [reactor boolValue], packetCount));
+							}
+						}
+					}
+				}
+			}
+		}
+
+		for (NSNumber *packetSize in packetSizes) {
+			for (NSNumber *portCount in portCounts) {
+				for (NSNumber *reactor in reactorSettings) {
+					@autoreleasepool {
+						fprintf(stderr, "latency: %lu byte packets, %lu ports, shared reactor %s\n", [packetSize unsignedLongValue], [portCount unsignedLongValue], [reactor boolValue] ? "on" : "off");
+						ORSBenchmarkPrintResult(ORSBenchmarkLatency(MAX([packetSize unsignedIntegerValue], (NSUInteger)3), [portCount unsignedIntegerValue], [reactor boolValue], requestCount));
+					}
+				}
+			}
+		}
+	}
+	return 0;
+}
@@ -13,6 +13,9 @@ let package = Package(
         .library(
             name: "ORSSerial",
             targets: ["ORSSerial"]),
+        .executable(
+            name: "ORSSerialBenchmark",
+            targets: ["ORSSerialBenchmark"]),
     ],
     dependencies: [
         // Dependencies declare other packages that this package depends on.
@@ -24,9 +27,14 @@ let package = Package(
         .target(
             name: "ORSSerial",
 			path: "Sources",
-			exclude: ["ORSSerialBuffer.h", "Resources/Info.plist"],
+			exclude: ["ORSSerialBuffer.h", "ORSSerialPacketMatcher.h", "ORSSerialLiteralPacketMatcher.h", "ORSSerialEvaluatorPacketMatcher.h", "ORSSerialRegexPacketMatcher.h", "ORSSerialLengthPrefixedPacketMatcher.h", "ORSSerialFramedPacketMatcher.h", "ORSSerialLinePacketMatcher.h", "ORSSerialIncrementalPacketMatcher.h", "ORSSerialByteSearch.h", "ORSSerialByteStuffing.h", "ORSSerialChecksum.h", "ORSSerialPacketAutomaton.h", "ORSSerialPacketDescriptorTable.h", "ORSSerialReadSlabPool.h", "ORSSerialWriteQueue.h", "ORSSerialPendingRequest.h", "ORSSerialRequestScheduler.h", "ORSSerialTimerWheel.h", "ORSSerialModemLineMonitor.h", "ORSSerialReactor.h", "ORSSerialStatistics.h", "Resources/Info.plist"],
 			cSettings: [ .define("SWIFTPM") ]
 		//	sources: ["Source/**/*.m"]
+		),
+		.target(
+			name: "ORSSerialBenchmark",
+			dependencies: ["ORSSerial"],
+			path: "Benchmarks/ORSSerialBenchmark"
 		)
     ]
 )
@@ -13,14 +13,47 @@
 #define NS_DESIGNATED_INITIALIZER
 #endif
 
+/**
+ *  Circular buffer holding the most recent maximumLength bytes of a stream.
+ *
+ *  Storage is mapped twice, back to back, in virtual memory, so the buffer's contents are
+ *  always contiguous no matter where they wrap around. Appending never moves existing bytes,
+ *  and dropping the oldest bytes is just an index update.
+ *
+ *  Bytes are addressed by stream position: the number of bytes appended before them since
+ *  the buffer was created. Positions aren't affected by dropping or clearing bytes, so any
+ *  number of readers can share one buffer and keep track of where they are independently.
+ *
+ *  Immutable data objects passed to -appendData: are also kept for as long as their bytes are
+ *  in the buffer, so -dataInRange: can return slices of them rather than copies.
+ */
 @interface ORSSerialBuffer : NSObject
 
 - (instancetype)initWithMaximumLength:(NSUInteger)maxLength NS_DESIGNATED_INITIALIZER;
 
-- (void)appendData:(NSData *)data;
+- (void)appendData:(NSData *)data; // Keeps data if it's immutable
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
 - (void)clearBuffer;
 
+// Pointer to the byte at position, which must be between startPosition and endPosition. Valid until the buffer is next modified.
+- (const uint8_t *)bytesAtPosition:(NSUInteger)position;
+
+// Returns the bytes in range, which is in stream positions. Where possible, this is an immutable
+// view of the data that was appended (a dispatch_data_t), not a copy.
+- (NSData *)dataInRange:(NSRange)range;
+
+// View of the buffer's contents, valid until the buffer is next modified. Copy it to keep it around.
 @property (nonatomic, strong, readonly) NSData *data;
-@property (nonatomic, readonly) NSUInteger maximumLength;
+@property (nonatomic, readonly) NSUInteger length;
+
+// Setting a smaller maximum length drops the oldest bytes. Storage is only grown as it's needed.
+@property (nonatomic) NSUInteger maximumLength;
+
+@property (nonatomic, readonly) NSUInteger startPosition; // Position of the oldest byte in the buffer
+@property (nonatomic, readonly) NSUInteger endPosition; // Position of the next byte to be appended
+
+// When YES, KVO notifications are posted for data each time the buffer changes. Off by default,
+// as the buffer is changed for every chunk of data received.
+@property (nonatomic) BOOL notifiesObservers;
 
 @end
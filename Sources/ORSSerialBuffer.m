@@ -7,10 +7,51 @@
 //
 
 #import "ORSSerialBuffer.h"
+#import <mach/mach.h>
+
+// Allocates size bytes (a multiple of the page size) followed immediately by a second mapping of
+// the same memory, so that storage[i] and storage[i + size] are the same byte.
+static uint8_t *ORSSerialBufferAllocateMirroredStorage(NSUInteger size)
+{
+	// Another thread may grab the address range for the mirror between deallocating and remapping it,
+	// so try a few times
+	for (int attempt=0; attempt<3; attempt++) {
+		vm_address_t address = 0;
+		if (vm_allocate(mach_task_self(), &address, size * 2, VM_FLAGS_ANYWHERE) != KERN_SUCCESS) return NULL;
+
+		vm_address_t mirrorAddress = address + size;
+		if (vm_deallocate(mach_task_self(), mirrorAddress, size) != KERN_SUCCESS) {
+			vm_deallocate(mach_task_self(), address, size * 2);
+			return NULL;
+		}
+
+		vm_prot_t currentProtection, maximumProtection;
+		kern_return_t result = vm_remap(mach_task_self(), &mirrorAddress, size, 0, VM_FLAGS_FIXED, mach_task_self(),
+										address, FALSE, &currentProtection, &maximumProtection, VM_INHERIT_DEFAULT);
+		if (result == KERN_SUCCESS && mirrorAddress == address + size) return (uint8_t *)address;
+
+		if (result == KERN_SUCCESS) vm_deallocate(mach_task_self(), mirrorAddress, size);
+		vm_deallocate(mach_task_self(), address, size);
+	}
+	return NULL;
+}
+
+static void ORSSerialBufferFreeMirroredStorage(uint8_t *storage, NSUInteger size)
+{
+	if (storage) vm_deallocate(mach_task_self(), (vm_address_t)storage, size * 2);
+}
 
 @interface ORSSerialBuffer ()
+{
+	uint8_t *_storage; // Mirrored, see ORSSerialBufferAllocateMirroredStorage()
+	NSUInteger _capacity;
+	NSUInteger _head; // Index in _storage of the oldest byte
 
-@property (nonatomic, strong) NSMutableData *internalBuffer;
+	// Data objects that were appended, so that ranges can be handed out without copying. Covers
+	// the positions from _retainedStartPosition to the end of the buffer.
+	dispatch_data_t _retainedData;
+	NSUInteger _retainedStartPosition;
+}
 
 @end
 
@@ -26,31 +67,168 @@
 {
 	self = [super init];
 	if (self) {
-		_internalBuffer = [NSMutableData data];
 		_maximumLength = maxLength;
 	}
 	return self;
 }
 
+- (void)dealloc
+{
+	ORSSerialBufferFreeMirroredStorage(_storage, _capacity);
+}
+
 - (void)appendData:(NSData *)data
 {
-	[self willChangeValueForKey:@"internalBuffer"];
-	[self.internalBuffer appendData:data];
-	if ([self.internalBuffer length] > self.maximumLength) {
-		NSRange rangeToDelete = NSMakeRange(0, [self.internalBuffer length] - self.maximumLength);
-		[self.internalBuffer replaceBytesInRange:rangeToDelete withBytes:NULL length:0];
+	NSUInteger length = [data length];
+	if (!length) return;
+	[self appendBytes:[data bytes] length:length retainingData:data];
+}
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	[self appendBytes:bytes length:length retainingData:nil];
+}
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length retainingData:(NSData *)data
+{
+	if (!length) return;
+	if (self.notifiesObservers) [self willChangeValueForKey:@"data"];
+
+	// Only the last maximumLength bytes can end up in the buffer
+	if (length > self.maximumLength) {
+		NSUInteger skipped = length - self.maximumLength;
+		bytes = (const uint8_t *)bytes + skipped;
+		length -= skipped;
+		_endPosition += skipped;
+		[self dropBytes:_length];
 	}
-	[self didChangeValueForKey:@"internalBuffer"];
+	if (_length + length > self.maximumLength) [self dropBytes:_length + length - self.maximumLength];
+	[self ensureCapacity:_length + length];
+
+	// Thanks to the mirror, this can run off the end of the first mapping and wrap around for free
+	if (length) memcpy(_storage + (_head + _length) % _capacity, bytes, length);
+	_length += length;
+	_endPosition += length;
+	_startPosition = _endPosition - _length;
+	[self retainData:data];
+
+	if (self.notifiesObservers) [self didChangeValueForKey:@"data"];
 }
 
 - (void)clearBuffer
 {
-	self.internalBuffer = [NSMutableData data];
+	if (self.notifiesObservers) [self willChangeValueForKey:@"data"];
+	[self dropBytes:_length];
+	if (self.notifiesObservers) [self didChangeValueForKey:@"data"];
+}
+
+- (const uint8_t *)bytesAtPosition:(NSUInteger)position
+{
+	if (position < _startPosition || position > _endPosition) {
+		[NSException raise:NSRangeException format:@"Position %lu is outside buffer (%lu-%lu)", (unsigned long)position, (unsigned long)_startPosition, (unsigned long)_endPosition];
+	}
+	if (!_storage) return NULL;
+	return _storage + (_head + (position - _startPosition)) % _capacity;
+}
+
+- (NSData *)dataInRange:(NSRange)range
+{
+	if (!range.length) return [NSData data];
+	if (range.location < _startPosition || NSMaxRange(range) > _endPosition) {
+		[NSException raise:NSRangeException format:@"Range %@ is outside buffer (%lu-%lu)", NSStringFromRange(range), (unsigned long)_startPosition, (unsigned long)_endPosition];
+	}
+#if OS_OBJECT_USE_OBJC
+	if (_retainedData && range.location >= _retainedStartPosition) {
+		return (NSData *)dispatch_data_create_subrange(_retainedData, range.location - _retainedStartPosition, range.length);
+	}
+#endif
+	return [NSData dataWithBytes:[self bytesAtPosition:range.location] length:range.length];
+}
+
+#pragma mark - Private
+
+- (void)dropBytes:(NSUInteger)count
+{
+	count = MIN(count, _length);
+	if (_capacity) _head = (_head + count) % _capacity;
+	_length -= count;
+	_startPosition = _endPosition - _length;
+
+	// Let go of data that's no longer in the buffer
+	if (_retainedData && _retainedStartPosition < _startPosition) {
+		NSUInteger retainedLength = dispatch_data_get_size(_retainedData);
+		NSUInteger dropped = MIN(_startPosition - _retainedStartPosition, retainedLength);
+		_retainedData = dispatch_data_create_subrange(_retainedData, dropped, retainedLength - dropped);
+		_retainedStartPosition += dropped;
+	}
+}
+
+// Called after data's bytes have been appended. Data is only kept if it can't change.
+- (void)retainData:(NSData *)data
+{
+#if OS_OBJECT_USE_OBJC
+	if (data && ![data isKindOfClass:[NSMutableData class]]) {
+		NSUInteger length = [data length];
+		NSUInteger dataStartPosition = _endPosition - length;
+		if (!_retainedData || _retainedStartPosition + dispatch_data_get_size(_retainedData) != dataStartPosition) {
+			_retainedData = dispatch_data_empty;
+			_retainedStartPosition = dataStartPosition;
+		}
+		dispatch_data_t region = dispatch_data_create([data bytes], length, NULL, ^{
+			(void)data; // Keeps data, and the memory it wraps, alive
+		});
+		_retainedData = dispatch_data_create_concat(_retainedData, region);
+		[self dropBytes:0]; // Trims anything that didn't fit
+		return;
+	}
+#endif
+	_retainedData = nil;
+	_retainedStartPosition = _endPosition;
+}
+
+- (void)ensureCapacity:(NSUInteger)capacity
+{
+	if (capacity <= _capacity) return;
+
+	// Grow geometrically, but no further than the maximum length needs
+	NSUInteger pageSize = (NSUInteger)vm_page_size;
+	NSUInteger newCapacity = MIN(MAX(capacity, _capacity * 2), MAX(self.maximumLength, capacity));
+	newCapacity = (newCapacity + pageSize - 1) / pageSize * pageSize;
+
+	uint8_t *newStorage = ORSSerialBufferAllocateMirroredStorage(newCapacity);
+	if (!newStorage) {
+		[NSException raise:NSMallocException format:@"Unable to allocate %lu byte buffer", (unsigned long)newCapacity];
+	}
+	if (_length) memcpy(newStorage, _storage + _head, _length);
+	ORSSerialBufferFreeMirroredStorage(_storage, _capacity);
+	_storage = newStorage;
+	_capacity = newCapacity;
+	_head = 0;
 }
 
 #pragma mark - Properties
 
-+ (NSSet *)keyPathsForValuesAffectingData { return [NSSet setWithObjects:@"internalData", nil]; }
-- (NSData *)data { return self.internalBuffer; }
++ (BOOL)automaticallyNotifiesObserversForKey:(NSString *)key
+{
+	if ([key isEqualToString:@"data"]) return NO;
+	return [super automaticallyNotifiesObserversForKey:key];
+}
+
+- (NSData *)data
+{
+	if (!_length) return [NSData data];
+	return [NSData dataWithBytesNoCopy:(void *)(_storage + _head) length:_length freeWhenDone:NO];
+}
+
+- (void)setMaximumLength:(NSUInteger)maximumLength
+{
+	if (maximumLength == _maximumLength) return;
+	_maximumLength = maximumLength;
+	if (_length > maximumLength) {
+		if (self.notifiesObservers) [self willChangeValueForKey:@"data"];
+		[self dropBytes:_length - maximumLength];
+		if (self.notifiesObservers) [self didChangeValueForKey:@"data"];
+	}
+}
 
 @end
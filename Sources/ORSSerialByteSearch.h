@@ -0,0 +1,45 @@
+//
+//  ORSSerialByteSearch.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ *  Returns the offset of the first occurrence of byte in the length bytes at bytes, or NSNotFound.
+ *
+ *  Like memchr(), but inlined so that scanning short chunks doesn't pay for a call. Sixteen bytes
+ *  are compared at a time using SSE2 or NEON where available.
+ */
+static inline NSUInteger ORSSerialFindByte(const uint8_t *bytes, NSUInteger length, uint8_t byte)
+{
+	NSUInteger i = 0;
+#if defined(__SSE2__)
+	__m128i needle = _mm_set1_epi8((char)byte);
+	for (; i + 16 <= length; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+		unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+		if (mask) return i + (NSUInteger)__builtin_ctz(mask);
+	}
+#elif defined(__ARM_NEON)
+	uint8x16_t needle = vdupq_n_u8(byte);
+	for (; i + 16 <= length; i += 16) {
+		uint8x16_t matches = vceqq_u8(vld1q_u8(bytes + i), needle);
+		// Narrowing shift packs the comparison into 4 bits per byte, in order
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+		if (mask) return i + (NSUInteger)(__builtin_ctzll(mask) / 4);
+	}
+#endif
+	for (; i < length; i++) {
+		if (bytes[i] == byte) return i;
+	}
+	return NSNotFound;
+}
@@ -0,0 +1,26 @@
+//
+//  ORSSerialByteStuffing.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+
+// Byte that ends each frame: 0x00 for COBS, END (0xC0) for SLIP
+uint8_t ORSSerialFrameDelimiter(ORSSerialPacketFraming framing);
+
+// Largest frame, including its delimiters, that a payload of length bytes can be encoded into
+NSUInteger ORSSerialMaximumFrameLength(ORSSerialPacketFraming framing, NSUInteger length);
+
+// Returns payload byte stuffed and delimited. SLIP frames start with END as well as ending with it.
+NSData *ORSSerialEncodeFrame(ORSSerialPacketFraming framing, NSData *payload);
+
+/**
+ *  Decodes the length bytes of a frame, not including its delimiter, into output in one pass.
+ *  output must have room for length bytes; the payload is never longer than its encoding.
+ *
+ *  Returns the length of the payload, or NSNotFound if the frame isn't validly encoded.
+ */
+NSUInteger ORSSerialDecodeFrame(ORSSerialPacketFraming framing, const uint8_t *bytes, NSUInteger length, uint8_t *output);
@@ -0,0 +1,117 @@
+//
+//  ORSSerialByteStuffing.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialByteStuffing.h"
+
+enum {
+	ORSSerialSLIPEnd = 0xC0,
+	ORSSerialSLIPEscape = 0xDB,
+	ORSSerialSLIPEscapedEnd = 0xDC,
+	ORSSerialSLIPEscapedEscape = 0xDD,
+};
+
+uint8_t ORSSerialFrameDelimiter(ORSSerialPacketFraming framing)
+{
+	return framing == ORSSerialPacketFramingSLIP ? ORSSerialSLIPEnd : 0x00;
+}
+
+NSUInteger ORSSerialMaximumFrameLength(ORSSerialPacketFraming framing, NSUInteger length)
+{
+	switch (framing) {
+		case ORSSerialPacketFramingCOBS: return length + length / 254 + 2; // Overhead bytes and delimiter
+		case ORSSerialPacketFramingSLIP: return length * 2 + 2; // Every byte escaped, and an END each side
+		default: return length;
+	}
+}
+
+NSData *ORSSerialEncodeFrame(ORSSerialPacketFraming framing, NSData *payload)
+{
+	NSUInteger length = [payload length];
+	const uint8_t *bytes = [payload bytes];
+	NSMutableData *frame = [NSMutableData dataWithLength:ORSSerialMaximumFrameLength(framing, length)];
+	uint8_t *output = [frame mutableBytes];
+	NSUInteger outputLength = 0;
+
+	if (framing == ORSSerialPacketFramingCOBS) {
+		// Each block starts with a code byte giving the offset of the next zero, filled in once it's known
+		NSUInteger codeIndex = outputLength++;
+		uint8_t code = 1;
+		for (NSUInteger i=0; i<length; i++) {
+			if (bytes[i]) {
+				output[outputLength++] = bytes[i];
+				code++;
+			}
+			if (!bytes[i] || code == 0xFF) {
+				output[codeIndex] = code;
+				codeIndex = outputLength++;
+				code = 1;
+			}
+		}
+		output[codeIndex] = code;
+		output[outputLength++] = 0x00;
+	} else if (framing == ORSSerialPacketFramingSLIP) {
+		// Leading END flushes any line noise received since the last frame
+		output[outputLength++] = ORSSerialSLIPEnd;
+		for (NSUInteger i=0; i<length; i++) {
+			switch (bytes[i]) {
+				case ORSSerialSLIPEnd:
+					output[outputLength++] = ORSSerialSLIPEscape;
+					output[outputLength++] = ORSSerialSLIPEscapedEnd;
+					break;
+				case ORSSerialSLIPEscape:
+					output[outputLength++] = ORSSerialSLIPEscape;
+					output[outputLength++] = ORSSerialSLIPEscapedEscape;
+					break;
+				default:
+					output[outputLength++] = bytes[i];
+					break;
+			}
+		}
+		output[outputLength++] = ORSSerialSLIPEnd;
+	} else {
+		return payload;
+	}
+
+	[frame setLength:outputLength];
+	return frame;
+}
+
+NSUInteger ORSSerialDecodeFrame(ORSSerialPacketFraming framing, const uint8_t *bytes, NSUInteger length, uint8_t *output)
+{
+	NSUInteger outputLength = 0;
+
+	if (framing == ORSSerialPacketFramingCOBS) {
+		NSUInteger i = 0;
+		while (i < length) {
+			NSUInteger code = bytes[i++];
+			if (!code || code - 1 > length - i) return NSNotFound;
+			for (NSUInteger end = i + code - 1; i < end; i++) {
+				if (!bytes[i]) return NSNotFound;
+				output[outputLength++] = bytes[i];
+			}
+			// A full block isn't followed by a zero, and neither is the last one
+			if (code != 0xFF && i < length) output[outputLength++] = 0x00;
+		}
+	} else if (framing == ORSSerialPacketFramingSLIP) {
+		for (NSUInteger i=0; i<length; i++) {
+			uint8_t byte = bytes[i];
+			if (byte == ORSSerialSLIPEnd) return NSNotFound;
+			if (byte == ORSSerialSLIPEscape) {
+				if (++i == length) return NSNotFound;
+				if (bytes[i] == ORSSerialSLIPEscapedEnd) byte = ORSSerialSLIPEnd;
+				else if (bytes[i] == ORSSerialSLIPEscapedEscape) byte = ORSSerialSLIPEscape;
+				else return NSNotFound;
+			}
+			output[outputLength++] = byte;
+		}
+	} else {
+		memcpy(output, bytes, length);
+		outputLength = length;
+	}
+
+	return outputLength;
+}
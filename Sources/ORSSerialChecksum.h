@@ -0,0 +1,30 @@
+//
+//  ORSSerialChecksum.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+
+/**
+ *  CRCs are computed with slicing-by-8 tables, eight bytes per step, or with the ARMv8 CRC32
+ *  instructions for CRC-32 where they're available. A checksum can be computed incrementally by
+ *  passing the state returned by one call to ORSSerialChecksumUpdate() to the next.
+ */
+
+// Size in bytes of the checksum, or 0 for ORSSerialPacketChecksumNone
+NSUInteger ORSSerialChecksumLength(ORSSerialPacketChecksumAlgorithm algorithm);
+
+uint32_t ORSSerialChecksumInitialState(ORSSerialPacketChecksumAlgorithm algorithm);
+uint32_t ORSSerialChecksumUpdate(ORSSerialPacketChecksumAlgorithm algorithm, uint32_t state, const uint8_t *bytes, NSUInteger length);
+
+// Returns YES if the checksum of the bytes that produced state is the one at checksum, in the algorithm's byte order
+BOOL ORSSerialChecksumStateMatches(ORSSerialPacketChecksumAlgorithm algorithm, uint32_t state, const uint8_t *checksum);
+
+/**
+ *  Returns YES if a packet of length bytes carries a valid checksum, located immediately before its
+ *  last trailerLength bytes and covering every byte from offset up to the checksum.
+ */
+BOOL ORSSerialPacketHasValidChecksum(ORSSerialPacketChecksumAlgorithm algorithm, const uint8_t *bytes, NSUInteger length, NSUInteger offset, NSUInteger trailerLength);
@@ -0,0 +1,131 @@
+//
+//  ORSSerialChecksum.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialChecksum.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+enum {
+	ORSSerialCRCAlgorithmCount = 3,
+	ORSSerialCRCSliceCount = 8,
+};
+
+// tables[algorithm-1][k][i] is the CRC register contribution of byte i followed by k zero bytes
+static uint32_t ORSSerialCRCTables[ORSSerialCRCAlgorithmCount][ORSSerialCRCSliceCount][256];
+
+static void ORSSerialBuildCRCTables(void)
+{
+	for (NSUInteger algorithm=ORSSerialPacketChecksumCRC16Modbus; algorithm<=ORSSerialPacketChecksumCRC32; algorithm++) {
+		uint32_t (*table)[256] = ORSSerialCRCTables[algorithm - 1];
+		BOOL reflected = (algorithm != ORSSerialPacketChecksumCRC16CCITT);
+		uint32_t polynomial = (algorithm == ORSSerialPacketChecksumCRC32) ? 0xEDB88320 : (reflected ? 0xA001 : 0x1021);
+
+		for (uint32_t i=0; i<256; i++) {
+			uint32_t crc = reflected ? i : i << 8;
+			for (NSUInteger bit=0; bit<8; bit++) {
+				if (reflected) crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+				else crc = ((crc & 0x8000) ? (crc << 1) ^ polynomial : crc << 1) & 0xFFFF;
+			}
+			table[0][i] = crc;
+		}
+		for (NSUInteger k=1; k<ORSSerialCRCSliceCount; k++) {
+			for (NSUInteger i=0; i<256; i++) {
+				uint32_t previous = table[k-1][i];
+				table[k][i] = reflected ? (previous >> 8) ^ table[0][previous & 0xFF] : ((previous << 8) & 0xFFFF) ^ table[0][previous >> 8];
+			}
+		}
+	}
+}
+
+NSUInteger ORSSerialChecksumLength(ORSSerialPacketChecksumAlgorithm algorithm)
+{
+	switch (algorithm) {
+		case ORSSerialPacketChecksumCRC16Modbus:
+		case ORSSerialPacketChecksumCRC16CCITT:
+			return 2;
+		case ORSSerialPacketChecksumCRC32:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+uint32_t ORSSerialChecksumInitialState(ORSSerialPacketChecksumAlgorithm algorithm)
+{
+	return (algorithm == ORSSerialPacketChecksumCRC32) ? 0xFFFFFFFF : 0xFFFF;
+}
+
+uint32_t ORSSerialChecksumUpdate(ORSSerialPacketChecksumAlgorithm algorithm, uint32_t state, const uint8_t *bytes, NSUInteger length)
+{
+	if (!ORSSerialChecksumLength(algorithm)) return state;
+
+#if defined(__ARM_FEATURE_CRC32)
+	// The CRC32 instructions use the CRC-32 polynomial, reflected, without inverting the register
+	if (algorithm == ORSSerialPacketChecksumCRC32) {
+		for (; length >= 8; bytes += 8, length -= 8) {
+			uint64_t value;
+			memcpy(&value, bytes, sizeof(value));
+			state = __crc32d(state, value);
+		}
+		while (length--) state = __crc32b(state, *bytes++);
+		return state;
+	}
+#endif
+
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{ ORSSerialBuildCRCTables(); });
+	uint32_t (*table)[256] = ORSSerialCRCTables[algorithm - 1];
+
+	if (algorithm == ORSSerialPacketChecksumCRC16CCITT) {
+		// Most significant bit first, so the register lines up with the first two bytes
+		for (; length >= 8; bytes += 8, length -= 8) {
+			state = table[7][bytes[0] ^ (state >> 8)] ^ table[6][bytes[1] ^ (state & 0xFF)] ^
+				table[5][bytes[2]] ^ table[4][bytes[3]] ^ table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+		}
+		while (length--) state = ((state << 8) & 0xFFFF) ^ table[0][(state >> 8) ^ *bytes++];
+		return state;
+	}
+
+	// Reflected, so the register lines up with the first four bytes, least significant first
+	for (; length >= 8; bytes += 8, length -= 8) {
+		uint32_t low = state ^ (bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24);
+		state = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+			table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+	}
+	while (length--) state = (state >> 8) ^ table[0][(state ^ *bytes++) & 0xFF];
+	return state;
+}
+
+BOOL ORSSerialChecksumStateMatches(ORSSerialPacketChecksumAlgorithm algorithm, uint32_t state, const uint8_t *checksum)
+{
+	switch (algorithm) {
+		case ORSSerialPacketChecksumCRC16Modbus:
+			return checksum[0] == (state & 0xFF) && checksum[1] == (state >> 8);
+		case ORSSerialPacketChecksumCRC16CCITT:
+			return checksum[0] == (state >> 8) && checksum[1] == (state & 0xFF);
+		case ORSSerialPacketChecksumCRC32: {
+			uint32_t crc = ~state;
+			return checksum[0] == (crc & 0xFF) && checksum[1] == ((crc >> 8) & 0xFF) &&
+				checksum[2] == ((crc >> 16) & 0xFF) && checksum[3] == (crc >> 24);
+		}
+		default:
+			return YES;
+	}
+}
+
+BOOL ORSSerialPacketHasValidChecksum(ORSSerialPacketChecksumAlgorithm algorithm, const uint8_t *bytes, NSUInteger length, NSUInteger offset, NSUInteger trailerLength)
+{
+	NSUInteger checksumLength = ORSSerialChecksumLength(algorithm);
+	if (!checksumLength) return YES;
+	if (length < offset + checksumLength + trailerLength) return NO;
+
+	NSUInteger checksumStart = length - trailerLength - checksumLength;
+	uint32_t state = ORSSerialChecksumUpdate(algorithm, ORSSerialChecksumInitialState(algorithm), bytes + offset, checksumStart - offset);
+	return ORSSerialChecksumStateMatches(algorithm, state, bytes + checksumStart);
+}
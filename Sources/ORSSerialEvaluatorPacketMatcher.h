@@ -0,0 +1,25 @@
+//
+//  ORSSerialEvaluatorPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher that works with any descriptor. After each byte, it asks the descriptor
+ *  to evaluate every window ending at the end of its buffer.
+ */
+@interface ORSSerialEvaluatorPacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
@@ -0,0 +1,83 @@
+//
+//  ORSSerialEvaluatorPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialEvaluatorPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialStatistics.h"
+
+@interface ORSSerialEvaluatorPacketMatcher ()
+{
+	NSUInteger _clearPosition; // Position of the first byte after the last packet, NSNotFound until scanning starts
+}
+
+@end
+
+@implementation ORSSerialEvaluatorPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		_clearPosition = NSNotFound;
+	}
+	return self;
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_clearPosition == NSNotFound) _clearPosition = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	NSUInteger maximumPacketLength = self.descriptor.maximumPacketLength;
+	while (_position < _endPosition) {
+		NSUInteger end = ++_position;
+		NSUInteger start = MAX(_clearPosition, end > maximumPacketLength ? end - maximumPacketLength : 0);
+
+		// The descriptor only looks at this synchronously, so there's no need to copy it out of the window
+		NSData *buffer = [NSData dataWithBytesNoCopy:(void *)(_windowBytes + (start - _windowStartPosition))
+											  length:end - start
+										freeWhenDone:NO];
+		NSData *packet = [self.descriptor packetMatchingAtEndOfBuffer:buffer];
+		[self.statistics recordEvaluatorInvocations:[packet length] ?: end - start]; // Windows are tried shortest first
+		if (![packet length]) continue;
+
+		// The packet is normally the end of the buffer, so it can be a view of the received data
+		// instead of the descriptor's copy
+		NSUInteger packetLength = [packet length];
+		if (packetLength <= end - start && !memcmp([packet bytes], (const uint8_t *)[buffer bytes] + (end - start - packetLength), packetLength)) {
+			packet = [_window dataInRange:NSMakeRange(end - packetLength, packetLength)];
+		} else {
+			packet = [packet copy]; // Mustn't point into the window, which will be reused
+		}
+
+		// Complete packet received, so start looking for the next one after it
+		_clearPosition = end;
+		_packet = packet;
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = end - 1;
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_clearPosition = _window ? _position : NSNotFound;
+}
+
+@end
@@ -0,0 +1,31 @@
+//
+//  ORSSerialFramedPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher for descriptors created with -initWithFraming:maximumPacketLength:userInfo:.
+ *
+ *  Delimiters can only appear at the end of a byte stuffed frame, so rather than looking at each
+ *  byte, the matcher searches each received chunk for the next delimiter, 16 bytes at a time.
+ *  The bytes since the previous delimiter are then decoded in a single pass, and the decoded
+ *  payload is the packet delivered. Empty frames, frames longer than the descriptor's
+ *  maximumPacketLength, frames that aren't validly encoded, and payloads without a valid checksum
+ *  (if the descriptor declares one) are dropped.
+ */
+@interface ORSSerialFramedPacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
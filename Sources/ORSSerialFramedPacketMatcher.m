@@ -0,0 +1,101 @@
+//
+//  ORSSerialFramedPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialFramedPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialByteSearch.h"
+#import "ORSSerialByteStuffing.h"
+#import "ORSSerialChecksum.h"
+
+@interface ORSSerialFramedPacketMatcher ()
+{
+	ORSSerialPacketFraming _framing;
+	uint8_t _delimiter;
+	NSUInteger _maximumPacketLength;
+	ORSSerialPacketChecksumAlgorithm _checksumAlgorithm;
+	NSUInteger _checksumOffset;
+	NSUInteger _checksumTrailerLength;
+
+	NSUInteger _frameStart; // Position of the first byte after the last delimiter, NSNotFound until scanning starts
+}
+
+@end
+
+@implementation ORSSerialFramedPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		_framing = descriptor.framing;
+		_delimiter = ORSSerialFrameDelimiter(_framing);
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+		_frameStart = NSNotFound;
+	}
+	return self;
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_frameStart == NSNotFound) _frameStart = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+
+	while (_position < _endPosition) {
+		NSUInteger offset = ORSSerialFindByte(_windowBytes + (_position - _windowStartPosition), _endPosition - _position, _delimiter);
+		if (offset == NSNotFound) {
+			_position = _endPosition;
+			break;
+		}
+
+		NSUInteger delimiterPosition = _position + offset;
+		NSUInteger start = _frameStart;
+		_position = delimiterPosition + 1;
+		_frameStart = _position;
+
+		// The window only holds maximumPacketLength bytes before the chunk, so check length first
+		NSUInteger length = delimiterPosition - start;
+		if (!length || length + 1 > _maximumPacketLength) continue;
+
+		uint8_t *payload = malloc(length);
+		NSUInteger payloadLength = ORSSerialDecodeFrame(_framing, _windowBytes + (start - _windowStartPosition), length, payload);
+		if (payloadLength == NSNotFound ||
+			!ORSSerialPacketHasValidChecksum(_checksumAlgorithm, payload, payloadLength, _checksumOffset, _checksumTrailerLength)) {
+			free(payload);
+			continue;
+		}
+
+		_packet = [NSData dataWithBytesNoCopy:payload length:payloadLength freeWhenDone:YES];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = delimiterPosition;
+		[self reset];
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_frameStart = _window ? _position : NSNotFound;
+}
+
+@end
@@ -0,0 +1,73 @@
+//
+//  ORSSerialIncrementalPacketEvaluator.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#import "ORSSerial/ORSSerialIncrementalPacketEvaluator.h"
+
+@interface ORSSerialBlockPacketEvaluator ()
+
+@property (nonatomic, copy, readonly) BOOL(^evaluator)(NSData *);
+
+@end
+
+@implementation ORSSerialBlockPacketEvaluator
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithEvaluator:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithEvaluator:(BOOL(^)(NSData *))evaluator
+{
+	self = [super init];
+	if (self) {
+		_evaluator = [evaluator copy];
+	}
+	return self;
+}
+
+- (ORSSerialPacketEvaluation)evaluateBytes:(const uint8_t *)bytes
+									length:(NSUInteger)length
+							newBytesOffset:(NSUInteger)newBytesOffset
+									 range:(NSRange *)range
+{
+	// Windows ending before newBytesOffset were tried by earlier calls. Windows are copied, since
+	// blocks may keep them, and bytes are only valid during this call.
+	for (NSUInteger end=newBytesOffset+1; end<=length; end++) {
+		for (NSUInteger start=end; start>0; start--) {
+			NSData *window = [NSData dataWithBytes:bytes + start - 1 length:end - start + 1];
+			_evaluatorInvocationCount++;
+			if (!self.evaluator(window)) continue;
+
+			*range = NSMakeRange(start - 1, end - start + 1);
+			return ORSSerialPacketEvaluationFoundPacket;
+		}
+	}
+	return ORSSerialPacketEvaluationNeedsMoreData;
+}
+
+- (void)reset { }
+
+@end
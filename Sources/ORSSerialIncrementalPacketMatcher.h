@@ -0,0 +1,46 @@
+//
+//  ORSSerialIncrementalPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+#import "ORSSerial/ORSSerialIncrementalPacketEvaluator.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+// Where an incremental evaluator is up to in a stream of received data
+typedef struct {
+	NSUInteger start; // Position of the first pending byte
+	NSUInteger seen; // Position after the last byte passed to the evaluator
+	BOOL rescan; // Bytes were discarded, so pending bytes must be passed again
+} ORSSerialIncrementalScan;
+
+/**
+ *  Passes the bytes up to endPosition to evaluator, following the ORSSerialIncrementalPacketEvaluator
+ *  protocol, until it finds a packet. bytes holds the stream from bytesPosition, which must be no later
+ *  than scan->start, and must include maximumPacketLength bytes before endPosition.
+ *
+ *  Returns YES with the packet's positions in packetRange, having moved scan past the packet, or NO
+ *  once every byte has been passed to the evaluator without finding one.
+ */
+BOOL ORSSerialIncrementalScanNextPacket(id<ORSSerialIncrementalPacketEvaluator> evaluator, ORSSerialIncrementalScan *scan, const uint8_t *bytes, NSUInteger bytesPosition, NSUInteger endPosition, NSUInteger maximumPacketLength, NSRange *packetRange);
+
+/**
+ *  Matcher for descriptors created with -initWithMaximumPacketLength:userInfo:incrementalEvaluatorFactory:.
+ *
+ *  The matcher owns an evaluator created by the descriptor's factory, and passes it the pending part
+ *  of the receive window each time a chunk arrives, so it only sees each byte once unless it asks for
+ *  bytes to be discarded. Packets are views of the receive window.
+ */
+@interface ORSSerialIncrementalPacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
@@ -0,0 +1,130 @@
+//
+//  ORSSerialIncrementalPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialIncrementalPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialChecksum.h"
+
+BOOL ORSSerialIncrementalScanNextPacket(id<ORSSerialIncrementalPacketEvaluator> evaluator, ORSSerialIncrementalScan *scan, const uint8_t *bytes, NSUInteger bytesPosition, NSUInteger endPosition, NSUInteger maximumPacketLength, NSRange *packetRange)
+{
+	while (YES) {
+		NSUInteger end = MIN(endPosition, scan->start + maximumPacketLength);
+		if (end <= scan->seen && !scan->rescan) return NO;
+
+		NSUInteger length = end - scan->start;
+		NSRange range = NSMakeRange(0, 0);
+		ORSSerialPacketEvaluation evaluation = [evaluator evaluateBytes:bytes + (scan->start - bytesPosition)
+																 length:length
+														 newBytesOffset:scan->seen - scan->start
+																  range:&range];
+		scan->seen = end;
+		scan->rescan = NO;
+
+		if (evaluation == ORSSerialPacketEvaluationFoundPacket && range.length) {
+			if (NSMaxRange(range) > length) {
+				[NSException raise:NSRangeException format:@"%@ found a packet %@ outside the %lu bytes it was passed", evaluator, NSStringFromRange(range), (unsigned long)length];
+			}
+			*packetRange = NSMakeRange(scan->start + range.location, range.length);
+
+			// Bytes after the packet are new to the evaluator once it's reset
+			scan->start = NSMaxRange(*packetRange);
+			scan->seen = scan->start;
+			[evaluator reset];
+			return YES;
+		}
+
+		if (evaluation == ORSSerialPacketEvaluationDiscard && range.length) {
+			scan->start += MIN(range.length, length);
+			scan->rescan = (scan->start < scan->seen);
+			continue;
+		}
+
+		// No packet can be longer than this, so the oldest byte can't be part of one
+		if (length == maximumPacketLength) scan->start++;
+	}
+}
+
+@interface ORSSerialIncrementalPacketMatcher ()
+{
+	id<ORSSerialIncrementalPacketEvaluator> _evaluator;
+	NSUInteger _maximumPacketLength;
+	ORSSerialIncrementalScan _scan; // start is NSNotFound until scanning starts
+
+	ORSSerialPacketChecksumAlgorithm _checksumAlgorithm;
+	NSUInteger _checksumOffset;
+	NSUInteger _checksumTrailerLength;
+}
+
+@end
+
+@implementation ORSSerialIncrementalPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		_evaluator = descriptor.incrementalEvaluatorFactory();
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+		_scan.start = NSNotFound;
+	}
+	return self;
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_scan.start == NSNotFound) _scan = (ORSSerialIncrementalScan){position, position, NO};
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	if (!_maximumPacketLength) _position = _endPosition;
+
+	NSRange range;
+	while (_position < _endPosition &&
+		   ORSSerialIncrementalScanNextPacket(_evaluator, &_scan, _windowBytes, _windowStartPosition, _endPosition, _maximumPacketLength, &range)) {
+		if (_checksumAlgorithm != ORSSerialPacketChecksumNone &&
+			!ORSSerialPacketHasValidChecksum(_checksumAlgorithm, _windowBytes + (range.location - _windowStartPosition), range.length, _checksumOffset, _checksumTrailerLength)) {
+			// A real packet may start inside the rejected one, so only its first byte is dropped,
+			// and the rest are passed to the (now reset) evaluator again as new bytes
+			_scan = (ORSSerialIncrementalScan){range.location + 1, range.location + 1, YES};
+			_position = _scan.start;
+			continue;
+		}
+
+		// Bytes after the packet haven't been looked at yet, so scanning resumes there next time
+		_position = NSMaxRange(range);
+
+		_packet = [_window dataInRange:range];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = NSMaxRange(range) - 1;
+		return YES;
+	}
+	_position = _endPosition;
+	return NO;
+}
+
+- (void)reset
+{
+	[_evaluator reset];
+	_scan = (ORSSerialIncrementalScan){_position, _position, NO};
+	if (!_window) _scan.start = NSNotFound;
+}
+
+@end
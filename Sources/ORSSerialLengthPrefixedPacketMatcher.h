@@ -0,0 +1,37 @@
+//
+//  ORSSerialLengthPrefixedPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher for descriptors created with
+ *  -initWithSyncBytes:lengthFieldOffset:lengthFieldWidth:lengthFieldByteOrder:lengthAdjustment:maximumPacketLength:userInfo:.
+ *
+ *  Each occurrence of the sync bytes starts a candidate frame. Once a candidate's header has been
+ *  received, its length field gives the position its frame will end at, and the candidate waits in
+ *  a heap ordered by end position. A packet is found when the byte at the front of the heap's end
+ *  position arrives, so framing costs constant time per byte while only one frame is in progress.
+ *
+ *  Candidates started by false syncs, or whose length fields were corrupted, don't hold up later
+ *  ones. Packets found are exactly those the descriptor's evaluator would find: the shortest window
+ *  ending at the current byte that starts with the sync bytes and whose length field gives its length.
+ *
+ *  If the descriptor declares a checksum, each candidate's checksum is updated at the end of every
+ *  chunk received while it's in progress, so finishing it when the frame ends costs little.
+ */
+@interface ORSSerialLengthPrefixedPacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
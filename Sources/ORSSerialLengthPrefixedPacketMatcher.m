@@ -0,0 +1,228 @@
+//
+//  ORSSerialLengthPrefixedPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialLengthPrefixedPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialChecksum.h"
+
+typedef struct {
+	NSUInteger end; // Position of the frame's last byte
+	NSUInteger start;
+	NSUInteger checksumEnd; // Position of the frame's checksum
+	NSUInteger checksummedPosition; // Bytes before this are included in checksumState
+	uint32_t checksumState;
+} ORSSerialFrame;
+
+@interface ORSSerialLengthPrefixedPacketMatcher ()
+{
+	NSData *_syncBytes;
+	NSUInteger _syncLength;
+	uint8_t _lastSyncByte;
+	NSUInteger _lengthFieldOffset;
+	NSUInteger _lengthFieldWidth;
+	BOOL _bigEndian;
+	NSInteger _lengthAdjustment;
+	NSUInteger _headerLength;
+	NSUInteger _maximumPacketLength;
+	NSUInteger _minimumPacketLength;
+	BOOL _neverMatches;
+
+	ORSSerialPacketChecksumAlgorithm _checksumAlgorithm;
+	NSUInteger _checksumOffset;
+	NSUInteger _checksumLength;
+	NSUInteger _checksumTrailerLength;
+
+	NSUInteger _clearPosition; // Position of the first byte after the last packet, NSNotFound until scanning starts
+
+	// Ring of positions at which frames whose headers are incomplete start, oldest first. Headers
+	// complete in the order they started, and no more than _headerLength can be incomplete at once.
+	NSUInteger *_headerStarts;
+	NSUInteger _headerStartsHead;
+	NSUInteger _headerStartsCount;
+
+	// Min-heap of frames whose headers are complete, ordered by end position
+	ORSSerialFrame *_frames;
+	NSUInteger _frameCount;
+	NSUInteger _framesCapacity;
+}
+
+@end
+
+@implementation ORSSerialLengthPrefixedPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		_syncBytes = descriptor.syncBytes;
+		_syncLength = [_syncBytes length];
+		_lastSyncByte = _syncLength ? ((const uint8_t *)[_syncBytes bytes])[_syncLength - 1] : 0;
+		_lengthFieldOffset = descriptor.lengthFieldOffset;
+		_lengthFieldWidth = descriptor.lengthFieldWidth;
+		_bigEndian = (descriptor.lengthFieldByteOrder == ORSSerialPacketLengthFieldBigEndian);
+		_lengthAdjustment = descriptor.lengthAdjustment;
+		_headerLength = MAX(_syncLength, _lengthFieldOffset + _lengthFieldWidth);
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumLength = ORSSerialChecksumLength(_checksumAlgorithm);
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+		_minimumPacketLength = _headerLength;
+		if (_checksumLength) _minimumPacketLength = MAX(_minimumPacketLength, _checksumOffset + _checksumLength + _checksumTrailerLength);
+		_neverMatches = (!_syncLength || _minimumPacketLength > _maximumPacketLength);
+
+		_headerStarts = calloc(MAX(_headerLength, (NSUInteger)1), sizeof(NSUInteger));
+		_clearPosition = NSNotFound;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_headerStarts);
+	free(_frames);
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_clearPosition == NSNotFound) _clearPosition = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	if (_neverMatches) _position = _endPosition;
+
+	while (_position < _endPosition) {
+		NSUInteger position = _position++;
+		NSUInteger received = position + 1;
+		uint8_t byte = _windowBytes[position - _windowStartPosition];
+
+		// Sync bytes are short, so they're only compared when their last byte arrives
+		if (byte == _lastSyncByte && received >= _clearPosition + _syncLength &&
+			!memcmp(_windowBytes + (received - _syncLength - _windowStartPosition), [_syncBytes bytes], _syncLength)) {
+			_headerStarts[(_headerStartsHead + _headerStartsCount) % _headerLength] = received - _syncLength;
+			_headerStartsCount++;
+		}
+
+		if (_headerStartsCount && _headerStarts[_headerStartsHead] + _headerLength == received) {
+			NSUInteger start = _headerStarts[_headerStartsHead];
+			_headerStartsHead = (_headerStartsHead + 1) % _headerLength;
+			_headerStartsCount--;
+			NSUInteger length = [self lengthOfFrameStartingAtPosition:start];
+			if (length) {
+				NSUInteger end = start + length - 1;
+				NSUInteger checksumStart = start + _checksumOffset;
+				ORSSerialFrame frame = {end, start, end + 1 - _checksumTrailerLength - _checksumLength, checksumStart, ORSSerialChecksumInitialState(_checksumAlgorithm)};
+				[self addFrame:frame];
+			}
+		}
+
+		// Shortest valid packet wins if more than one frame ends here
+		NSUInteger start = NSNotFound;
+		while (_frameCount && _frames[0].end == position) {
+			ORSSerialFrame frame = _frames[0];
+			[self removeFirstFrame];
+			if (start != NSNotFound && frame.start < start) continue;
+			if ([self frameHasValidChecksum:&frame]) start = frame.start;
+		}
+		if (start == NSNotFound) continue;
+
+		_packet = [_window dataInRange:NSMakeRange(start, received - start)];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = position;
+		[self reset];
+		return YES;
+	}
+
+	// Checksum the chunk as it arrives, so only the last part of each frame remains when it ends
+	if (_checksumLength) {
+		for (NSUInteger i=0; i<_frameCount; i++) [self updateChecksumOfFrame:&_frames[i] toPosition:_endPosition];
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_headerStartsHead = 0;
+	_headerStartsCount = 0;
+	_frameCount = 0;
+	_clearPosition = _window ? _position : NSNotFound;
+}
+
+#pragma mark - Private
+
+// Returns the length given by the header of the frame starting at start, or 0 if it's not a valid length
+- (NSUInteger)lengthOfFrameStartingAtPosition:(NSUInteger)start
+{
+	const uint8_t *lengthField = _windowBytes + (start + _lengthFieldOffset - _windowStartPosition);
+	NSInteger value = 0;
+	for (NSUInteger i=0; i<_lengthFieldWidth; i++) {
+		value = (value << 8) | lengthField[_bigEndian ? i : _lengthFieldWidth - 1 - i];
+	}
+	NSInteger length = value + _lengthAdjustment;
+	if (length < (NSInteger)_minimumPacketLength || length > (NSInteger)_maximumPacketLength) return 0;
+	return (NSUInteger)length;
+}
+
+- (void)updateChecksumOfFrame:(ORSSerialFrame *)frame toPosition:(NSUInteger)position
+{
+	position = MIN(position, frame->checksumEnd);
+	if (position <= frame->checksummedPosition) return;
+	const uint8_t *bytes = _windowBytes + (frame->checksummedPosition - _windowStartPosition);
+	frame->checksumState = ORSSerialChecksumUpdate(_checksumAlgorithm, frame->checksumState, bytes, position - frame->checksummedPosition);
+	frame->checksummedPosition = position;
+}
+
+- (BOOL)frameHasValidChecksum:(ORSSerialFrame *)frame
+{
+	if (!_checksumLength) return YES;
+	[self updateChecksumOfFrame:frame toPosition:frame->checksumEnd];
+	return ORSSerialChecksumStateMatches(_checksumAlgorithm, frame->checksumState, _windowBytes + (frame->checksumEnd - _windowStartPosition));
+}
+
+- (void)addFrame:(ORSSerialFrame)frame
+{
+	if (_frameCount == _framesCapacity) {
+		_framesCapacity = MAX(_framesCapacity * 2, (NSUInteger)8);
+		_frames = reallocf(_frames, _framesCapacity * sizeof(ORSSerialFrame));
+	}
+	NSUInteger index = _frameCount++;
+	while (index > 0) {
+		NSUInteger parent = (index - 1) / 2;
+		if (_frames[parent].end <= frame.end) break;
+		_frames[index] = _frames[parent];
+		index = parent;
+	}
+	_frames[index] = frame;
+}
+
+- (void)removeFirstFrame
+{
+	ORSSerialFrame last = _frames[--_frameCount];
+	NSUInteger index = 0;
+	while (YES) {
+		NSUInteger child = index * 2 + 1;
+		if (child >= _frameCount) break;
+		if (child + 1 < _frameCount && _frames[child + 1].end < _frames[child].end) child++;
+		if (last.end <= _frames[child].end) break;
+		_frames[index] = _frames[child];
+		index = child;
+	}
+	if (_frameCount) _frames[index] = last;
+}
+
+@end
@@ -0,0 +1,30 @@
+//
+//  ORSSerialLinePacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher for descriptors created with -initWithLineTerminator:maximumPacketLength:userInfo: or
+ *  -initWithLineTerminatorString:maximumPacketLength:userInfo:.
+ *
+ *  Each received chunk is searched for the last byte of the terminator, 16 bytes at a time, and
+ *  the bytes before each one found are compared with the rest of the terminator. Every byte is
+ *  looked at once, even when a line spans several chunks, and the line delivered is a view of the
+ *  receive window. Empty lines and lines longer than the descriptor's maximumPacketLength are dropped.
+ */
+@interface ORSSerialLinePacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
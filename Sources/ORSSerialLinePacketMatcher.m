@@ -0,0 +1,108 @@
+//
+//  ORSSerialLinePacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialLinePacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialByteSearch.h"
+#import "ORSSerialChecksum.h"
+
+@interface ORSSerialLinePacketMatcher ()
+{
+	NSData *_terminator;
+	NSUInteger _terminatorLength;
+	uint8_t _lastTerminatorByte;
+	NSUInteger _maximumPacketLength;
+	BOOL _neverMatches;
+
+	ORSSerialPacketChecksumAlgorithm _checksumAlgorithm;
+	NSUInteger _checksumOffset;
+	NSUInteger _checksumTrailerLength;
+
+	NSUInteger _lineStart; // Position of the first byte after the last terminator, NSNotFound until scanning starts
+}
+
+@end
+
+@implementation ORSSerialLinePacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		_terminator = descriptor.lineTerminator;
+		_terminatorLength = [_terminator length];
+		_lastTerminatorByte = _terminatorLength ? ((const uint8_t *)[_terminator bytes])[_terminatorLength - 1] : 0;
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_neverMatches = (!_terminatorLength || _terminatorLength >= _maximumPacketLength);
+
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+
+		_lineStart = NSNotFound;
+	}
+	return self;
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_lineStart == NSNotFound) _lineStart = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	if (_neverMatches) _position = _endPosition;
+
+	while (_position < _endPosition) {
+		NSUInteger offset = ORSSerialFindByte(_windowBytes + (_position - _windowStartPosition), _endPosition - _position, _lastTerminatorByte);
+		if (offset == NSNotFound) {
+			_position = _endPosition;
+			break;
+		}
+
+		NSUInteger received = _position + offset + 1;
+		_position = received;
+
+		// The rest of the terminator may have arrived in an earlier chunk, which the window still holds
+		if (received < _lineStart + _terminatorLength) continue;
+		const uint8_t *terminator = _windowBytes + (received - _terminatorLength - _windowStartPosition);
+		if (_terminatorLength > 1 && memcmp(terminator, [_terminator bytes], _terminatorLength - 1)) continue;
+
+		NSUInteger start = _lineStart;
+		_lineStart = received;
+
+		// The window only holds maximumPacketLength bytes before the chunk, so check length first
+		NSUInteger length = received - start;
+		if (length == _terminatorLength || length > _maximumPacketLength) continue;
+		if (_checksumAlgorithm != ORSSerialPacketChecksumNone &&
+			!ORSSerialPacketHasValidChecksum(_checksumAlgorithm, _windowBytes + (start - _windowStartPosition), length, _checksumOffset, _checksumTrailerLength)) continue;
+
+		_packet = [_window dataInRange:NSMakeRange(start, length)];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = received - 1;
+		[self reset];
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_lineStart = _window ? _position : NSNotFound;
+}
+
+@end
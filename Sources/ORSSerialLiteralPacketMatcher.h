@@ -0,0 +1,34 @@
+//
+//  ORSSerialLiteralPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher for descriptors created with -initWithPrefix:suffix:maximumPacketLength:userInfo:,
+ *  -initWithPrefixString:suffixString:maximumPacketLength:userInfo: or -initWithPacketData:userInfo:.
+ *
+ *  Rather than re-evaluating every window at the end of the buffer after each byte, it tracks the
+ *  prefix and suffix incrementally (KMP-style) and keeps a list of the positions where a prefix
+ *  started. Each byte costs amortized constant time, and no per-window data is allocated. Packets
+ *  found are exactly those the descriptor's evaluator would find: the shortest window ending at the
+ *  current byte that starts with the prefix, ends with the suffix and fits in maximumPacketLength.
+ *
+ *  If the descriptor declares a checksum, it's only computed for windows that are otherwise valid,
+ *  starting with the shortest.
+ */
+@interface ORSSerialLiteralPacketMatcher : ORSSerialPacketMatcher
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
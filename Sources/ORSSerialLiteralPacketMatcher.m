@@ -0,0 +1,284 @@
+//
+//  ORSSerialLiteralPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialLiteralPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialChecksum.h"
+
+#pragma mark - Incremental Pattern Matching
+
+typedef struct {
+	uint8_t *pattern;
+	NSUInteger length;
+	NSUInteger *failure; // failure[i] is the length of the longest proper border of pattern[0...i]
+	NSUInteger state; // Number of pattern bytes currently matched
+} ORSSerialPatternMatcher;
+
+static void ORSSerialPatternMatcherInit(ORSSerialPatternMatcher *matcher, NSData *pattern)
+{
+	NSUInteger length = [pattern length];
+	matcher->length = length;
+	matcher->state = 0;
+	matcher->pattern = NULL;
+	matcher->failure = NULL;
+	if (!length) return;
+
+	matcher->pattern = malloc(length);
+	memcpy(matcher->pattern, [pattern bytes], length);
+	matcher->failure = calloc(length, sizeof(NSUInteger));
+	for (NSUInteger i=1, k=0; i<length; i++) {
+		while (k > 0 && matcher->pattern[i] != matcher->pattern[k]) k = matcher->failure[k-1];
+		if (matcher->pattern[i] == matcher->pattern[k]) k++;
+		matcher->failure[i] = k;
+	}
+}
+
+static void ORSSerialPatternMatcherFree(ORSSerialPatternMatcher *matcher)
+{
+	free(matcher->pattern);
+	free(matcher->failure);
+}
+
+// Returns YES if byte completes an occurrence of the pattern
+static inline BOOL ORSSerialPatternMatcherAdvance(ORSSerialPatternMatcher *matcher, uint8_t byte)
+{
+	NSUInteger state = matcher->state;
+	while (state > 0 && matcher->pattern[state] != byte) state = matcher->failure[state-1];
+	if (matcher->pattern[state] == byte) state++;
+
+	BOOL complete = (state == matcher->length);
+	if (complete) state = matcher->failure[state-1];
+	matcher->state = state;
+	return complete;
+}
+
+#pragma mark -
+
+// Running checksum of a candidate packet start, covering the bytes from its checksum offset to position
+typedef struct {
+	NSUInteger position;
+	uint32_t state;
+} ORSSerialLiteralChecksum;
+
+@interface ORSSerialLiteralPacketMatcher ()
+{
+	ORSSerialPatternMatcher _prefix;
+	ORSSerialPatternMatcher _suffix;
+	BOOL _neverMatches;
+	NSUInteger _maximumPacketLength;
+	NSUInteger _minimumPacketLength;
+	ORSSerialPacketChecksumAlgorithm _checksumAlgorithm;
+	NSUInteger _checksumOffset;
+	NSUInteger _checksumTrailerLength;
+
+	NSUInteger _clearPosition; // Position of the first byte after the last packet, NSNotFound until scanning starts
+
+	// Ring of positions at which an occurrence of the prefix starts, oldest first
+	NSUInteger *_prefixStarts;
+	NSUInteger _prefixStartsCapacity;
+	NSUInteger _prefixStartsHead;
+	NSUInteger _prefixStartsCount;
+
+	// Without a prefix, every position may start a packet. Each candidate start's checksum is kept in
+	// a ring indexed by start position, and brought up to date when a suffix arrives, so no byte is
+	// checksummed twice for the same start.
+	ORSSerialLiteralChecksum *_checksums;
+	NSUInteger _checksumsCapacity;
+	NSUInteger _checksumsEnd; // Starts before this have a running checksum
+}
+
+@end
+
+@implementation ORSSerialLiteralPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		_descriptor = descriptor;
+		NSData *prefix = descriptor.prefix;
+		NSData *suffix = descriptor.suffix;
+		if (descriptor.packetData) {
+			// A fixed packet is equivalent to a suffix with no prefix
+			prefix = nil;
+			suffix = descriptor.packetData;
+		}
+		_neverMatches = (prefix == nil && suffix == nil);
+
+		ORSSerialPatternMatcherInit(&_prefix, prefix);
+		ORSSerialPatternMatcherInit(&_suffix, suffix);
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+		NSUInteger checksumEnd = _checksumAlgorithm == ORSSerialPacketChecksumNone ? 0 : _checksumOffset + ORSSerialChecksumLength(_checksumAlgorithm) + _checksumTrailerLength;
+		_minimumPacketLength = MAX(MAX(MAX(_prefix.length, _suffix.length), checksumEnd), 1);
+		if (_minimumPacketLength > _maximumPacketLength) _neverMatches = YES;
+
+		_clearPosition = NSNotFound;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	ORSSerialPatternMatcherFree(&_prefix);
+	ORSSerialPatternMatcherFree(&_suffix);
+	free(_prefixStarts);
+	free(_checksums);
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_clearPosition == NSNotFound) _clearPosition = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	if (_neverMatches) _position = _endPosition;
+
+	while (_position < _endPosition) {
+		NSUInteger position = _position++;
+		uint8_t byte = _windowBytes[position - _windowStartPosition];
+
+		if (_prefix.length && ORSSerialPatternMatcherAdvance(&_prefix, byte)) {
+			[self addPrefixStart:position + 1 - _prefix.length];
+		}
+
+		// No suffix means any byte may end a packet
+		if (_suffix.length && !ORSSerialPatternMatcherAdvance(&_suffix, byte)) continue;
+
+		NSUInteger packetLength = [self lengthOfPacketEndingAtPosition:position];
+		if (!packetLength) continue;
+
+		_packet = [_window dataInRange:NSMakeRange(position + 1 - packetLength, packetLength)];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = position;
+		[self reset];
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_prefix.state = 0;
+	_suffix.state = 0;
+	_prefixStartsCount = 0;
+	_prefixStartsHead = 0;
+	_checksumsEnd = 0;
+	_clearPosition = _window ? _position : NSNotFound;
+}
+
+#pragma mark - Private
+
+// Returns the length of the shortest valid packet ending at position, or 0 if there isn't one.
+- (NSUInteger)lengthOfPacketEndingAtPosition:(NSUInteger)position
+{
+	NSUInteger received = position + 1;
+	if (received < _clearPosition + _minimumPacketLength) return 0;
+
+	NSUInteger latestStart = received - _minimumPacketLength;
+	// Packets starting before this have fallen out of the longest possible packet
+	NSUInteger earliestStart = MAX(_clearPosition, received > _maximumPacketLength ? received - _maximumPacketLength : 0);
+	if (latestStart < earliestStart) return 0;
+
+	if (!_prefix.length) {
+		// Without a checksum, the shortest packet is always valid
+		if (_checksumAlgorithm == ORSSerialPacketChecksumNone) return received - latestStart;
+		[self addChecksumsForStartsFrom:earliestStart through:latestStart];
+		for (NSUInteger start=latestStart; start>=earliestStart; start--) {
+			if ([self checksumForStart:start matchesAtPosition:received]) return received - start;
+			if (start == 0) break;
+		}
+		return 0;
+	}
+
+	[self discardPrefixStartsBefore:earliestStart];
+
+	// Shortest packet wins, so search from the most recent prefix backwards. Without a checksum, only
+	// prefixes that overlap the suffix by too much are skipped, so this loop is bounded by the suffix length.
+	for (NSUInteger i=_prefixStartsCount; i>0; i--) {
+		NSUInteger start = _prefixStarts[(_prefixStartsHead + i - 1) % _prefixStartsCapacity];
+		if (start <= latestStart && [self hasValidChecksumFromPosition:start toPosition:received]) return received - start;
+	}
+	return 0;
+}
+
+// The checksum is only computed for windows that are otherwise valid packets
+- (BOOL)hasValidChecksumFromPosition:(NSUInteger)start toPosition:(NSUInteger)end
+{
+	if (_checksumAlgorithm == ORSSerialPacketChecksumNone) return YES;
+	return ORSSerialPacketHasValidChecksum(_checksumAlgorithm, _windowBytes + (start - _windowStartPosition), end - start, _checksumOffset, _checksumTrailerLength);
+}
+
+- (void)addChecksumsForStartsFrom:(NSUInteger)earliestStart through:(NSUInteger)latestStart
+{
+	if (!_checksums) {
+		_checksumsCapacity = _maximumPacketLength - _minimumPacketLength + 1; // Most starts a suffix can have
+		_checksums = malloc(_checksumsCapacity * sizeof(ORSSerialLiteralChecksum));
+	}
+	uint32_t initialState = ORSSerialChecksumInitialState(_checksumAlgorithm);
+	for (NSUInteger start=MAX(_checksumsEnd, earliestStart); start<=latestStart; start++) {
+		_checksums[start % _checksumsCapacity] = (ORSSerialLiteralChecksum){start + _checksumOffset, initialState};
+	}
+	_checksumsEnd = MAX(_checksumsEnd, latestStart + 1);
+}
+
+// Brings the start's running checksum up to the checksum of a packet ending at end, and checks it
+- (BOOL)checksumForStart:(NSUInteger)start matchesAtPosition:(NSUInteger)end
+{
+	ORSSerialLiteralChecksum *checksum = &_checksums[start % _checksumsCapacity];
+	NSUInteger checksumPosition = end - _checksumTrailerLength - ORSSerialChecksumLength(_checksumAlgorithm);
+	if (checksumPosition > checksum->position) {
+		const uint8_t *bytes = _windowBytes + (checksum->position - _windowStartPosition);
+		checksum->state = ORSSerialChecksumUpdate(_checksumAlgorithm, checksum->state, bytes, checksumPosition - checksum->position);
+		checksum->position = checksumPosition;
+	}
+	return ORSSerialChecksumStateMatches(_checksumAlgorithm, checksum->state, _windowBytes + (checksumPosition - _windowStartPosition));
+}
+
+- (void)addPrefixStart:(NSUInteger)start
+{
+	// Any packet found from now on ends after this prefix, so can't start more than the maximum packet
+	// length before its end. Pruning here keeps the ring bounded when no suffix arrives.
+	NSUInteger prefixEnd = start + _prefix.length;
+	[self discardPrefixStartsBefore:MAX(_clearPosition, prefixEnd > _maximumPacketLength ? prefixEnd - _maximumPacketLength : 0)];
+
+	if (_prefixStartsCount == _prefixStartsCapacity) {
+		NSUInteger newCapacity = MAX(_prefixStartsCapacity * 2, (NSUInteger)16);
+		NSUInteger *newStarts = malloc(newCapacity * sizeof(NSUInteger));
+		for (NSUInteger i=0; i<_prefixStartsCount; i++) {
+			newStarts[i] = _prefixStarts[(_prefixStartsHead + i) % _prefixStartsCapacity];
+		}
+		free(_prefixStarts);
+		_prefixStarts = newStarts;
+		_prefixStartsCapacity = newCapacity;
+		_prefixStartsHead = 0;
+	}
+	_prefixStarts[(_prefixStartsHead + _prefixStartsCount) % _prefixStartsCapacity] = start;
+	_prefixStartsCount++;
+}
+
+- (void)discardPrefixStartsBefore:(NSUInteger)position
+{
+	while (_prefixStartsCount && _prefixStarts[_prefixStartsHead] < position) {
+		_prefixStartsHead = (_prefixStartsHead + 1) % _prefixStartsCapacity;
+		_prefixStartsCount--;
+	}
+}
+
+@end
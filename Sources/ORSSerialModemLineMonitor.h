@@ -0,0 +1,36 @@
+//
+//  ORSSerialModemLineMonitor.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Called with the modem line bits (TIOCM_*) and the previous bits when they change, or with
+// errorCode set to an errno value if they couldn't be read.
+typedef void(^ORSSerialModemLineHandler)(int modemLines, int previousModemLines, int errorCode);
+
+/**
+ *  Private class used by ORSSerialPort to watch CTS, DSR and DCD, shared by all ports.
+ *
+ *  macOS serial drivers don't support waiting for modem line changes (TIOCMIWAIT), so lines
+ *  are still polled with TIOCMGET, but not at a fixed rate. Each file descriptor is polled
+ *  often right after its lines change, and less and less often while they don't, up to
+ *  maximumPollInterval. A single timer does the polling for every port, and polls that are
+ *  due close together are made in one wakeup.
+ *
+ *  Handlers are called on the monitor's private queue, so they should return quickly.
+ */
+@interface ORSSerialModemLineMonitor : NSObject
+
++ (instancetype)sharedMonitor;
+
+// Handler is first called with the lines' initial state. Returns a token for -stopMonitoring:.
+- (id)startMonitoringFileDescriptor:(int)fileDescriptor handler:(ORSSerialModemLineHandler)handler;
+- (void)stopMonitoring:(id)token; // Handler isn't called once this returns
+
+@property (nonatomic, readonly) NSTimeInterval minimumPollInterval;
+@property (nonatomic, readonly) NSTimeInterval maximumPollInterval;
+
+@end
@@ -0,0 +1,165 @@
+//
+//  ORSSerialModemLineMonitor.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialModemLineMonitor.h"
+#import "ORSSerialStatistics.h"
+#import <sys/ioctl.h>
+
+#if OS_OBJECT_USE_OBJC && __has_feature(objc_arc)
+#define ORS_GCD_RELEASE(x)
+#else
+#define ORS_GCD_RELEASE(x) if (x) { dispatch_release(x); }
+#endif
+
+static const uint64_t ORSSerialModemLineMonitorMinimumPollInterval = 2 * NSEC_PER_MSEC;
+static const uint64_t ORSSerialModemLineMonitorMaximumPollInterval = 50 * NSEC_PER_MSEC;
+static void *ORSSerialModemLineMonitorQueueKey = &ORSSerialModemLineMonitorQueueKey;
+
+@interface ORSSerialModemLineMonitorEntry : NSObject
+{
+@public
+	int _fileDescriptor;
+	int _modemLines;
+	BOOL _hasModemLines;
+	uint64_t _pollInterval;
+	uint64_t _nextPollTime;
+}
+@property (nonatomic, copy) ORSSerialModemLineHandler handler;
+@end
+
+@implementation ORSSerialModemLineMonitorEntry
+@end
+
+@interface ORSSerialModemLineMonitor ()
+
+@property (nonatomic, strong) NSMutableArray *entries; // Only accessed on queue
+
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) dispatch_source_t pollTimer;
+#else
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) dispatch_source_t pollTimer;
+#endif
+
+@end
+
+@implementation ORSSerialModemLineMonitor
+
++ (instancetype)sharedMonitor
+{
+	static ORSSerialModemLineMonitor *sharedMonitor = nil;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		sharedMonitor = [[self alloc] init];
+	});
+	return sharedMonitor;
+}
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		_entries = [NSMutableArray array];
+		_queue = dispatch_queue_create("com.openreelsoftware.ORSSerialPort.modemLineMonitor", 0);
+		dispatch_queue_set_specific(_queue, ORSSerialModemLineMonitorQueueKey, ORSSerialModemLineMonitorQueueKey, NULL);
+		_pollTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+		dispatch_source_set_timer(_pollTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+		__weak ORSSerialModemLineMonitor *weakSelf = self;
+		dispatch_source_set_event_handler(_pollTimer, ^{ [weakSelf pollDueEntries]; });
+		dispatch_resume(_pollTimer);
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_pollTimer) {
+		dispatch_source_cancel(_pollTimer);
+		ORS_GCD_RELEASE(_pollTimer);
+	}
+	ORS_GCD_RELEASE(_queue);
+}
+
+- (id)startMonitoringFileDescriptor:(int)fileDescriptor handler:(ORSSerialModemLineHandler)handler
+{
+	ORSSerialModemLineMonitorEntry *entry = [[ORSSerialModemLineMonitorEntry alloc] init];
+	entry->_fileDescriptor = fileDescriptor;
+	entry->_pollInterval = ORSSerialModemLineMonitorMinimumPollInterval;
+	entry.handler = handler;
+	dispatch_async(self.queue, ^{
+		[self.entries addObject:entry];
+		[self pollDueEntries]; // Polls the new entry right away
+	});
+	return entry;
+}
+
+- (void)stopMonitoring:(id)token
+{
+	if (!token) return;
+	void (^stopBlock)(void) = ^{
+		[self.entries removeObjectIdenticalTo:token];
+		[(ORSSerialModemLineMonitorEntry *)token setHandler:nil];
+	};
+	
+	// A port can be deallocated from inside its own handler
+	if (dispatch_get_specific(ORSSerialModemLineMonitorQueueKey)) {
+		stopBlock();
+	} else {
+		dispatch_sync(self.queue, stopBlock);
+	}
+}
+
+- (NSTimeInterval)minimumPollInterval { return (NSTimeInterval)ORSSerialModemLineMonitorMinimumPollInterval / NSEC_PER_SEC; }
+- (NSTimeInterval)maximumPollInterval { return (NSTimeInterval)ORSSerialModemLineMonitorMaximumPollInterval / NSEC_PER_SEC; }
+
+#pragma mark - Private
+
+// Runs on queue
+- (void)pollDueEntries
+{
+	uint64_t now = ORSSerialStatisticsNanoseconds();
+	uint64_t nextPollTime = UINT64_MAX;
+	uint64_t nextPollInterval = ORSSerialModemLineMonitorMaximumPollInterval;
+	
+	for (ORSSerialModemLineMonitorEntry *entry in [self.entries copy]) {
+		// Anything due within half its interval is polled now, so idle ports share wakeups
+		if (entry->_nextPollTime > now + entry->_pollInterval / 2) {
+			if (entry->_nextPollTime < nextPollTime) nextPollTime = entry->_nextPollTime;
+			nextPollInterval = MIN(nextPollInterval, entry->_pollInterval);
+			continue;
+		}
+		
+		int modemLines = 0;
+		if (ioctl(entry->_fileDescriptor, TIOCMGET, &modemLines) < 0) {
+			int errorCode = errno;
+			entry->_pollInterval = ORSSerialModemLineMonitorMaximumPollInterval;
+			if (entry.handler) entry.handler(entry->_modemLines, entry->_modemLines, errorCode);
+		} else if (!entry->_hasModemLines || modemLines != entry->_modemLines) {
+			int previousModemLines = entry->_hasModemLines ? entry->_modemLines : ~modemLines;
+			entry->_modemLines = modemLines;
+			entry->_hasModemLines = YES;
+			entry->_pollInterval = ORSSerialModemLineMonitorMinimumPollInterval;
+			if (entry.handler) entry.handler(modemLines, previousModemLines, 0);
+		} else {
+			entry->_pollInterval = MIN(entry->_pollInterval * 2, ORSSerialModemLineMonitorMaximumPollInterval);
+		}
+		
+		entry->_nextPollTime = now + entry->_pollInterval;
+		if (entry->_nextPollTime < nextPollTime) nextPollTime = entry->_nextPollTime;
+		nextPollInterval = MIN(nextPollInterval, entry->_pollInterval);
+	}
+	
+	if (nextPollTime == UINT64_MAX) {
+		dispatch_source_set_timer(self.pollTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+	} else {
+		uint64_t delay = nextPollTime > now ? nextPollTime - now : 0;
+		dispatch_source_set_timer(self.pollTimer, dispatch_time(DISPATCH_TIME_NOW, delay), DISPATCH_TIME_FOREVER, nextPollInterval / 4);
+	}
+}
+
+@end
@@ -0,0 +1,33 @@
+//
+//  ORSSerialPacketAutomaton.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+/**
+ *  Matcher that finds packets for any number of prefix/suffix and fixed-data descriptors
+ *  in a single pass over the received data.
+ *
+ *  All of the prefixes and suffixes of the installed descriptors are compiled into one
+ *  Aho-Corasick automaton, so each received byte costs one table lookup no matter how
+ *  many descriptors are installed. Per-descriptor work is only done when one of that
+ *  descriptor's prefixes or suffixes is completed. Packets found are the same as those
+ *  ORSSerialLiteralPacketMatcher would find for each descriptor individually.
+ *
+ *  The automaton is rebuilt whenever a descriptor is added or removed. Partially received
+ *  packets for descriptors that remain installed are preserved across a rebuild.
+ */
+@interface ORSSerialPacketAutomaton : ORSSerialPacketMatcher
+
+// Returns NO for descriptors that must be matched some other way.
++ (BOOL)canMatchPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+- (void)addPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+- (void)removePacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+@property (nonatomic, copy, readonly) NSArray *packetDescriptors;
+
+@end
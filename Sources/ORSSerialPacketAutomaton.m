@@ -0,0 +1,434 @@
+//
+//  ORSSerialPacketAutomaton.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketAutomaton.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+
+#pragma mark - Automaton Tables
+
+typedef struct {
+	uint32_t entry; // Index of descriptor the pattern belongs to
+	uint32_t length;
+	BOOL isPrefix;
+} ORSSerialAutomatonOutput;
+
+typedef struct {
+	const uint8_t *bytes;
+	uint32_t length;
+	uint32_t entry;
+	BOOL isPrefix;
+} ORSSerialAutomatonPattern;
+
+typedef struct {
+	uint32_t *transitions; // nodeCount * 256 entries, next node for each (node, byte)
+	NSUInteger *outputStarts; // Index in outputs of first pattern completed on entering node
+	NSUInteger *outputCounts;
+	ORSSerialAutomatonOutput *outputs;
+	NSUInteger nodeCount;
+} ORSSerialAutomatonTables;
+
+static void ORSSerialAutomatonTablesFree(ORSSerialAutomatonTables *tables)
+{
+	free(tables->transitions);
+	free(tables->outputStarts);
+	free(tables->outputCounts);
+	free(tables->outputs);
+	memset(tables, 0, sizeof(*tables));
+}
+
+// Builds a complete DFA (goto function with failure transitions folded in) for patterns. Outputs
+// for each node are ordered so that prefixes come before suffixes, which lets a prefix that ends
+// on the same byte as a suffix start a packet that the suffix then ends. Patterns must not be empty.
+static void ORSSerialAutomatonTablesBuild(ORSSerialAutomatonTables *tables, const ORSSerialAutomatonPattern *patterns, NSUInteger patternCount)
+{
+	ORSSerialAutomatonTablesFree(tables);
+
+	NSUInteger maxNodes = 1;
+	for (NSUInteger i=0; i<patternCount; i++) maxNodes += patterns[i].length;
+
+	uint32_t *transitions = malloc(maxNodes * 256 * sizeof(uint32_t));
+	memset(transitions, 0xFF, maxNodes * 256 * sizeof(uint32_t));
+	uint32_t *terminalNodes = malloc(MAX(patternCount, (NSUInteger)1) * sizeof(uint32_t));
+	NSUInteger nodeCount = 1;
+
+	// Trie
+	for (NSUInteger i=0; i<patternCount; i++) {
+		uint32_t node = 0;
+		for (uint32_t j=0; j<patterns[i].length; j++) {
+			uint32_t *next = &transitions[node * 256 + patterns[i].bytes[j]];
+			if (*next == UINT32_MAX) *next = (uint32_t)nodeCount++;
+			node = *next;
+		}
+		terminalNodes[i] = node;
+	}
+
+	// Patterns ending at each node, bucketed by node
+	NSUInteger *ownCounts = calloc(nodeCount + 1, sizeof(NSUInteger));
+	for (NSUInteger i=0; i<patternCount; i++) ownCounts[terminalNodes[i] + 1]++;
+	for (NSUInteger n=0; n<nodeCount; n++) ownCounts[n + 1] += ownCounts[n]; // Now bucket starts
+	NSUInteger *ownPatterns = malloc(MAX(patternCount, (NSUInteger)1) * sizeof(NSUInteger));
+	NSUInteger *fill = calloc(nodeCount, sizeof(NSUInteger));
+	for (NSUInteger i=0; i<patternCount; i++) {
+		uint32_t node = terminalNodes[i];
+		ownPatterns[ownCounts[node] + fill[node]++] = i;
+	}
+
+	// Breadth-first: fill in missing transitions and compute failure links. A node's failure
+	// target is always shallower, so its outputs are complete by the time they're needed.
+	uint32_t *fail = calloc(nodeCount, sizeof(uint32_t));
+	uint32_t *queue = malloc(nodeCount * sizeof(uint32_t));
+	NSUInteger queueHead = 0, queueTail = 0;
+	for (NSUInteger c=0; c<256; c++) {
+		uint32_t next = transitions[c];
+		if (next == UINT32_MAX) {
+			transitions[c] = 0;
+		} else {
+			fail[next] = 0;
+			queue[queueTail++] = next;
+		}
+	}
+
+	NSUInteger outputCapacity = MAX(patternCount, (NSUInteger)16);
+	ORSSerialAutomatonOutput *outputs = malloc(outputCapacity * sizeof(ORSSerialAutomatonOutput));
+	NSUInteger outputCount = 0;
+	NSUInteger *outputStarts = calloc(nodeCount, sizeof(NSUInteger));
+	NSUInteger *outputCounts = calloc(nodeCount, sizeof(NSUInteger));
+
+	while (queueHead < queueTail) {
+		uint32_t node = queue[queueHead++];
+		for (NSUInteger c=0; c<256; c++) {
+			uint32_t next = transitions[node * 256 + c];
+			uint32_t fallback = transitions[fail[node] * 256 + c];
+			if (next == UINT32_MAX) {
+				transitions[node * 256 + c] = fallback;
+			} else {
+				fail[next] = fallback;
+				queue[queueTail++] = next;
+			}
+		}
+
+		// Outputs are the patterns ending here plus those of the failure target
+		NSUInteger ownCount = ownCounts[node + 1] - ownCounts[node];
+		NSUInteger inheritedCount = outputCounts[fail[node]];
+		NSUInteger needed = outputCount + ownCount + inheritedCount;
+		if (needed > outputCapacity) {
+			outputCapacity = MAX(outputCapacity * 2, needed);
+			outputs = realloc(outputs, outputCapacity * sizeof(ORSSerialAutomatonOutput));
+		}
+
+		NSUInteger start = outputCount;
+		for (int pass=0; pass<2; pass++) {
+			BOOL wantPrefixes = (pass == 0);
+			for (NSUInteger k=ownCounts[node]; k<ownCounts[node + 1]; k++) {
+				const ORSSerialAutomatonPattern *pattern = &patterns[ownPatterns[k]];
+				if (pattern->isPrefix != wantPrefixes) continue;
+				outputs[outputCount++] = (ORSSerialAutomatonOutput){pattern->entry, pattern->length, pattern->isPrefix};
+			}
+			NSUInteger inheritedStart = outputStarts[fail[node]];
+			for (NSUInteger k=inheritedStart; k<inheritedStart+inheritedCount; k++) {
+				if (outputs[k].isPrefix != wantPrefixes) continue;
+				outputs[outputCount++] = outputs[k];
+			}
+		}
+		outputStarts[node] = start;
+		outputCounts[node] = outputCount - start;
+	}
+
+	free(terminalNodes);
+	free(ownCounts);
+	free(ownPatterns);
+	free(fill);
+	free(fail);
+	free(queue);
+
+	tables->transitions = realloc(transitions, nodeCount * 256 * sizeof(uint32_t));
+	tables->outputStarts = outputStarts;
+	tables->outputCounts = outputCounts;
+	tables->outputs = outputs;
+	tables->nodeCount = nodeCount;
+}
+
+#pragma mark - Descriptor State
+
+typedef struct {
+	NSUInteger prefixLength; // 0 if the descriptor has no prefix
+	NSUInteger suffixLength;
+	NSUInteger minimumPacketLength;
+	NSUInteger maximumPacketLength;
+	NSUInteger clearPosition; // Position of the first byte after this descriptor's last packet, NSNotFound until scanning starts
+
+	// Ring of stream positions at which an occurrence of the prefix starts, oldest first
+	NSUInteger *prefixStarts;
+	NSUInteger prefixStartsCapacity;
+	NSUInteger prefixStartsHead;
+	NSUInteger prefixStartsCount;
+} ORSSerialAutomatonEntry;
+
+static void ORSSerialAutomatonEntryDiscardPrefixStarts(ORSSerialAutomatonEntry *entry, NSUInteger earliestStart)
+{
+	while (entry->prefixStartsCount && entry->prefixStarts[entry->prefixStartsHead] < earliestStart) {
+		entry->prefixStartsHead = (entry->prefixStartsHead + 1) % entry->prefixStartsCapacity;
+		entry->prefixStartsCount--;
+	}
+}
+
+static void ORSSerialAutomatonEntryAddPrefixStart(ORSSerialAutomatonEntry *entry, NSUInteger start)
+{
+	// Later packets end after this prefix, so earlier starts beyond the maximum packet length are dead.
+	// Pruning here keeps the ring bounded for a descriptor whose suffix never arrives.
+	NSUInteger prefixEnd = start + entry->prefixLength;
+	ORSSerialAutomatonEntryDiscardPrefixStarts(entry, prefixEnd > entry->maximumPacketLength ? prefixEnd - entry->maximumPacketLength : 0);
+
+	if (entry->prefixStartsCount == entry->prefixStartsCapacity) {
+		NSUInteger newCapacity = MAX(entry->prefixStartsCapacity * 2, (NSUInteger)16);
+		NSUInteger *newStarts = malloc(newCapacity * sizeof(NSUInteger));
+		for (NSUInteger i=0; i<entry->prefixStartsCount; i++) {
+			newStarts[i] = entry->prefixStarts[(entry->prefixStartsHead + i) % entry->prefixStartsCapacity];
+		}
+		free(entry->prefixStarts);
+		entry->prefixStarts = newStarts;
+		entry->prefixStartsCapacity = newCapacity;
+		entry->prefixStartsHead = 0;
+	}
+	entry->prefixStarts[(entry->prefixStartsHead + entry->prefixStartsCount) % entry->prefixStartsCapacity] = start;
+	entry->prefixStartsCount++;
+}
+
+static void ORSSerialAutomatonEntryClear(ORSSerialAutomatonEntry *entry, NSUInteger position)
+{
+	entry->clearPosition = position;
+	entry->prefixStartsHead = 0;
+	entry->prefixStartsCount = 0;
+}
+
+// Handles a pattern completed by the byte at position. Returns the length of the packet ending
+// there, or 0 if there isn't one.
+static NSUInteger ORSSerialAutomatonEntryHandleOutput(ORSSerialAutomatonEntry *entry, ORSSerialAutomatonOutput output, NSUInteger position)
+{
+	NSUInteger received = position + 1;
+	NSUInteger start = received - output.length;
+	if (received < output.length || start < entry->clearPosition) return 0; // Overlaps this descriptor's previous packet
+
+	if (output.isPrefix) {
+		ORSSerialAutomatonEntryAddPrefixStart(entry, start);
+		return 0;
+	}
+
+	if (received < entry->clearPosition + entry->minimumPacketLength) return 0;
+	NSUInteger latestStart = received - entry->minimumPacketLength;
+	if (!entry->prefixLength) return received - latestStart;
+
+	// Prefixes starting before this have fallen out of the longest possible packet
+	ORSSerialAutomatonEntryDiscardPrefixStarts(entry, received > entry->maximumPacketLength ? received - entry->maximumPacketLength : 0);
+
+	// Shortest packet wins, so search from the most recent prefix backwards
+	for (NSUInteger i=entry->prefixStartsCount; i>0; i--) {
+		NSUInteger prefixStart = entry->prefixStarts[(entry->prefixStartsHead + i - 1) % entry->prefixStartsCapacity];
+		if (prefixStart <= latestStart) return received - prefixStart;
+	}
+	return 0;
+}
+
+#pragma mark -
+
+@interface ORSSerialPacketAutomaton ()
+{
+	ORSSerialAutomatonTables _tables;
+	ORSSerialAutomatonEntry *_entries; // Parallel to descriptors
+	NSUInteger _maximumPatternLength;
+
+	uint32_t _state; // Valid for the bytes before _position
+
+	// Patterns completed by the last scanned byte that haven't been handled yet
+	NSUInteger _pendingOutputIndex;
+	NSUInteger _pendingOutputCount;
+}
+
+@property (nonatomic, strong) NSMutableArray *descriptors;
+
+@end
+
+@implementation ORSSerialPacketAutomaton
+
++ (BOOL)canMatchPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	NSData *prefix, *suffix;
+	return [self getPrefix:&prefix suffix:&suffix forPacketDescriptor:descriptor];
+}
+
+// Reduces a descriptor to an optional, non-empty prefix and a non-empty suffix matching the
+// same packets. A prefix alone matches exactly the same packets as the same bytes used as a
+// suffix, since the shortest packet wins. Descriptors that match every byte or never match
+// aren't worth putting in the automaton, and neither are descriptors with a checksum, since
+// a packet's start then depends on more than where the prefix was.
++ (BOOL)getPrefix:(NSData **)outPrefix suffix:(NSData **)outSuffix forPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	if (descriptor.checksumAlgorithm != ORSSerialPacketChecksumNone) return NO;
+	NSData *prefix = descriptor.prefix;
+	NSData *suffix = descriptor.suffix;
+	if (descriptor.packetData) {
+		prefix = nil;
+		suffix = descriptor.packetData;
+	}
+	if (![prefix length] && ![suffix length]) return NO;
+	if (![suffix length]) {
+		suffix = prefix;
+		prefix = nil;
+	}
+	if (![prefix length]) prefix = nil;
+	if (MAX([prefix length], [suffix length]) > descriptor.maximumPacketLength) return NO;
+	if ([prefix length] > UINT32_MAX || [suffix length] > UINT32_MAX) return NO;
+
+	*outPrefix = prefix;
+	*outSuffix = suffix;
+	return YES;
+}
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		_descriptors = [NSMutableArray array];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for (NSUInteger i=0; i<[self.descriptors count]; i++) free(_entries[i].prefixStarts);
+	free(_entries);
+	ORSSerialAutomatonTablesFree(&_tables);
+}
+
+- (NSArray *)packetDescriptors { return [self.descriptors copy]; }
+
+- (void)addPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	if ([self.descriptors containsObject:descriptor]) return;
+	NSData *prefix, *suffix;
+	if (![[self class] getPrefix:&prefix suffix:&suffix forPacketDescriptor:descriptor]) {
+		[NSException raise:NSInvalidArgumentException format:@"%@ can't match %@", NSStringFromClass([self class]), descriptor];
+	}
+
+	NSUInteger count = [self.descriptors count];
+	_entries = realloc(_entries, (count + 1) * sizeof(ORSSerialAutomatonEntry));
+	ORSSerialAutomatonEntry *entry = &_entries[count];
+	memset(entry, 0, sizeof(*entry));
+	entry->prefixLength = [prefix length];
+	entry->suffixLength = [suffix length];
+	entry->minimumPacketLength = MAX(entry->prefixLength, entry->suffixLength);
+	entry->maximumPacketLength = descriptor.maximumPacketLength;
+	entry->clearPosition = NSNotFound; // Only bytes received from now on count for the new descriptor
+	[self.descriptors addObject:descriptor];
+
+	[self rebuild];
+}
+
+- (void)removePacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	NSUInteger index = [self.descriptors indexOfObject:descriptor];
+	if (index == NSNotFound) return;
+
+	free(_entries[index].prefixStarts);
+	NSUInteger count = [self.descriptors count];
+	memmove(&_entries[index], &_entries[index+1], (count - index - 1) * sizeof(ORSSerialAutomatonEntry));
+	[self.descriptors removeObjectAtIndex:index];
+
+	[self rebuild];
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	// Picking up anywhere other than where the last scan left off means the automaton's state is stale
+	if (position != _position) _state = 0;
+	[super beginScanningWindow:window fromPosition:position];
+	_pendingOutputCount = 0;
+	for (NSUInteger i=0; i<[self.descriptors count]; i++) {
+		if (_entries[i].clearPosition == NSNotFound) _entries[i].clearPosition = position;
+	}
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	_packetDescriptor = nil;
+
+	const uint32_t *transitions = _tables.transitions;
+	if (!transitions) _position = _endPosition; // No descriptors installed
+
+	while (_pendingOutputCount || _position < _endPosition) {
+		if (!_pendingOutputCount) {
+			_state = transitions[_state * 256 + _windowBytes[_position - _windowStartPosition]];
+			_position++;
+			_pendingOutputIndex = _tables.outputStarts[_state];
+			_pendingOutputCount = _tables.outputCounts[_state];
+			continue;
+		}
+
+		ORSSerialAutomatonOutput output = _tables.outputs[_pendingOutputIndex++];
+		_pendingOutputCount--;
+
+		NSUInteger position = _position - 1;
+		ORSSerialAutomatonEntry *entry = &_entries[output.entry];
+		NSUInteger packetLength = ORSSerialAutomatonEntryHandleOutput(entry, output, position);
+		if (!packetLength) continue;
+
+		_packet = [_window dataInRange:NSMakeRange(_position - packetLength, packetLength)];
+		_packetDescriptor = self.descriptors[output.entry];
+		_packetEndPosition = position;
+		ORSSerialAutomatonEntryClear(entry, _position);
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	_state = 0;
+	_pendingOutputCount = 0;
+	for (NSUInteger i=0; i<[self.descriptors count]; i++) {
+		ORSSerialAutomatonEntryClear(&_entries[i], _window ? _position : NSNotFound);
+	}
+}
+
+#pragma mark - Private
+
+- (void)rebuild
+{
+	NSUInteger count = [self.descriptors count];
+	ORSSerialAutomatonPattern *patterns = malloc(MAX(count * 2, (NSUInteger)1) * sizeof(ORSSerialAutomatonPattern));
+	NSUInteger patternCount = 0;
+	_maximumPatternLength = 0;
+	for (NSUInteger i=0; i<count; i++) {
+		NSData *prefix, *suffix;
+		[[self class] getPrefix:&prefix suffix:&suffix forPacketDescriptor:self.descriptors[i]];
+		if (prefix) patterns[patternCount++] = (ORSSerialAutomatonPattern){[prefix bytes], (uint32_t)[prefix length], (uint32_t)i, YES};
+		patterns[patternCount++] = (ORSSerialAutomatonPattern){[suffix bytes], (uint32_t)[suffix length], (uint32_t)i, NO};
+		_maximumPatternLength = MAX(_maximumPatternLength, MAX([prefix length], [suffix length]));
+	}
+
+	if (patternCount) {
+		ORSSerialAutomatonTablesBuild(&_tables, patterns, patternCount);
+	} else {
+		ORSSerialAutomatonTablesFree(&_tables);
+	}
+	free(patterns);
+
+	// Get back to the state the new automaton would be in had it seen the stream so far.
+	// Only the most recent bytes can be part of a pattern in progress.
+	_state = 0;
+	if (_tables.transitions && _window && _position >= _window.startPosition && _position <= _window.endPosition) {
+		NSUInteger replayStart = MAX(_window.startPosition, _position > _maximumPatternLength ? _position - _maximumPatternLength : 0);
+		const uint8_t *bytes = [_window bytesAtPosition:replayStart];
+		for (NSUInteger i=0; i<_position-replayStart; i++) {
+			_state = _tables.transitions[_state * 256 + bytes[i]];
+		}
+	}
+}
+
+@end
@@ -25,11 +25,17 @@
 //	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialByteStuffing.h"
+#import "ORSSerialChecksum.h"
+#import "ORSSerialIncrementalPacketMatcher.h"
 
 @interface ORSSerialPacketDescriptor ()
 
 @property (nonatomic, copy, readonly) ORSSerialPacketEvaluator responseEvaluator;
 
+// Copies everything about descriptor but its uuid
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
 @end
 
 @implementation ORSSerialPacketDescriptor
@@ -54,6 +60,73 @@
 	return self;
 }
 
+- (instancetype)initWithMaximumPacketLength:(NSUInteger)maxPacketLength
+								   userInfo:(id)userInfo
+				incrementalEvaluatorFactory:(ORSSerialIncrementalPacketEvaluatorFactory)factory
+{
+	// Valid packets are those a new evaluator finds when passed all of their bytes
+	self = [self initWithMaximumPacketLength:maxPacketLength userInfo:userInfo responseEvaluator:^BOOL(NSData *data) {
+		NSUInteger length = [data length];
+		if (!length || length > maxPacketLength) return NO;
+		ORSSerialIncrementalScan scan = {0, 0, NO};
+		NSRange range;
+		if (!ORSSerialIncrementalScanNextPacket(factory(), &scan, [data bytes], 0, length, maxPacketLength, &range)) return NO;
+		return NSEqualRanges(range, NSMakeRange(0, length));
+	}];
+	if (self) {
+		_incrementalEvaluatorFactory = [factory copy];
+	}
+	return self;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [self initWithMaximumPacketLength:descriptor.maximumPacketLength userInfo:descriptor.userInfo responseEvaluator:descriptor.responseEvaluator];
+	if (self) {
+		_packetData = descriptor.packetData;
+		_prefix = descriptor.prefix;
+		_suffix = descriptor.suffix;
+		_regularExpression = descriptor.regularExpression;
+		_syncBytes = descriptor.syncBytes;
+		_lengthFieldOffset = descriptor.lengthFieldOffset;
+		_lengthFieldWidth = descriptor.lengthFieldWidth;
+		_lengthFieldByteOrder = descriptor.lengthFieldByteOrder;
+		_lengthAdjustment = descriptor.lengthAdjustment;
+		_incrementalEvaluatorFactory = descriptor.incrementalEvaluatorFactory;
+		_lineTerminator = descriptor.lineTerminator;
+		_framing = descriptor.framing;
+		_checksumAlgorithm = descriptor.checksumAlgorithm;
+		_checksumOffset = descriptor.checksumOffset;
+		_checksumTrailerLength = descriptor.checksumTrailerLength;
+		_correlationTagExtractor = descriptor.correlationTagExtractor;
+	}
+	return self;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+					   checksumAlgorithm:(ORSSerialPacketChecksumAlgorithm)algorithm
+						  checksumOffset:(NSUInteger)offset
+				   checksumTrailerLength:(NSUInteger)trailerLength
+{
+	self = [self initWithPacketDescriptor:descriptor];
+	if (self) {
+		_checksumAlgorithm = algorithm;
+		_checksumOffset = offset;
+		_checksumTrailerLength = trailerLength;
+	}
+	return self;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+				 correlationTagExtractor:(ORSSerialPacketCorrelationTagExtractor)correlationTagExtractor
+{
+	self = [self initWithPacketDescriptor:descriptor];
+	if (self) {
+		_correlationTagExtractor = [correlationTagExtractor copy];
+	}
+	return self;
+}
+
 - (instancetype)initWithPacketData:(NSData *)packetData userInfo:(nullable id)userInfo
 {
 	self = [self initWithMaximumPacketLength:[packetData length] userInfo:userInfo responseEvaluator:^BOOL(NSData *inputData) {
@@ -122,6 +195,104 @@
 	return self;
 }
 
+- (instancetype)initWithSyncBytes:(NSData *)syncBytes
+				lengthFieldOffset:(NSUInteger)lengthFieldOffset
+				 lengthFieldWidth:(NSUInteger)lengthFieldWidth
+			 lengthFieldByteOrder:(ORSSerialPacketLengthFieldByteOrder)byteOrder
+				 lengthAdjustment:(NSInteger)lengthAdjustment
+			  maximumPacketLength:(NSUInteger)maxPacketLength
+						 userInfo:(id)userInfo
+{
+	if (![syncBytes length]) {
+		[NSException raise:NSInvalidArgumentException format:@"%@ requires at least one sync byte", NSStringFromSelector(_cmd)];
+	}
+	if (lengthFieldWidth < 1 || lengthFieldWidth > 4) {
+		[NSException raise:NSInvalidArgumentException format:@"Length field width must be 1 to 4 bytes, not %lu", (unsigned long)lengthFieldWidth];
+	}
+
+	syncBytes = [syncBytes copy];
+	NSUInteger headerLength = MAX([syncBytes length], lengthFieldOffset + lengthFieldWidth);
+	self = [self initWithMaximumPacketLength:maxPacketLength userInfo:userInfo responseEvaluator:^BOOL(NSData *data) {
+		NSUInteger length = [data length];
+		if (length < headerLength || length > maxPacketLength) return NO;
+		if (memcmp([data bytes], [syncBytes bytes], [syncBytes length])) return NO;
+		
+		const uint8_t *lengthField = (const uint8_t *)[data bytes] + lengthFieldOffset;
+		NSInteger value = 0;
+		for (NSUInteger i=0; i<lengthFieldWidth; i++) {
+			NSUInteger index = (byteOrder == ORSSerialPacketLengthFieldBigEndian) ? i : lengthFieldWidth - 1 - i;
+			value = (value << 8) | lengthField[index];
+		}
+		return value + lengthAdjustment == (NSInteger)length;
+	}];
+	if (self) {
+		_syncBytes = syncBytes;
+		_lengthFieldOffset = lengthFieldOffset;
+		_lengthFieldWidth = lengthFieldWidth;
+		_lengthFieldByteOrder = byteOrder;
+		_lengthAdjustment = lengthAdjustment;
+	}
+	return self;
+}
+
+- (instancetype)initWithFraming:(ORSSerialPacketFraming)framing
+			maximumPacketLength:(NSUInteger)maxPacketLength
+					   userInfo:(id)userInfo
+{
+	if (framing != ORSSerialPacketFramingCOBS && framing != ORSSerialPacketFramingSLIP) {
+		[NSException raise:NSInvalidArgumentException format:@"%@ requires COBS or SLIP framing", NSStringFromSelector(_cmd)];
+	}
+
+	// Valid packets are a single frame, optionally preceded by a delimiter
+	uint8_t delimiter = ORSSerialFrameDelimiter(framing);
+	NSUInteger maxFrameLength = ORSSerialMaximumFrameLength(framing, maxPacketLength);
+	self = [self initWithMaximumPacketLength:maxFrameLength userInfo:userInfo responseEvaluator:^BOOL(NSData *data) {
+		NSUInteger length = [data length];
+		const uint8_t *bytes = [data bytes];
+		if (length < 2 || length > maxFrameLength || bytes[length-1] != delimiter) return NO;
+		if (bytes[0] == delimiter) { bytes++; length--; }
+		if (length < 2) return NO;
+
+		NSMutableData *payload = [NSMutableData dataWithLength:length];
+		return ORSSerialDecodeFrame(framing, bytes, length - 1, [payload mutableBytes]) != NSNotFound;
+	}];
+	if (self) {
+		_framing = framing;
+	}
+	return self;
+}
+
+- (instancetype)initWithLineTerminator:(NSData *)lineTerminator
+				   maximumPacketLength:(NSUInteger)maxPacketLength
+							  userInfo:(id)userInfo
+{
+	if (![lineTerminator length]) {
+		[NSException raise:NSInvalidArgumentException format:@"%@ requires a line terminator", NSStringFromSelector(_cmd)];
+	}
+
+	// Valid packets are a single non-empty line
+	lineTerminator = [lineTerminator copy];
+	self = [self initWithMaximumPacketLength:maxPacketLength userInfo:userInfo responseEvaluator:^BOOL(NSData *data) {
+		NSUInteger length = [data length];
+		NSUInteger terminatorLength = [lineTerminator length];
+		if (length <= terminatorLength || length > maxPacketLength) return NO;
+		NSRange range = [data rangeOfData:lineTerminator options:0 range:NSMakeRange(0, length)];
+		return range.location == length - terminatorLength;
+	}];
+	if (self) {
+		_lineTerminator = lineTerminator;
+	}
+	return self;
+}
+
+- (instancetype)initWithLineTerminatorString:(NSString *)lineTerminatorString
+						 maximumPacketLength:(NSUInteger)maxPacketLength
+									userInfo:(id)userInfo
+{
+	NSData *lineTerminator = [lineTerminatorString dataUsingEncoding:NSUTF8StringEncoding];
+	return [self initWithLineTerminator:lineTerminator maximumPacketLength:maxPacketLength userInfo:userInfo];
+}
+
 - (BOOL)isEqual:(id)object
 {
 	if (object == self) return YES;
@@ -133,12 +304,29 @@
 
 - (BOOL)dataIsValidPacket:(NSData *)packetData
 {
-	if (!self.responseEvaluator) return YES;
-	return self.responseEvaluator(packetData);
+	if (self.responseEvaluator && !self.responseEvaluator(packetData)) return NO;
+	if (self.checksumAlgorithm == ORSSerialPacketChecksumNone) return YES;
+
+	// Framed packets' checksums are part of their payloads
+	if (self.framing != ORSSerialPacketFramingNone) packetData = [self payloadOfFrameAtEndOfBuffer:packetData];
+	return packetData && [self payloadHasValidChecksum:packetData];
 }
 
 - (NSData *)packetMatchingAtEndOfBuffer:(NSData *)buffer
 {
+	if (self.framing != ORSSerialPacketFramingNone) {
+		NSData *payload = [self payloadOfFrameAtEndOfBuffer:buffer];
+		return (payload && [self payloadHasValidChecksum:payload]) ? payload : nil;
+	}
+	if (self.lineTerminator) {
+		NSData *line = [self lineAtEndOfBuffer:buffer];
+		return [self dataIsValidPacket:line] ? line : nil;
+	}
+	if (self.incrementalEvaluatorFactory) {
+		NSData *packet = [self lastPacketInBuffer:buffer];
+		return (packet && [self payloadHasValidChecksum:packet]) ? packet : nil;
+	}
+
 	for (NSUInteger i=1; i<=[buffer length]; i++)
 	{
 		NSData *window = [buffer subdataWithRange:NSMakeRange([buffer length]-i, i)];
@@ -147,4 +335,63 @@
 	return nil;
 }
 
+- (NSData *)encodedDataForPacket:(NSData *)packet
+{
+	return ORSSerialEncodeFrame(self.framing, packet);
+}
+
+#pragma mark - Private
+
+// Frames can't contain their delimiter, so the shortest valid window would usually be a truncated frame
+- (NSData *)payloadOfFrameAtEndOfBuffer:(NSData *)buffer
+{
+	NSUInteger length = [buffer length];
+	const uint8_t *bytes = [buffer bytes];
+	uint8_t delimiter = ORSSerialFrameDelimiter(self.framing);
+	if (length < 2 || bytes[length-1] != delimiter) return nil;
+
+	NSUInteger start = length - 1;
+	while (start > 0 && bytes[start-1] != delimiter) start--;
+	if (start == length - 1 || length - start > self.maximumPacketLength) return nil;
+
+	NSMutableData *payload = [NSMutableData dataWithLength:length - 1 - start];
+	NSUInteger payloadLength = ORSSerialDecodeFrame(self.framing, bytes + start, length - 1 - start, [payload mutableBytes]);
+	if (payloadLength == NSNotFound) return nil;
+	[payload setLength:payloadLength];
+	return payload;
+}
+
+// Like frames, lines can't contain their terminator
+- (NSData *)lineAtEndOfBuffer:(NSData *)buffer
+{
+	NSUInteger length = [buffer length];
+	NSUInteger terminatorLength = [self.lineTerminator length];
+	if (length <= terminatorLength) return nil;
+
+	// Lines start after the last terminator that's entirely before this one
+	NSRange searchRange = NSMakeRange(0, length - terminatorLength);
+	NSRange previous = [buffer rangeOfData:self.lineTerminator options:NSDataSearchBackwards range:searchRange];
+	NSUInteger start = previous.location == NSNotFound ? 0 : NSMaxRange(previous);
+	return [buffer subdataWithRange:NSMakeRange(start, length - start)];
+}
+
+// Packets are found in order, so a packet ending the buffer is the last one
+- (NSData *)lastPacketInBuffer:(NSData *)buffer
+{
+	NSUInteger length = [buffer length];
+	id<ORSSerialIncrementalPacketEvaluator> evaluator = self.incrementalEvaluatorFactory();
+	ORSSerialIncrementalScan scan = {0, 0, NO};
+	NSRange range, lastRange = NSMakeRange(NSNotFound, 0);
+	while (ORSSerialIncrementalScanNextPacket(evaluator, &scan, [buffer bytes], 0, length, self.maximumPacketLength, &range)) {
+		lastRange = range;
+	}
+	if (lastRange.location == NSNotFound || NSMaxRange(lastRange) != length) return nil;
+	return [buffer subdataWithRange:lastRange];
+}
+
+- (BOOL)payloadHasValidChecksum:(NSData *)payload
+{
+	return ORSSerialPacketHasValidChecksum(self.checksumAlgorithm, [payload bytes], [payload length], self.checksumOffset, self.checksumTrailerLength);
+}
+
 @end
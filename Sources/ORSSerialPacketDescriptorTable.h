@@ -0,0 +1,51 @@
+//
+//  ORSSerialPacketDescriptorTable.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+@class ORSSerialPacketDescriptor;
+@class ORSSerialPacketMatcher;
+
+/**
+ *  Immutable snapshot of the packet descriptors a port is listening for and the matchers that
+ *  find their packets.
+ *
+ *  Listening for or no longer listening for a descriptor creates a new table that shares the
+ *  matchers of the descriptors that remain, so their partially received packets are kept. The
+ *  port publishes each new table with an atomic pointer swap, and the receive path picks it up
+ *  at the start of the next chunk without taking a lock.
+ *
+ *  The unique matchers are kept in a C array, so the receive path iterates them without
+ *  hashing or message sends.
+ */
+@interface ORSSerialPacketDescriptorTable : NSObject
+
+// Creates an empty table
+- (instancetype)init;
+
+- (instancetype)tableByAddingPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor matcher:(ORSSerialPacketMatcher *)matcher;
+- (instancetype)tableByRemovingPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+// Returns nil if the table doesn't contain descriptor
+- (ORSSerialPacketMatcher *)matcherForPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+// Descriptors whose packets are found by matcher, in the order they were added
+- (NSArray *)packetDescriptorsUsingMatcher:(ORSSerialPacketMatcher *)matcher;
+
+@property (nonatomic, copy, readonly) NSArray *packetDescriptors;
+@property (nonatomic, readonly) NSUInteger maximumPacketLength;
+
+// Each matcher appears once, even if it's shared by several descriptors. Valid for the lifetime of the table.
+@property (nonatomic, readonly) ORSSerialPacketMatcher * __unsafe_unretained const *matchers;
+@property (nonatomic, readonly) NSUInteger matcherCount;
+
+@end
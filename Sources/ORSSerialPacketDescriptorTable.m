@@ -0,0 +1,93 @@
+//
+//  ORSSerialPacketDescriptorTable.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketDescriptorTable.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialPacketMatcher.h"
+
+@interface ORSSerialPacketDescriptorTable ()
+{
+	NSArray *_descriptorMatchers; // Parallel to _packetDescriptors
+	NSArray *_uniqueMatchers; // Owns the matchers in _matchers
+	ORSSerialPacketMatcher * __unsafe_unretained *_matchers;
+}
+
+- (instancetype)initWithPacketDescriptors:(NSArray *)descriptors matchers:(NSArray *)matchers NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation ORSSerialPacketDescriptorTable
+
+- (instancetype)init
+{
+	return [self initWithPacketDescriptors:@[] matchers:@[]];
+}
+
+- (instancetype)initWithPacketDescriptors:(NSArray *)descriptors matchers:(NSArray *)matchers
+{
+	self = [super init];
+	if (self) {
+		_packetDescriptors = [descriptors copy];
+		_descriptorMatchers = [matchers copy];
+
+		NSMutableArray *uniqueMatchers = [NSMutableArray arrayWithCapacity:[matchers count]];
+		for (ORSSerialPacketMatcher *matcher in matchers) {
+			if ([uniqueMatchers indexOfObjectIdenticalTo:matcher] == NSNotFound) [uniqueMatchers addObject:matcher];
+		}
+		_uniqueMatchers = uniqueMatchers;
+		_matcherCount = [uniqueMatchers count];
+		_matchers = malloc(MAX(_matcherCount, (NSUInteger)1) * sizeof(*_matchers));
+		for (NSUInteger i=0; i<_matcherCount; i++) _matchers[i] = uniqueMatchers[i];
+
+		for (ORSSerialPacketDescriptor *descriptor in descriptors) {
+			_maximumPacketLength = MAX(_maximumPacketLength, descriptor.maximumPacketLength);
+		}
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(_matchers);
+}
+
+- (ORSSerialPacketMatcher * __unsafe_unretained const *)matchers { return _matchers; }
+
+- (instancetype)tableByAddingPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor matcher:(ORSSerialPacketMatcher *)matcher
+{
+	if ([self matcherForPacketDescriptor:descriptor]) return self;
+	NSArray *descriptors = [self.packetDescriptors arrayByAddingObject:descriptor];
+	NSArray *matchers = [_descriptorMatchers arrayByAddingObject:matcher];
+	return [[[self class] alloc] initWithPacketDescriptors:descriptors matchers:matchers];
+}
+
+- (instancetype)tableByRemovingPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	NSUInteger index = [self.packetDescriptors indexOfObject:descriptor];
+	if (index == NSNotFound) return self;
+	NSMutableArray *descriptors = [self.packetDescriptors mutableCopy];
+	NSMutableArray *matchers = [_descriptorMatchers mutableCopy];
+	[descriptors removeObjectAtIndex:index];
+	[matchers removeObjectAtIndex:index];
+	return [[[self class] alloc] initWithPacketDescriptors:descriptors matchers:matchers];
+}
+
+- (ORSSerialPacketMatcher *)matcherForPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	NSUInteger index = [self.packetDescriptors indexOfObject:descriptor];
+	return index != NSNotFound ? _descriptorMatchers[index] : nil;
+}
+
+- (NSArray *)packetDescriptorsUsingMatcher:(ORSSerialPacketMatcher *)matcher
+{
+	NSIndexSet *indexes = [_descriptorMatchers indexesOfObjectsPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop) {
+		return obj == matcher;
+	}];
+	return [self.packetDescriptors objectsAtIndexes:indexes];
+}
+
+@end
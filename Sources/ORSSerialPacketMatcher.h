@@ -0,0 +1,66 @@
+//
+//  ORSSerialPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ORSSerialPacketDescriptor;
+@class ORSSerialBuffer;
+@class ORSSerialStatistics;
+
+/**
+ *  Abstract, private class used by ORSSerialPort to find packets in received data. A matcher
+ *  holds the per-port parsing state for one or more packet descriptors and consumes
+ *  received data a chunk at a time, stopping each time a packet is completed.
+ *
+ *  Received data lives in a receive window shared by all of a port's matchers. Each matcher
+ *  only keeps track of stream positions in the window, such as where its descriptor's last
+ *  packet ended, rather than keeping its own copy of bytes that may be part of a packet.
+ *
+ *  Usage: append each received chunk to the window, call -beginScanningWindow:fromPosition:
+ *  with the position of the chunk's first byte, then call -scanForNextPacket repeatedly until
+ *  it returns NO. The window must keep enough bytes before the chunk to hold the longest
+ *  packet the matcher's descriptors allow, and must not be modified until scanning is done.
+ *
+ *  Use +matcherWithPacketDescriptor: to get an instance of the most efficient concrete
+ *  subclass for a given descriptor.
+ */
+@interface ORSSerialPacketMatcher : NSObject
+{
+@protected
+	ORSSerialBuffer *_window;
+	const uint8_t *_windowBytes; // Contents of _window, starting at _windowStartPosition
+	NSUInteger _windowStartPosition;
+	NSUInteger _position; // Position of next byte to be scanned
+	NSUInteger _endPosition; // Position after last byte to be scanned
+	NSData *_packet;
+	ORSSerialPacketDescriptor *_packetDescriptor;
+	NSUInteger _packetEndPosition;
+}
+
++ (ORSSerialPacketMatcher *)matcherWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+// Scans from position to the end of window.
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position;
+- (BOOL)scanForNextPacket; // Subclasses must override
+
+// Discards any partially received packets.
+- (void)reset; // Subclasses must override
+
+// Discards any packet found or partially received that includes the byte at position, and picks up
+// scanning again after it. position must be before the next byte to be scanned. Call -scanForNextPacket
+// to continue. Used when another matcher's packet has claimed the data up to position.
+- (void)discardDataThroughPosition:(NSUInteger)position;
+
+// Valid after -scanForNextPacket returns YES
+@property (nonatomic, strong, readonly) NSData *packet;
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *packetDescriptor;
+@property (nonatomic, readonly) NSUInteger packetEndPosition; // Position in stream of the packet's last byte
+
+// Subclasses that call descriptors' evaluator blocks record how many times they do here, if set
+@property (nonatomic, strong) ORSSerialStatistics *statistics;
+
+@end
@@ -0,0 +1,76 @@
+//
+//  ORSSerialPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+#import "ORSSerialEvaluatorPacketMatcher.h"
+#import "ORSSerialLiteralPacketMatcher.h"
+#import "ORSSerialLengthPrefixedPacketMatcher.h"
+#import "ORSSerialFramedPacketMatcher.h"
+#import "ORSSerialLinePacketMatcher.h"
+#import "ORSSerialIncrementalPacketMatcher.h"
+#import "ORSSerialRegexPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+
+@implementation ORSSerialPacketMatcher
+
++ (ORSSerialPacketMatcher *)matcherWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	if (descriptor.syncBytes) {
+		return [[ORSSerialLengthPrefixedPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+	}
+	if (descriptor.framing != ORSSerialPacketFramingNone) {
+		return [[ORSSerialFramedPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+	}
+	if (descriptor.lineTerminator) {
+		return [[ORSSerialLinePacketMatcher alloc] initWithPacketDescriptor:descriptor];
+	}
+	if (descriptor.incrementalEvaluatorFactory) {
+		return [[ORSSerialIncrementalPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+	}
+	if (descriptor.packetData || descriptor.prefix || descriptor.suffix) {
+		return [[ORSSerialLiteralPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+	}
+	if (descriptor.regularExpression) {
+		ORSSerialPacketMatcher *matcher = [[ORSSerialRegexPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+		if (matcher) return matcher;
+	}
+	return [[ORSSerialEvaluatorPacketMatcher alloc] initWithPacketDescriptor:descriptor];
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	_window = window;
+	_windowStartPosition = window.startPosition;
+	_windowBytes = [window bytesAtPosition:_windowStartPosition];
+	_position = position;
+	_endPosition = window.endPosition;
+	_packet = nil;
+	_packetDescriptor = nil;
+}
+
+- (BOOL)scanForNextPacket
+{
+	[NSException raise:NSInternalInconsistencyException format:@"%@ must override %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd)];
+	return NO;
+}
+
+- (void)reset
+{
+	[NSException raise:NSInternalInconsistencyException format:@"%@ must override %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd)];
+}
+
+- (void)discardDataThroughPosition:(NSUInteger)position
+{
+	if (!_window) return;
+	
+	// Anything scanned after position is scanned again, since the state built from it may depend on what came before
+	[self beginScanningWindow:_window fromPosition:position + 1];
+	[self reset];
+}
+
+@end
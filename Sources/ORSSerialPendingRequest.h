@@ -0,0 +1,48 @@
+//
+//  ORSSerialPendingRequest.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+@class ORSSerialRequest;
+@class ORSSerialPacketMatcher;
+@class ORSSerialTimerWheelTimer;
+
+/**
+ *  Private class used by ORSSerialPort to keep track of a request that has been sent
+ *  and is waiting for its response.
+ *
+ *  Each pending request has its own response matcher and timeout timer, so any number of
+ *  them can be outstanding at once. Requests whose response descriptor has a correlation tag
+ *  extractor, and that have a correlation tag, only accept responses carrying their tag.
+ *  Others are answered in the order they were sent.
+ */
+@interface ORSSerialPendingRequest : NSObject
+
+- (instancetype)initWithRequest:(ORSSerialRequest *)request NS_DESIGNATED_INITIALIZER;
+
+// YES if packet, which responseMatcher has matched, is this request's response
+- (BOOL)isResponse:(NSData *)packet;
+
+@property (nonatomic, strong, readonly) ORSSerialRequest *request;
+@property (nonatomic, strong, readonly) ORSSerialPacketMatcher *responseMatcher; // nil if no response is expected
+@property (nonatomic, readonly) BOOL matchesResponsesByCorrelationTag;
+
+// Whether responseMatcher has started scanning the chunk of data being parsed
+@property (nonatomic, getter=isScanning) BOOL scanning;
+
+// ORSSerialStatisticsNanoseconds() when the request was sent
+@property (nonatomic) uint64_t sentTime;
+
+// Setting this cancels the previous timer
+@property (nonatomic, strong) ORSSerialTimerWheelTimer *timeoutTimer;
+
+@end
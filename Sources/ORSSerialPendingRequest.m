@@ -0,0 +1,54 @@
+//
+//  ORSSerialPendingRequest.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPendingRequest.h"
+#import "ORSSerial/ORSSerialRequest.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialPacketMatcher.h"
+#import "ORSSerialTimerWheel.h"
+
+@implementation ORSSerialPendingRequest
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[ORSSerialPendingRequest initWithRequest:]"];
+	return nil;
+}
+
+- (instancetype)initWithRequest:(ORSSerialRequest *)request
+{
+	self = [super init];
+	if (self) {
+		_request = request;
+		ORSSerialPacketDescriptor *responseDescriptor = request.responseDescriptor;
+		if (responseDescriptor) _responseMatcher = [ORSSerialPacketMatcher matcherWithPacketDescriptor:responseDescriptor];
+		_matchesResponsesByCorrelationTag = request.correlationTag && responseDescriptor.correlationTagExtractor;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	self.timeoutTimer = nil;
+}
+
+- (BOOL)isResponse:(NSData *)packet
+{
+	if (!self.matchesResponsesByCorrelationTag) return YES;
+	id tag = self.request.responseDescriptor.correlationTagExtractor(packet);
+	return tag && [tag isEqual:self.request.correlationTag];
+}
+
+- (void)setTimeoutTimer:(ORSSerialTimerWheelTimer *)timeoutTimer
+{
+	if (timeoutTimer != _timeoutTimer) {
+		[[ORSSerialTimerWheel sharedTimerWheel] cancelTimer:_timeoutTimer];
+		_timeoutTimer = timeoutTimer;
+	}
+}
+
+@end
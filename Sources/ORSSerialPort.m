@@ -26,12 +26,27 @@
 
 #import "ORSSerial/ORSSerialPort.h"
 #import "ORSSerial/ORSSerialRequest.h"
+#import "ORSSerial/ORSSerialTransport.h"
+#import "ORSSerialPacketMatcher.h"
+#import "ORSSerialPacketAutomaton.h"
+#import "ORSSerialPacketDescriptorTable.h"
 #import "ORSSerialBuffer.h"
+#import "ORSSerialReadSlabPool.h"
+#import "ORSSerialWriteQueue.h"
+#import "ORSSerialPendingRequest.h"
+#import "ORSSerialRequestScheduler.h"
+#import "ORSSerialTimerWheel.h"
+#import "ORSSerialModemLineMonitor.h"
+#import "ORSSerialReactor.h"
+#import "ORSSerialStatistics.h"
+#import "ORSSerial/ORSSerialPortStatistics.h"
 #import <IOKit/serial/IOSerialKeys.h>
 #import <IOKit/serial/ioss.h>
 #import <sys/param.h>
 #import <sys/filio.h>
 #import <sys/ioctl.h>
+#import <stdatomic.h>
+#import <pthread.h>
 
 #if !__has_feature(objc_arc)
 #error ORSSerialPort.m must be compiled with ARC. Either turn on ARC for the project or set the -fobjc-arc flag for ORSSerialPort.m in the Build Phases for this target
@@ -53,38 +68,67 @@
 
 static __strong NSMutableArray *allSerialPorts;
 
+static char ORSSerialPortDelegateQueueKey; // Queue-specific value identifying a delegate queue
+
+static const NSUInteger ORSSerialPortDefaultMaximumReadLength = 16384;
+static const NSUInteger ORSSerialPortMinimumReadLength = 1024; // Worth reserving even if less is waiting, in case more arrives
+static const NSUInteger ORSSerialPortDefaultWriteHighWaterMark = 65536;
+static const NSUInteger ORSSerialPortDefaultMaximumWriteBatchLength = 16384;
+static const NSTimeInterval ORSSerialPortCloseWriteTimeout = 2.0; // How long closing waits for queued data to be written
+
 @interface ORSSerialPort ()
 {
 	struct termios originalPortAttributes;
+	uint64_t _receiveTime; // When the chunk being parsed was read. Only used on requestHandlingQueue.
+	
+	// Current ORSSerialPacketDescriptorTable, retained. Replaced under _packetDescriptorTableLock, and read
+	// without a lock on requestHandlingQueue. Replaced tables are released on requestHandlingQueue, so
+	// they outlive any parse that might still be using them.
+	_Atomic(void *) _packetDescriptorTable;
+	pthread_mutex_t _packetDescriptorTableLock;
+	
+	// Packets waiting for a -serialPort:didReceivePackets:matchingDescriptors: call that hasn't been made yet.
+	// Added to on requestHandlingQueue, and closed on the delegate queue, both under _packetBatchLock, which is
+	// only held long enough to swap or append to them.
+	NSMutableArray *_openPacketBatch;
+	NSMutableArray *_openPacketBatchDescriptors;
+	pthread_mutex_t _packetBatchLock;
 }
 
+@property (strong, readwrite) id<ORSSerialTransport> transport;
 @property (copy, readwrite) NSString *path;
 @property (readwrite) io_object_t IOKitDevice;
 @property int fileDescriptor;
 @property (copy, readwrite) NSString *name;
 
-@property (strong) ORSSerialBuffer *requestResponseReceiveBuffer;
-
 // Packet descriptors
-@property (nonatomic, strong) NSMapTable *packetDescriptorsAndBuffers;
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptorTable *packetDescriptorTable;
+@property (nonatomic, strong) ORSSerialPacketDescriptorTable *appliedPacketDescriptorTable; // Only used on requestHandlingQueue
+@property (nonatomic, strong) ORSSerialPacketAutomaton *packetAutomaton; // Shared by all descriptors it can match
+
+// Received data, shared by all matchers. Only holds as much as the longest possible packet needs.
+@property (nonatomic, strong) ORSSerialBuffer *receiveWindow;
+@property (nonatomic, strong) ORSSerialReadSlabPool *readSlabPool;
+
+// Data waiting to be sent. Only exists while the port is open.
+@property (strong) ORSSerialWriteQueue *writeQueue;
 
 // Request handling
-@property (nonatomic, strong) NSMutableArray *requestsQueue;
-@property (nonatomic, strong, readwrite) ORSSerialRequest *pendingRequest;
+@property (nonatomic, strong) ORSSerialRequestScheduler *requestScheduler; // Requests waiting to be sent
+@property (copy) NSArray *sentRequests; // ORSSerialPendingRequests awaiting responses, oldest first
 
 @property (nonatomic, readwrite) BOOL CTS;
 @property (nonatomic, readwrite) BOOL DSR;
 @property (nonatomic, readwrite) BOOL DCD;
+@property (strong) id modemLineMonitorToken;
+
+@property (nonatomic, strong) ORSSerialStatistics *statisticsRecorder;
 
 #if OS_OBJECT_USE_OBJC
 @property (nonatomic, strong) dispatch_source_t readPollSource;
-@property (nonatomic, strong) dispatch_source_t pinPollTimer;
-@property (nonatomic, strong) dispatch_source_t pendingRequestTimeoutTimer;
 @property (nonatomic, strong) dispatch_queue_t requestHandlingQueue;
 #else
 @property (nonatomic) dispatch_source_t readPollSource;
-@property (nonatomic) dispatch_source_t pinPollTimer;
-@property (nonatomic) dispatch_source_t pendingRequestTimeoutTimer;
 @property (nonatomic) dispatch_queue_t requestHandlingQueue;
 #endif
 
@@ -149,6 +193,11 @@ static __strong NSMutableArray *allSerialPorts;
 	return [[self alloc] initWithDevice:device];
 }
 
++ (ORSSerialPort *)serialPortWithTransport:(id<ORSSerialTransport>)transport
+{
+	return [[self alloc] initWithTransport:transport];
+}
+
 - (instancetype)initWithPath:(NSString *)devicePath
 {
 	io_object_t device = [[self class] deviceFromBSDPath:devicePath];
@@ -170,16 +219,43 @@ static __strong NSMutableArray *allSerialPorts;
 		return existingPort;
 	}
 	
+	NSString *name = [[self class] modemNameFromDevice:device];
+	self = [self initWithTransport:[[ORSSerialFileDescriptorTransport alloc] initWithPath:bsdPath name:name]];
+	if (self != nil) self.ioKitDevice = device;
+	return self;
+}
+
+- (instancetype)initWithTransport:(id<ORSSerialTransport>)transport
+{
+	NSAssert(transport != nil, @"%s requires non-nil transport argument.", __PRETTY_FUNCTION__);
+	
 	self = [super init];
 	
 	if (self != nil)
 	{
-		self.ioKitDevice = device;
-		self.path = bsdPath;
-		self.name = [[self class] modemNameFromDevice:device];
+		self.transport = transport;
+		self.path = transport.path;
+		self.name = transport.name;
 		self.requestHandlingQueue = dispatch_queue_create("com.openreelsoftware.ORSSerialPort.requestHandlingQueue", 0);
-		self.packetDescriptorsAndBuffers = [NSMapTable strongToStrongObjectsMapTable];
-		self.requestsQueue = [NSMutableArray array];
+		self.delegateQueue = nil; // Main queue
+		ORSSerialPacketDescriptorTable *packetDescriptorTable = [[ORSSerialPacketDescriptorTable alloc] init];
+		atomic_init(&_packetDescriptorTable, (__bridge_retained void *)packetDescriptorTable);
+		pthread_mutex_init(&_packetDescriptorTableLock, NULL);
+		pthread_mutex_init(&_packetBatchLock, NULL);
+		self.appliedPacketDescriptorTable = packetDescriptorTable;
+		self.packetAutomaton = [[ORSSerialPacketAutomaton alloc] init];
+		self.receiveWindow = [[ORSSerialBuffer alloc] initWithMaximumLength:0];
+		self.readSlabPool = [[ORSSerialReadSlabPool alloc] initWithSlabLength:0];
+		self.maximumReadLength = ORSSerialPortDefaultMaximumReadLength;
+		self.writeHighWaterMark = ORSSerialPortDefaultWriteHighWaterMark;
+		self.maximumWriteBatchLength = ORSSerialPortDefaultMaximumWriteBatchLength;
+		__weak ORSSerialPort *weakSelf = self;
+		self.requestScheduler = [[ORSSerialRequestScheduler alloc] initWithExpirationQueue:self.requestHandlingQueue expirationHandler:^(ORSSerialRequest *request) {
+			[weakSelf queuedRequestDidExpire:request];
+		}];
+		self.sentRequests = @[];
+		self.statisticsRecorder = [[ORSSerialStatistics alloc] init];
+		self.maximumPendingRequestCount = 1;
 		self.baudRate = @B19200;
 		self.allowsNonStandardBaudRates = NO;
 		self.numberOfStopBits = 1;
@@ -215,17 +291,14 @@ static __strong NSMutableArray *allSerialPorts;
 		ORS_GCD_RELEASE(_readPollSource);
 	}
 	
-	if (_pinPollTimer) {
-		dispatch_source_cancel(_pinPollTimer);
-		ORS_GCD_RELEASE(_pinPollTimer);
-	}
-	
-	if (_pendingRequestTimeoutTimer) {
-		dispatch_source_cancel(_pendingRequestTimeoutTimer);
-		ORS_GCD_RELEASE(_pendingRequestTimeoutTimer);
-	}
+	[[ORSSerialModemLineMonitor sharedMonitor] stopMonitoring:_modemLineMonitorToken];
 	
 	self.requestHandlingQueue = nil;
+	ORS_GCD_RELEASE(_delegateQueue);
+	
+	CFBridgingRelease(atomic_load(&_packetDescriptorTable));
+	pthread_mutex_destroy(&_packetDescriptorTableLock);
+	pthread_mutex_destroy(&_packetBatchLock);
 }
 
 - (NSString *)description
@@ -254,10 +327,7 @@ static __strong NSMutableArray *allSerialPorts;
 {
 	if (self.isOpen) return;
 	
-	dispatch_queue_t mainQueue = dispatch_get_main_queue();
-
-	int descriptor=0;
-	descriptor = open([self.path cStringUsingEncoding:NSASCIIStringEncoding], O_RDWR | O_NOCTTY | O_EXLOCK | O_NONBLOCK);
+	int descriptor = [self.transport openFileDescriptor];
 	if (descriptor < 1)
 	{
 		// Error
@@ -265,85 +335,66 @@ static __strong NSMutableArray *allSerialPorts;
 		return;
 	}
 	
-	// Now that the device is open, clear the O_NONBLOCK flag so subsequent I/O will block.
-	// See fcntl(2) ("man 2 fcntl") for details.
+	// The port is left non-blocking. Reads are sized to what's waiting, and writes are
+	// made from the write queue whenever there's room for more.
 	
-	if (fcntl(descriptor, F_SETFL, 0) == -1)
-	{
-		LOG_SERIAL_PORT_ERROR(@"Error clearing O_NONBLOCK %@ - %s(%d).\n", self.path, strerror(errno), errno);
-	}
+	// With the shared reactor, reads and writes for this port both run on one of its queues
+	// instead of on queues of their own
+	dispatch_queue_t reactorQueue = self.usesSharedReactor ? [[ORSSerialReactor sharedReactor] nextQueue] : NULL;
 	
 	self.fileDescriptor = descriptor;
+	self.writeQueue = [self writeQueueForFileDescriptor:descriptor targetQueue:reactorQueue];
 	
 
 	// Port opened successfully, set options
-	tcgetattr(descriptor, &originalPortAttributes); // Get original options so they can be reset later
+	if (self.transport.supportsTerminalAttributes) tcgetattr(descriptor, &originalPortAttributes); // Get original options so they can be reset later
 	[self setPortOptions];
 	[self updateModemLines];
 
-	dispatch_async(mainQueue, ^{
+	[self performOnDelegateQueue:^{
 		if ([self.delegate respondsToSelector:@selector(serialPortWasOpened:)])
 		{
 			[self.delegate serialPortWasOpened:self];
 		}
-	});
+	} waitUntilDone:NO];
 
 	// Start a read dispatch source in the background
-	dispatch_source_t readPollSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, self.fileDescriptor, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0));
+	dispatch_queue_t readQueue = reactorQueue ?: dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+	dispatch_source_t readPollSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, self.fileDescriptor, 0, readQueue);
 	dispatch_source_set_event_handler(readPollSource, ^{
 		
 		int localPortFD = self.fileDescriptor;
 		if (!self.isOpen) return;
 		
-		// Data is available
-		char buf[1024];
-		long lengthRead = read(localPortFD, buf, sizeof(buf));
+		// Data is available. Read as much as is waiting in one go, straight into pooled memory
+		// that is passed on without being copied.
+		int bytesAvailable = 0;
+		if (ioctl(localPortFD, FIONREAD, &bytesAvailable) == -1) bytesAvailable = 0;
+		NSUInteger maximumReadLength = self.maximumReadLength;
+		NSUInteger readLength = MIN(MAX((NSUInteger)bytesAvailable, ORSSerialPortMinimumReadLength), maximumReadLength);
+		
+		ORSSerialReadSlabPool *slabPool = self.readSlabPool;
+		uint8_t *buf = [slabPool reserveBytes:readLength];
+		long lengthRead = read(localPortFD, buf, readLength);
 		if (lengthRead>0)
 		{
-			NSData *readData = [NSData dataWithBytes:buf length:lengthRead];
+			[self.statisticsRecorder recordReadOfLength:lengthRead];
+			NSData *readData = [slabPool dataByCommittingBytes:lengthRead];
 			if (readData != nil) [self receiveData:readData];
 		}
 	});
-	dispatch_source_set_cancel_handler(readPollSource, ^{ [self reallyClosePort]; });
+	dispatch_source_set_cancel_handler(readPollSource, ^{
+		[self reallyClosePort]; // Doesn't block, so it's fine on a shared reactor queue
+	});
 	dispatch_resume(readPollSource);
 	self.readPollSource = readPollSource;
 	
-	// Start another poller to check status of CTS and DSR
-	dispatch_queue_t pollQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
-	dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, pollQueue);
-	dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, 0), 10*NSEC_PER_MSEC, 5*NSEC_PER_MSEC);
-	dispatch_source_set_event_handler(timer, ^{
-		if (!self.isOpen) {
-			dispatch_async(pollQueue, ^{ dispatch_source_cancel(timer); });
-			return;
-		}
-		
-		int32_t modemLines=0;
-		int result = ioctl(self.fileDescriptor, TIOCMGET, &modemLines);
-		if (result < 0)
-		{
-			[self notifyDelegateOfPosixErrorWaitingUntilDone:(errno == ENXIO)];
-			if (errno == ENXIO)
-			{
-				[self cleanupAfterSystemRemoval];
-			}
-			return;
-		}
-		
-		BOOL CTSPin = (modemLines & TIOCM_CTS) != 0;
-		BOOL DSRPin = (modemLines & TIOCM_DSR) != 0;
-		BOOL DCDPin = (modemLines & TIOCM_CAR) != 0;
-		
-		if (CTSPin != self.CTS)
-			dispatch_sync(mainQueue, ^{self.CTS = CTSPin;});
-		if (DSRPin != self.DSR)
-			dispatch_sync(mainQueue, ^{self.DSR = DSRPin;});
-		if (DCDPin != self.DCD)
-			dispatch_sync(mainQueue, ^{self.DCD = DCDPin;});
-	});
-	self.pinPollTimer = timer;
-	dispatch_resume(self.pinPollTimer);
-	ORS_GCD_RELEASE(timer);
+	// Watch CTS, DSR and DCD. One adaptive poller is shared by all ports, and changes are posted asynchronously.
+	if (!self.transport.supportsModemLines) return;
+	__weak ORSSerialPort *weakSelf = self;
+	self.modemLineMonitorToken = [[ORSSerialModemLineMonitor sharedMonitor] startMonitoringFileDescriptor:descriptor handler:^(int modemLines, int previousModemLines, int errorCode) {
+		[weakSelf modemLinesDidChange:modemLines previousModemLines:previousModemLines errorCode:errorCode];
+	}];
 }
 
 - (BOOL)close;
@@ -355,21 +406,50 @@ static __strong NSMutableArray *allSerialPorts;
 
 - (void)reallyClosePort
 {
-	self.pinPollTimer = nil; // Stop polling CTS/DSR/DCD pins
+	// Stop watching CTS/DSR/DCD pins
+	[[ORSSerialModemLineMonitor sharedMonitor] stopMonitoring:self.modemLineMonitorToken];
+	self.modemLineMonitorToken = nil;
 	
 	// The next tcsetattr() call can fail if the port is waiting to send data. This is likely to happen
 	// e.g. if flow control is on and the CTS line is low. So, turn off flow control before proceeding
-	struct termios options;
-	tcgetattr(self.fileDescriptor, &options);
-	options.c_cflag &= ~CRTSCTS; // RTS/CTS Flow Control
-	options.c_cflag &= ~(CDTR_IFLOW | CDSR_OFLOW); // DTR/DSR Flow Control
-	options.c_cflag &= ~CCAR_OFLOW; // DCD Flow Control
-	tcsetattr(self.fileDescriptor, TCSANOW, &options);
+	BOOL supportsTerminalAttributes = self.transport.supportsTerminalAttributes;
+	if (supportsTerminalAttributes)
+	{
+		struct termios options;
+		tcgetattr(self.fileDescriptor, &options);
+		options.c_cflag &= ~CRTSCTS; // RTS/CTS Flow Control
+		options.c_cflag &= ~(CDTR_IFLOW | CDSR_OFLOW); // DTR/DSR Flow Control
+		options.c_cflag &= ~CCAR_OFLOW; // DCD Flow Control
+		tcsetattr(self.fileDescriptor, TCSANOW, &options);
+	}
 	
-	// Set port back the way it was before we used it
-	tcsetattr(self.fileDescriptor, TCSADRAIN, &originalPortAttributes);
+	// Send anything still queued, as it would have been if it had been written synchronously. The descriptor
+	// stays non-blocking, so if the other end stops reading, whatever's left fails once the timeout is up.
+	// Finishing waits for the delegate queue, so it's done on a queue of its own rather than holding up
+	// the write queue, which may be a reactor queue shared by other ports.
+	dispatch_queue_t finishQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+	ORSSerialWriteQueue *writeQueue = self.writeQueue;
+	self.writeQueue = nil;
+	if (!writeQueue)
+	{
+		dispatch_async(finishQueue, ^{ [self finishClosingPort]; });
+		return;
+	}
+	[writeQueue finishWritingWithTimeout:ORSSerialPortCloseWriteTimeout completionHandler:^{
+		dispatch_async(finishQueue, ^{ [self finishClosingPort]; });
+	}];
+}
+
+// Called on a global queue once queued data has been written or has failed
+- (void)finishClosingPort
+{
+	// Set port back the way it was before we used it. Only real serial ports are known to finish sending
+	// in bounded time, now that flow control is off.
+	BOOL supportsTerminalAttributes = self.transport.supportsTerminalAttributes;
+	int optionalActions = self.transport.supportsModemLines ? TCSADRAIN : TCSANOW;
+	if (supportsTerminalAttributes) tcsetattr(self.fileDescriptor, optionalActions, &originalPortAttributes);
 	
-	if (close(self.fileDescriptor))
+	if ([self.transport closeFileDescriptor:self.fileDescriptor])
 	{
 		LOG_SERIAL_PORT_ERROR(@"Error closing serial port with file descriptor %i:%i", self.fileDescriptor, errno);
 		[self notifyDelegateOfPosixError];
@@ -380,10 +460,10 @@ static __strong NSMutableArray *allSerialPorts;
 	
 	if ([self.delegate respondsToSelector:@selector(serialPortWasClosed:)])
 	{
-		[(id)self.delegate performSelectorOnMainThread:@selector(serialPortWasClosed:) withObject:self waitUntilDone:YES];
+		[self performOnDelegateQueue:^{ [self.delegate serialPortWasClosed:self]; } waitUntilDone:YES];
 		dispatch_async(self.requestHandlingQueue, ^{
-			self.requestsQueue = [NSMutableArray array]; // Cancel all queued requests
-			self.pendingRequest = nil; // Discard pending request
+			[self removeAllScheduledRequests]; // Cancel all queued requests
+			self.sentRequests = @[]; // Discard pending requests
 		});
 	}
 }
@@ -398,32 +478,28 @@ static __strong NSMutableArray *allSerialPorts;
 {
 	if ([self.delegate respondsToSelector:@selector(serialPortWasRemovedFromSystem:)])
 	{
-		[(id)self.delegate performSelectorOnMainThread:@selector(serialPortWasRemovedFromSystem:) withObject:self waitUntilDone:YES];
+		[self performOnDelegateQueue:^{ [self.delegate serialPortWasRemovedFromSystem:self]; } waitUntilDone:YES];
 	}
 	[self close];
 }
 
 - (BOOL)sendData:(NSData *)data;
 {
-	if (!self.isOpen) return NO;
-	if ([data length] == 0) return YES;
+	return [self sendData:data completionHandler:nil];
+}
+
+- (BOOL)sendData:(NSData *)data completionHandler:(void (^)(NSError *))completionHandler
+{
+	ORSSerialWriteQueue *writeQueue = self.writeQueue;
+	if (!self.isOpen || !writeQueue) return NO;
 	
-	NSMutableData *writeBuffer = [data mutableCopy];
-	while ([writeBuffer length] > 0)
-	{
-		long numBytesWritten = write(self.fileDescriptor, [writeBuffer bytes], [writeBuffer length]);
-		if (numBytesWritten < 0)
-		{
-			LOG_SERIAL_PORT_ERROR(@"Error writing to serial port:%d", errno);
-			[self notifyDelegateOfPosixError];
-			return NO;
-		}
-		else if (numBytesWritten > 0)
-		{
-			[writeBuffer replaceBytesInRange:NSMakeRange(0, numBytesWritten) withBytes:NULL length:0];
-		}
+	ORSSerialWriteCompletionHandler handler = nil;
+	if (completionHandler) {
+		handler = ^(NSError *error) {
+			[self performOnDelegateQueue:^{ completionHandler(error); } waitUntilDone:NO];
+		};
 	}
-	
+	[writeQueue enqueueData:data completionHandler:handler];
 	return YES;
 }
 
@@ -440,173 +516,465 @@ static __strong NSMutableArray *allSerialPorts;
 {
 	if (!request) return;
 	dispatch_async(self.requestHandlingQueue, ^{
-		if (request == self.pendingRequest) return;
-		NSInteger requestIndex = [self.requestsQueue indexOfObject:request];
-		if (requestIndex == NSNotFound) return;
-		[self removeObjectFromRequestsQueueAtIndex:requestIndex];
+		[self unscheduleRequest:request];
 	});
 }
 
 - (void)cancelAllQueuedRequests
 {
 	dispatch_async(self.requestHandlingQueue, ^{
-		self.requestsQueue = [NSMutableArray array];
+		[self removeAllScheduledRequests];
 	});
 }
 
 - (void)startListeningForPacketsMatchingDescriptor:(ORSSerialPacketDescriptor *)descriptor;
 {
-	if ([self.packetDescriptorsAndBuffers objectForKey:descriptor]) return; // Already listening
+	if ([self.packetDescriptorTable matcherForPacketDescriptor:descriptor]) return; // Already listening
 	
-	[self willChangeValueForKey:@"packetDescriptorsAndBuffers"];
-	dispatch_sync(self.requestHandlingQueue, ^{
-		ORSSerialBuffer *buffer = [[ORSSerialBuffer alloc] initWithMaximumLength:descriptor.maximumPacketLength];
-		[self.packetDescriptorsAndBuffers setObject:buffer forKey:descriptor];
-	});
-	[self didChangeValueForKey:@"packetDescriptorsAndBuffers"];
+	// The new matcher isn't seen by the receive path until the table containing it is published
+	ORSSerialPacketMatcher *matcher = nil;
+	if ([ORSSerialPacketAutomaton canMatchPacketDescriptor:descriptor]) {
+		matcher = self.packetAutomaton; // Descriptor is added to it on requestHandlingQueue
+	} else {
+		matcher = [ORSSerialPacketMatcher matcherWithPacketDescriptor:descriptor];
+		matcher.statistics = self.statisticsRecorder;
+	}
+	[self updatePacketDescriptorTable:^ORSSerialPacketDescriptorTable *(ORSSerialPacketDescriptorTable *table) {
+		return [table tableByAddingPacketDescriptor:descriptor matcher:matcher];
+	}];
 }
 
 - (void)stopListeningForPacketsMatchingDescriptor:(ORSSerialPacketDescriptor *)descriptor;
 {
-	[self willChangeValueForKey:@"packetDescriptorsAndBuffers"];
-	dispatch_sync(self.requestHandlingQueue, ^{ [self.packetDescriptorsAndBuffers removeObjectForKey:descriptor]; });
-	[self didChangeValueForKey:@"packetDescriptorsAndBuffers"];
+	[self updatePacketDescriptorTable:^ORSSerialPacketDescriptorTable *(ORSSerialPacketDescriptorTable *table) {
+		return [table tableByRemovingPacketDescriptor:descriptor];
+	}];
 }
 
 #pragma mark - Private Methods
 
+// Publishes the table returned by update. May be called on any thread, and never waits for requestHandlingQueue,
+// so listening for descriptors or no longer listening for them doesn't hold up the receive path, or wait for it.
+- (void)updatePacketDescriptorTable:(ORSSerialPacketDescriptorTable *(^)(ORSSerialPacketDescriptorTable *table))update
+{
+	[self willChangeValueForKey:@"packetDescriptorTable"];
+	pthread_mutex_lock(&_packetDescriptorTableLock);
+	ORSSerialPacketDescriptorTable *oldTable = (__bridge ORSSerialPacketDescriptorTable *)atomic_load_explicit(&_packetDescriptorTable, memory_order_relaxed);
+	ORSSerialPacketDescriptorTable *newTable = update(oldTable);
+	if (newTable != oldTable)
+	{
+		void *replacedTable = atomic_exchange_explicit(&_packetDescriptorTable, (__bridge_retained void *)newTable, memory_order_acq_rel);
+		
+		// A parse already under way may still be using the old table. It's done by the time this runs.
+		ORSSerialPacketDescriptorTable *retiredTable = (__bridge_transfer ORSSerialPacketDescriptorTable *)replacedTable;
+		dispatch_async(self.requestHandlingQueue, ^{
+			[self currentPacketDescriptorTable];
+			(void)retiredTable;
+		});
+	}
+	pthread_mutex_unlock(&_packetDescriptorTableLock);
+	[self didChangeValueForKey:@"packetDescriptorTable"];
+}
+
+// Must only be called on requestHandlingQueue. Returns the most recently published table, after bringing the
+// shared automaton and the statistics recorder up to date with it.
+- (ORSSerialPacketDescriptorTable *)currentPacketDescriptorTable
+{
+	ORSSerialPacketDescriptorTable *table = (__bridge ORSSerialPacketDescriptorTable *)atomic_load_explicit(&_packetDescriptorTable, memory_order_acquire);
+	if (table == self.appliedPacketDescriptorTable) return table;
+	
+	ORSSerialPacketAutomaton *automaton = self.packetAutomaton;
+	NSArray *automatonDescriptors = [table packetDescriptorsUsingMatcher:automaton];
+	for (ORSSerialPacketDescriptor *descriptor in automaton.packetDescriptors)
+	{
+		if (![automatonDescriptors containsObject:descriptor]) [automaton removePacketDescriptor:descriptor];
+	}
+	for (ORSSerialPacketDescriptor *descriptor in automatonDescriptors) [automaton addPacketDescriptor:descriptor];
+	
+	[self.statisticsRecorder setPacketDescriptors:table.packetDescriptors];
+	self.appliedPacketDescriptorTable = table;
+	return table;
+}
+
 // Must only be called on requestHandlingQueue (ie. wrap call to this method in dispatch())
 - (BOOL)reallySendRequest:(ORSSerialRequest *)request
 {
-	if (!self.pendingRequest)
+	if ([self.sentRequests count] < MAX(self.maximumPendingRequestCount, (NSUInteger)1))
 	{
-		NSUInteger bufferLength = request.responseDescriptor.maximumPacketLength;
-		self.requestResponseReceiveBuffer = [[ORSSerialBuffer alloc] initWithMaximumLength:bufferLength];
+		if ([self requestHasExpired:request]) return NO; // Dropped without being sent
 		
 		// Send immediately
-		self.pendingRequest = request;
+		ORSSerialPendingRequest *pendingRequest = [[ORSSerialPendingRequest alloc] initWithRequest:request];
+		pendingRequest.responseMatcher.statistics = self.statisticsRecorder;
+		pendingRequest.sentTime = ORSSerialStatisticsNanoseconds();
+		self.sentRequests = [self.sentRequests arrayByAddingObject:pendingRequest];
 		if (request.timeoutInterval > 0) {
-			NSTimeInterval timeoutInterval = request.timeoutInterval;
-			dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.requestHandlingQueue);
-			dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, timeoutInterval * NSEC_PER_SEC), timeoutInterval * NSEC_PER_SEC, timeoutInterval/10.0 * NSEC_PER_SEC);
-			dispatch_source_set_event_handler(timer, ^{ [self pendingRequestDidTimeout]; });
-			self.pendingRequestTimeoutTimer = timer;
-			dispatch_resume(self.pendingRequestTimeoutTimer);
+			// One timer wheel is shared by all ports, rather than creating a dispatch timer per request
+			__weak ORSSerialPendingRequest *weakPendingRequest = pendingRequest;
+			pendingRequest.timeoutTimer = [[ORSSerialTimerWheel sharedTimerWheel] scheduleTimerWithTimeInterval:request.timeoutInterval
+																										   queue:self.requestHandlingQueue
+																										 handler:^{ [self pendingRequestDidTimeout:weakPendingRequest]; }];
 		}
 		BOOL success = [self sendData:request.dataToSend];
 		// Immediately send next request if this one doesn't require a response
-		if (success) [self checkResponseToPendingRequestAndContinueIfValidWithReceivedByte:nil];
+		if (success && !request.responseDescriptor) [self finishPendingRequest:pendingRequest];
 		return success;
 	}
 	
-	// Queue it up to be sent after the pending request is responded to, or times out.
-	[self insertObject:request inRequestsQueueAtIndex:[self.requestsQueue count]];
+	// Queue it up to be sent after a pending request is responded to, or times out.
+	[self scheduleRequest:request];
 	return YES;
 }
 
 // Must only be called on requestHandlingQueue
-- (void)sendNextRequest
+- (void)sendQueuedRequests
 {
-	self.pendingRequest = nil;
-	if (![self.requestsQueue count]) return;
-	ORSSerialRequest *nextRequest = self.requestsQueue[0];
-	[self removeObjectFromRequestsQueueAtIndex:0];
-	[self reallySendRequest:nextRequest];
+	while ([self.sentRequests count] < MAX(self.maximumPendingRequestCount, (NSUInteger)1))
+	{
+		ORSSerialRequest *nextRequest = [self nextScheduledRequest];
+		if (!nextRequest) break;
+		[self reallySendRequest:nextRequest];
+	}
+}
+
+// Must only be called on requestHandlingQueue. Expired requests are dropped, and the delegate told.
+- (BOOL)requestHasExpired:(ORSSerialRequest *)request
+{
+	NSDate *deadline = request.deadline;
+	if (!deadline || [deadline timeIntervalSinceNow] > 0) return NO;
+	
+	[self.statisticsRecorder recordRequestExpiration];
+	[self performOnDelegateQueue:^{
+		if ([self.delegate respondsToSelector:@selector(serialPort:requestDidExpire:)])
+		{
+			[self.delegate serialPort:self requestDidExpire:request];
+		}
+	} waitUntilDone:NO];
+	return YES;
+}
+
+// Will only be called on requestHandlingQueue, when the deadline of a request that was still queued passes.
+// It's dropped then, rather than once it reaches the front of the queue.
+- (void)queuedRequestDidExpire:(ORSSerialRequest *)request
+{
+	[self willChangeValueForKey:@"queuedRequests"];
+	BOOL removed = [self.requestScheduler removeRequest:request];
+	[self didChangeValueForKey:@"queuedRequests"];
+	if (!removed) return; // Sent or cancelled in the meantime
+	[self.statisticsRecorder setQueuedRequestCount:self.requestScheduler.count];
+	[self requestHasExpired:request];
+}
+
+// Must only be called on requestHandlingQueue
+- (void)finishPendingRequest:(ORSSerialPendingRequest *)pendingRequest
+{
+	pendingRequest.timeoutTimer = nil;
+	NSMutableArray *sentRequests = [self.sentRequests mutableCopy];
+	[sentRequests removeObjectIdenticalTo:pendingRequest];
+	self.sentRequests = sentRequests;
+	[self sendQueuedRequests];
 }
 
 // Will only be called on requestHandlingQueue
-- (void)pendingRequestDidTimeout
+- (void)pendingRequestDidTimeout:(ORSSerialPendingRequest *)pendingRequest
 {
-	self.pendingRequestTimeoutTimer = nil;
+	if (![self.sentRequests containsObject:pendingRequest]) return;
+	pendingRequest.timeoutTimer = nil;
+	[self.statisticsRecorder recordRequestTimeout];
 	
-	ORSSerialRequest *request = self.pendingRequest;
+	ORSSerialRequest *request = pendingRequest.request;
 	
 	if (![self.delegate respondsToSelector:@selector(serialPort:requestDidTimeout:)])
 	{
-		[self sendNextRequest];
+		[self finishPendingRequest:pendingRequest];
 		return;
 	}
 	
-	dispatch_async(dispatch_get_main_queue(), ^{
+	[self performOnDelegateQueue:^{
 		[self.delegate serialPort:self requestDidTimeout:request];
 		dispatch_async(self.requestHandlingQueue, ^{
-			[self sendNextRequest];
+			[self finishPendingRequest:pendingRequest];
 		});
-	});
+	} waitUntilDone:NO];
 }
 
 // Must only be called on requestHandlingQueue
-- (void)checkResponseToPendingRequestAndContinueIfValidWithReceivedByte:(NSData *)byte
+- (void)pendingRequest:(ORSSerialPendingRequest *)pendingRequest didReceiveResponse:(NSData *)responseData
 {
-	if (!self.pendingRequest) return; // Nothing to do
-	
-	ORSSerialPacketDescriptor *packetDescriptor = self.pendingRequest.responseDescriptor;
-	
-	if (!byte) {
-		if (!packetDescriptor) [self sendNextRequest];
-		return;
-	}
-	
-	[self.requestResponseReceiveBuffer appendData:byte];
-	NSData *responseData = [packetDescriptor packetMatchingAtEndOfBuffer:self.requestResponseReceiveBuffer.data];
-	if (!responseData) return;
+	ORSSerialRequest *request = pendingRequest.request;
+	uint64_t receiveTime = _receiveTime;
+	[self.statisticsRecorder recordRequestRoundTripTime:ORSSerialStatisticsNanoseconds() - pendingRequest.sentTime];
 	
-	self.pendingRequestTimeoutTimer = nil;
-	ORSSerialRequest *request = self.pendingRequest;
+	// Packets received from now on are delivered after the response
+	[self closeOpenPacketBatch];
 	
-	dispatch_async(dispatch_get_main_queue(), ^{
+	[self performOnDelegateQueue:^{
+		[self.statisticsRecorder recordReceiveToDelegateLatency:ORSSerialStatisticsNanoseconds() - receiveTime];
 		if ([responseData length] &&
 			[self.delegate respondsToSelector:@selector(serialPort:didReceiveResponse:toRequest:)])
 		{
 			[self.delegate serialPort:self didReceiveResponse:responseData toRequest:request];
 		}
-	});
+	} waitUntilDone:NO];
 	
-	[self sendNextRequest];
+	[self finishPendingRequest:pendingRequest];
 }
 
 #pragma mark Port Read/Write
 
 - (void)receiveData:(NSData *)data;
 {
-	dispatch_async(dispatch_get_main_queue(), ^{
+	uint64_t receiveTime = ORSSerialStatisticsNanoseconds();
+	[self performOnDelegateQueue:^{
 		if ([self.delegate respondsToSelector:@selector(serialPort:didReceiveData:)])
 		{
 			[self.delegate serialPort:self didReceiveData:data];
 		}
-	});
+	} waitUntilDone:NO];
 	
 	dispatch_async(self.requestHandlingQueue, ^{
-		const void *bytes = [data bytes];
-		for (NSUInteger i=0; i<[data length]; i++) {
-			
-			NSData *byte = [NSData dataWithBytesNoCopy:(void *)(bytes+i) length:1 freeWhenDone:NO];
-			
-			// Check for packets we're listening for
-			for (ORSSerialPacketDescriptor *descriptor in self.packetDescriptorsAndBuffers)
+		_receiveTime = receiveTime;
+		[self parsePacketsInReceivedData:data];
+	});
+}
+
+// Must only be called on requestHandlingQueue
+- (void)parsePacketsInReceivedData:(NSData *)data
+{
+	// Besides this chunk, the window needs to hold everything but the last byte of the longest possible packet
+	ORSSerialBuffer *window = self.receiveWindow;
+	ORSSerialPacketDescriptorTable *table = [self currentPacketDescriptorTable];
+	NSUInteger maximumPacketLength = table.maximumPacketLength;
+	for (ORSSerialPendingRequest *pendingRequest in self.sentRequests)
+	{
+		maximumPacketLength = MAX(maximumPacketLength, pendingRequest.request.responseDescriptor.maximumPacketLength);
+	}
+	window.maximumLength = MAX(maximumPacketLength, 1) - 1 + [data length];
+	NSUInteger chunkStart = window.endPosition;
+	[window appendData:data];
+	
+	// Each matcher scans ahead through the whole chunk to its next packet boundary. Literal descriptors
+	// all share a single automaton, so the chunk is only scanned once for all of them. Packets and
+	// responses are then delivered in the order in which they end in the received stream, exactly
+	// as if the data had been processed one byte at a time.
+	ORSSerialPacketMatcher * __unsafe_unretained const *matchers = table.matchers;
+	NSUInteger matcherCount = table.matcherCount;
+	BOOL exclusive = self.usesExclusivePacketMatching;
+	for (NSUInteger i=0; i<matcherCount; i++)
+	{
+		[matchers[i] beginScanningWindow:window fromPosition:chunkStart];
+		[matchers[i] scanForNextPacket];
+	}
+	
+	for (ORSSerialPendingRequest *pendingRequest in self.sentRequests) pendingRequest.scanning = NO;
+	NSArray *responseScanners = [self pendingRequestsScanningForResponsesFromPosition:chunkStart];
+	
+	while (1)
+	{
+		ORSSerialPacketMatcher *nextMatcher = nil;
+		for (NSUInteger i=0; i<matcherCount; i++)
+		{
+			ORSSerialPacketMatcher *matcher = matchers[i];
+			if (!matcher.packet) continue;
+			if (!nextMatcher || matcher.packetEndPosition < nextMatcher.packetEndPosition) nextMatcher = matcher;
+		}
+		
+		// Of responses ending on the same byte, the one to the oldest request wins
+		ORSSerialPendingRequest *nextResponder = nil;
+		for (ORSSerialPendingRequest *pendingRequest in responseScanners)
+		{
+			ORSSerialPacketMatcher *matcher = pendingRequest.responseMatcher;
+			if (!matcher.packet) continue;
+			if (!nextResponder || matcher.packetEndPosition < nextResponder.responseMatcher.packetEndPosition) nextResponder = pendingRequest;
+		}
+		
+		// Packets ending on the same byte as a response are delivered before the response
+		ORSSerialPacketMatcher *responseMatcher = nextResponder.responseMatcher;
+		if (responseMatcher && (!nextMatcher || responseMatcher.packetEndPosition < nextMatcher.packetEndPosition))
+		{
+			NSUInteger responseEndPosition = responseMatcher.packetEndPosition;
+			if (![nextResponder isResponse:responseMatcher.packet])
 			{
-				// Append byte to buffer
-				ORSSerialBuffer *buffer = [self.packetDescriptorsAndBuffers objectForKey:descriptor];
-				[buffer appendData:byte];
-				
-				// Check for complete packet
-				NSData *completePacket = [descriptor packetMatchingAtEndOfBuffer:buffer.data];
-				if (![completePacket length]) continue;
-				
-				// Complete packet received, so notify delegate then clear buffer
-				dispatch_async(dispatch_get_main_queue(), ^{
-					if ([self.delegate respondsToSelector:@selector(serialPort:didReceivePacket:matchingDescriptor:)])
-					{
-						[self.delegate serialPort:self didReceivePacket:completePacket matchingDescriptor:descriptor];
-					}
-				});
-				[buffer clearBuffer];
+				// Tagged for a different request
+				[responseMatcher scanForNextPacket];
+				continue;
 			}
+			[self pendingRequest:nextResponder didReceiveResponse:responseMatcher.packet];
+			if (exclusive) [self consumeReceivedDataThroughPosition:responseEndPosition packetDescriptorTable:table];
 			
-			// Also check for response to pending request
-			[self checkResponseToPendingRequestAndContinueIfValidWithReceivedByte:byte];
+			// More requests may have been sent, or be next in line, so look for their responses in the rest of the chunk
+			responseScanners = [self pendingRequestsScanningForResponsesFromPosition:responseEndPosition+1];
+			continue;
 		}
-	});
+		
+		if (!nextMatcher) break;
+		
+		ORSSerialPacketDescriptor *descriptor = nextMatcher.packetDescriptor;
+		NSData *completePacket = nextMatcher.packet;
+		[self.statisticsRecorder recordPacketMatchingDescriptor:descriptor];
+		if ([self.delegate respondsToSelector:@selector(serialPort:didReceivePackets:matchingDescriptors:)])
+		{
+			[self addPacketToBatch:completePacket matchingDescriptor:descriptor];
+		}
+		else
+		{
+			uint64_t receiveTime = _receiveTime;
+			[self performOnDelegateQueue:^{
+				[self.statisticsRecorder recordReceiveToDelegateLatency:ORSSerialStatisticsNanoseconds() - receiveTime];
+				if ([self.delegate respondsToSelector:@selector(serialPort:didReceivePacket:matchingDescriptor:)])
+				{
+					[self.delegate serialPort:self didReceivePacket:completePacket matchingDescriptor:descriptor];
+				}
+			} waitUntilDone:NO];
+		}
+		
+		if (exclusive)
+		{
+			[self consumeReceivedDataThroughPosition:nextMatcher.packetEndPosition packetDescriptorTable:table];
+		}
+		else
+		{
+			[nextMatcher scanForNextPacket];
+		}
+	}
+}
+
+// Must only be called on requestHandlingQueue, while parsing. In exclusive mode, data that's part of a packet or
+// response can't be part of any other, so every matcher and response scanner picks up again after it. Matchers that
+// had scanned ahead past position rescan from there, which costs no more than what they'd already scanned.
+- (void)consumeReceivedDataThroughPosition:(NSUInteger)position packetDescriptorTable:(ORSSerialPacketDescriptorTable *)table
+{
+	ORSSerialPacketMatcher * __unsafe_unretained const *matchers = table.matchers;
+	for (NSUInteger i=0; i<table.matcherCount; i++)
+	{
+		[matchers[i] discardDataThroughPosition:position];
+		[matchers[i] scanForNextPacket];
+	}
+	
+	for (ORSSerialPendingRequest *pendingRequest in self.sentRequests)
+	{
+		if (!pendingRequest.isScanning) continue;
+		[pendingRequest.responseMatcher discardDataThroughPosition:position];
+		[pendingRequest.responseMatcher scanForNextPacket];
+	}
+}
+
+// Must only be called on requestHandlingQueue
+- (void)addPacketToBatch:(NSData *)packet matchingDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	pthread_mutex_lock(&_packetBatchLock);
+	NSMutableArray *packets = _openPacketBatch;
+	NSMutableArray *descriptors = _openPacketBatchDescriptors;
+	BOOL opened = !packets;
+	if (opened)
+	{
+		packets = [NSMutableArray array];
+		descriptors = [NSMutableArray array];
+		_openPacketBatch = packets;
+		_openPacketBatchDescriptors = descriptors;
+	}
+	[packets addObject:packet];
+	[descriptors addObject:descriptor];
+	pthread_mutex_unlock(&_packetBatchLock);
+	if (!opened) return;
+	
+	// Until this runs, packets that come in are added to the same batch. Latency is measured from the oldest.
+	// Closing the batch only takes the batch lock, so the delegate queue never waits for a parse to finish.
+	uint64_t receiveTime = _receiveTime;
+	[self performOnDelegateQueue:^{
+		[self closePacketBatch:packets];
+		[self.statisticsRecorder recordReceiveToDelegateLatency:ORSSerialStatisticsNanoseconds() - receiveTime];
+		if ([self.delegate respondsToSelector:@selector(serialPort:didReceivePackets:matchingDescriptors:)])
+		{
+			[self.delegate serialPort:self didReceivePackets:[packets copy] matchingDescriptors:[descriptors copy]];
+		}
+	} waitUntilDone:NO];
+}
+
+// May be called on any queue. Once closed, a batch isn't added to any more.
+- (void)closePacketBatch:(NSMutableArray *)packets
+{
+	pthread_mutex_lock(&_packetBatchLock);
+	if (packets && _openPacketBatch == packets)
+	{
+		_openPacketBatch = nil;
+		_openPacketBatchDescriptors = nil;
+	}
+	pthread_mutex_unlock(&_packetBatchLock);
+}
+
+// Must only be called on requestHandlingQueue
+- (void)closeOpenPacketBatch
+{
+	pthread_mutex_lock(&_packetBatchLock);
+	_openPacketBatch = nil;
+	_openPacketBatchDescriptors = nil;
+	pthread_mutex_unlock(&_packetBatchLock);
+}
+
+// Must only be called on requestHandlingQueue. Returns the pending requests whose responses can come next.
+// Those that weren't already scanning the current chunk start scanning it from position.
+- (NSArray *)pendingRequestsScanningForResponsesFromPosition:(NSUInteger)position
+{
+	NSMutableArray *scanners = [NSMutableArray array];
+	BOOL foundInOrderRequest = NO;
+	for (ORSSerialPendingRequest *pendingRequest in self.sentRequests)
+	{
+		if (!pendingRequest.responseMatcher) continue;
+		
+		// Requests without correlation tags are answered in order, so only the oldest is looked for
+		if (!pendingRequest.matchesResponsesByCorrelationTag)
+		{
+			if (foundInOrderRequest) continue;
+			foundInOrderRequest = YES;
+		}
+		
+		if (!pendingRequest.isScanning)
+		{
+			pendingRequest.scanning = YES;
+			[pendingRequest.responseMatcher beginScanningWindow:self.receiveWindow fromPosition:position];
+			[pendingRequest.responseMatcher scanForNextPacket];
+		}
+		[scanners addObject:pendingRequest];
+	}
+	return scanners;
+}
+
+// Called on the modem line monitor's queue
+- (void)modemLinesDidChange:(int)modemLines previousModemLines:(int)previousModemLines errorCode:(int)errorCode
+{
+	if (!self.isOpen) return;
+	
+	if (errorCode)
+	{
+		if (errorCode != ENXIO)
+		{
+			[self notifyDelegateOfPosixErrorCode:errorCode waitUntilDone:NO];
+			return;
+		}
+		
+		// The device is gone. Stop watching it, and clean up off the shared monitor's queue.
+		id token = self.modemLineMonitorToken;
+		self.modemLineMonitorToken = nil;
+		dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+			[[ORSSerialModemLineMonitor sharedMonitor] stopMonitoring:token];
+			[self notifyDelegateOfPosixErrorCode:errorCode waitUntilDone:YES];
+			[self cleanupAfterSystemRemoval];
+		});
+		return;
+	}
+	
+	int changedLines = modemLines ^ previousModemLines;
+	if (!(changedLines & (TIOCM_CTS | TIOCM_DSR | TIOCM_CAR))) return;
+	
+	BOOL CTSPin = (modemLines & TIOCM_CTS) != 0;
+	BOOL DSRPin = (modemLines & TIOCM_DSR) != 0;
+	BOOL DCDPin = (modemLines & TIOCM_CAR) != 0;
+	[self performOnDelegateQueue:^{
+		if (CTSPin != self.CTS) self.CTS = CTSPin;
+		if (DSRPin != self.DSR) self.DSR = DSRPin;
+		if (DCDPin != self.DCD) self.DCD = DCDPin;
+	} waitUntilDone:NO];
 }
 
 #pragma mark Port Propeties Methods
@@ -614,6 +982,7 @@ static __strong NSMutableArray *allSerialPorts;
 - (void)setPortOptions;
 {
 	if ([self fileDescriptor] < 1) return;
+	if (!self.transport.supportsTerminalAttributes) return;
 	
 	struct termios options;
 	
@@ -763,34 +1132,78 @@ static __strong NSMutableArray *allSerialPorts;
 
 #pragma mark Helper Methods
 
+- (ORSSerialWriteQueue *)writeQueueForFileDescriptor:(int)descriptor targetQueue:(dispatch_queue_t)targetQueue
+{
+	ORSSerialWriteQueue *writeQueue = [[ORSSerialWriteQueue alloc] initWithFileDescriptor:descriptor targetQueue:targetQueue];
+	writeQueue.statistics = self.statisticsRecorder;
+	writeQueue.highWaterMark = self.writeHighWaterMark;
+	writeQueue.coalescingInterval = self.writeCoalescingInterval;
+	writeQueue.maximumBatchLength = self.maximumWriteBatchLength;
+	
+	__weak ORSSerialPort *weakSelf = self;
+	writeQueue.errorHandler = ^(NSError *error) {
+		LOG_SERIAL_PORT_ERROR(@"Error writing to serial port:%ld", (long)[error code]);
+		[weakSelf notifyDelegateOfPosixErrorCode:(int)[error code] waitUntilDone:NO];
+	};
+	writeQueue.highWaterMarkHandler = ^(BOOL aboveHighWaterMark) {
+		ORSSerialPort *strongSelf = weakSelf;
+		if (![strongSelf.delegate respondsToSelector:@selector(serialPort:writeQueueIsAboveHighWaterMark:)]) return;
+		[strongSelf performOnDelegateQueue:^{
+			[strongSelf.delegate serialPort:strongSelf writeQueueIsAboveHighWaterMark:aboveHighWaterMark];
+		} waitUntilDone:NO];
+	};
+	return writeQueue;
+}
+
 - (void)notifyDelegateOfPosixError
 {
 	[self notifyDelegateOfPosixErrorWaitingUntilDone:NO];
 }
 
 - (void)notifyDelegateOfPosixErrorWaitingUntilDone:(BOOL)shouldWait;
+{
+	[self notifyDelegateOfPosixErrorCode:errno waitUntilDone:shouldWait];
+}
+
+- (void)notifyDelegateOfPosixErrorCode:(int)code waitUntilDone:(BOOL)shouldWait
 {
 	if (![self.delegate respondsToSelector:@selector(serialPort:didEncounterError:)]) return;
 	
-	NSDictionary *errDict = @{NSLocalizedDescriptionKey: @(strerror(errno)),
+	NSDictionary *errDict = @{NSLocalizedDescriptionKey: @(strerror(code)),
 							  NSFilePathErrorKey: self.path};
 	NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain
-										 code:errno
+										 code:code
 									 userInfo:errDict];
 	
 	void (^notifyBlock)(void) = ^{
 		[self.delegate serialPort:self didEncounterError:error];
 	};
 	
-	if ([NSThread isMainThread]) {
+	if ([self isOnDelegateQueue]) {
 		notifyBlock();
-	} else if (shouldWait) {
-		dispatch_sync(dispatch_get_main_queue(), notifyBlock);
 	} else {
-		dispatch_async(dispatch_get_main_queue(), notifyBlock);
+		[self performOnDelegateQueue:notifyBlock waitUntilDone:shouldWait];
 	}
 }
 
+// Runs block on delegateQueue. When waiting, block is run right away if already on delegateQueue.
+- (void)performOnDelegateQueue:(void(^)(void))block waitUntilDone:(BOOL)shouldWait
+{
+	dispatch_queue_t queue = self.delegateQueue;
+	if (!shouldWait) {
+		dispatch_async(queue, block);
+	} else if ([self isOnDelegateQueue]) {
+		block();
+	} else {
+		dispatch_sync(queue, block);
+	}
+}
+
+- (BOOL)isOnDelegateQueue
+{
+	return dispatch_get_specific(&ORSSerialPortDelegateQueueKey) == (__bridge void *)self.delegateQueue;
+}
+
 #pragma mark - Properties
 
 + (NSSet *)keyPathsForValuesAffectingValueForKey:(NSString *)key
@@ -801,8 +1214,8 @@ static __strong NSMutableArray *allSerialPorts;
 		keyPaths = [keyPaths setByAddingObject:@"fileDescriptor"];
 	}
 	
-	if ([key isEqualToString:@"queuedRequests"]) {
-		keyPaths = [keyPaths setByAddingObject:@"requestsQueue"];
+	if ([key isEqualToString:@"pendingRequest"] || [key isEqualToString:@"pendingRequests"]) {
+		keyPaths = [keyPaths setByAddingObject:@"sentRequests"];
 	}
 	
 	return keyPaths;
@@ -810,30 +1223,81 @@ static __strong NSMutableArray *allSerialPorts;
 
 #pragma mark Port Properties
 
-- (void)insertObject:(ORSSerialRequest *)request inRequestsQueueAtIndex:(NSUInteger)index
+// The scheduler doesn't post KVO notifications itself, so queuedRequests changes are posted here
+- (void)scheduleRequest:(ORSSerialRequest *)request
+{
+	[self willChangeValueForKey:@"queuedRequests"];
+	[self.requestScheduler addRequest:request];
+	[self didChangeValueForKey:@"queuedRequests"];
+	[self.statisticsRecorder setQueuedRequestCount:self.requestScheduler.count];
+}
+
+- (void)unscheduleRequest:(ORSSerialRequest *)request
+{
+	[self willChangeValueForKey:@"queuedRequests"];
+	[self.requestScheduler removeRequest:request];
+	[self didChangeValueForKey:@"queuedRequests"];
+	[self.statisticsRecorder setQueuedRequestCount:self.requestScheduler.count];
+}
+
+- (ORSSerialRequest *)nextScheduledRequest
+{
+	if (!self.requestScheduler.count) return nil;
+	[self willChangeValueForKey:@"queuedRequests"];
+	ORSSerialRequest *request = [self.requestScheduler nextRequest];
+	[self didChangeValueForKey:@"queuedRequests"];
+	[self.statisticsRecorder setQueuedRequestCount:self.requestScheduler.count];
+	return request;
+}
+
+- (void)removeAllScheduledRequests
 {
-	[self.requestsQueue insertObject:request atIndex:index];
+	[self willChangeValueForKey:@"queuedRequests"];
+	[self.requestScheduler removeAllRequests];
+	[self didChangeValueForKey:@"queuedRequests"];
+	[self.statisticsRecorder setQueuedRequestCount:0];
 }
 
-- (void)removeObjectFromRequestsQueueAtIndex:(NSUInteger)index
+- (ORSSerialRequest *)pendingRequest
 {
-	[self.requestsQueue removeObjectAtIndex:index];
+	ORSSerialPendingRequest *pendingRequest = [self.sentRequests firstObject];
+	return pendingRequest.request;
+}
+
+- (NSArray *)pendingRequests
+{
+	return [self.sentRequests valueForKey:@"request"];
+}
+
+- (void)setMaximumPendingRequestCount:(NSUInteger)maximumPendingRequestCount
+{
+	_maximumPendingRequestCount = MAX(maximumPendingRequestCount, (NSUInteger)1);
+	
+	// Fill a larger window right away
+	dispatch_async(self.requestHandlingQueue, ^{ [self sendQueuedRequests]; });
 }
 
 - (NSArray *)queuedRequests
 {
-	return [self.requestsQueue copy];
+	return self.requestScheduler.requests;
 }
 
 + (NSSet *)keyPathsForValuesAffectingPacketDescriptors
 {
-	return [NSSet setWithObject:@"packetDescriptorsAndBuffers"];
+	return [NSSet setWithObject:@"packetDescriptorTable"];
+}
+
+- (ORSSerialPacketDescriptorTable *)packetDescriptorTable
+{
+	pthread_mutex_lock(&_packetDescriptorTableLock);
+	ORSSerialPacketDescriptorTable *result = (__bridge ORSSerialPacketDescriptorTable *)atomic_load_explicit(&_packetDescriptorTable, memory_order_relaxed);
+	pthread_mutex_unlock(&_packetDescriptorTableLock);
+	return result;
 }
 
 - (NSArray *)packetDescriptors
 {
-	NSArray *result = NSAllMapTableKeys(self.packetDescriptorsAndBuffers);
-	return result ?: @[];
+	return self.packetDescriptorTable.packetDescriptors;
 }
 
 - (BOOL)isOpen { return self.fileDescriptor != 0; }
@@ -950,6 +1414,7 @@ static __strong NSMutableArray *allSerialPorts;
 - (void)updateModemLines
 {
 	if (![self isOpen]) return;
+	if (!self.transport.supportsModemLines) return;
 
 	int bits;
 	ioctl( self.fileDescriptor, TIOCMGET, &bits ) ;
@@ -980,6 +1445,56 @@ static __strong NSMutableArray *allSerialPorts;
 	}
 }
 
+- (void)setDelegateQueue:(dispatch_queue_t)delegateQueue
+{
+	if (!delegateQueue) delegateQueue = dispatch_get_main_queue();
+	if (delegateQueue == _delegateQueue) return;
+	
+	ORS_GCD_RETAIN(delegateQueue);
+	ORS_GCD_RELEASE(_delegateQueue);
+	_delegateQueue = delegateQueue;
+	
+	// Lets -isOnDelegateQueue tell whether it's running on this queue
+	dispatch_queue_set_specific(delegateQueue, &ORSSerialPortDelegateQueueKey, (__bridge void *)delegateQueue, NULL);
+}
+
+- (void)setWriteHighWaterMark:(NSUInteger)writeHighWaterMark
+{
+	_writeHighWaterMark = writeHighWaterMark;
+	self.writeQueue.highWaterMark = writeHighWaterMark;
+}
+
+- (NSUInteger)queuedWriteLength { return self.writeQueue.queuedLength; }
+
+- (void)setWriteCoalescingInterval:(NSTimeInterval)writeCoalescingInterval
+{
+	_writeCoalescingInterval = MAX(writeCoalescingInterval, 0.0);
+	self.writeQueue.coalescingInterval = _writeCoalescingInterval;
+}
+
+- (void)setMaximumWriteBatchLength:(NSUInteger)maximumWriteBatchLength
+{
+	_maximumWriteBatchLength = MAX(maximumWriteBatchLength, (NSUInteger)1);
+	self.writeQueue.maximumBatchLength = _maximumWriteBatchLength;
+}
+
+- (NSUInteger)writeCallCount { return self.writeQueue.writeCallCount; }
+- (NSUInteger)writeCallsSavedByCoalescing { return self.writeQueue.writeCallsSaved; }
+
+- (ORSSerialPortStatistics *)statistics
+{
+	// sentRequests is atomic, and the recorder doesn't lock, so this doesn't wait for the request handling queue
+	return [self.statisticsRecorder snapshotWithPendingRequestCount:[self.sentRequests count]];
+}
+
+- (void)setMaximumReadLength:(NSUInteger)maximumReadLength
+{
+	_maximumReadLength = MAX(maximumReadLength, (NSUInteger)1);
+	
+	// Room for several reads per slab
+	self.readSlabPool.slabLength = MAX(_maximumReadLength * 4, ORSSerialPortDefaultMaximumReadLength);
+}
+
 #pragma mark Private Properties
 
 - (void)setReadPollSource:(dispatch_source_t)readPollSource
@@ -995,34 +1510,6 @@ static __strong NSMutableArray *allSerialPorts;
 	}
 }
 
-- (void)setPinPollTimer:(dispatch_source_t)timer
-{
-	if (timer != _pinPollTimer)
-	{
-		if (_pinPollTimer)
-		{
-			dispatch_source_cancel(_pinPollTimer);
-			ORS_GCD_RELEASE(_pinPollTimer);
-		}
-		
-		ORS_GCD_RETAIN(timer);
-		_pinPollTimer = timer;
-	}
-}
-
-- (void)setPendingRequestTimeoutTimer:(dispatch_source_t)pendingRequestTimeoutTimer
-{
-	if (pendingRequestTimeoutTimer != _pendingRequestTimeoutTimer) {
-		if (_pendingRequestTimeoutTimer) {
-			dispatch_source_cancel(_pendingRequestTimeoutTimer);
-			ORS_GCD_RELEASE(_pendingRequestTimeoutTimer);
-		}
-		
-		ORS_GCD_RETAIN(pendingRequestTimeoutTimer);
-		_pendingRequestTimeoutTimer = pendingRequestTimeoutTimer;
-	}
-}
-
 - (void)setRequestHandlingQueue:(dispatch_queue_t)requestHandlingQueue
 {
 	if (requestHandlingQueue != _requestHandlingQueue)
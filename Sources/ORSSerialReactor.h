@@ -0,0 +1,28 @@
+//
+//  ORSSerialReactor.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ *  Private class holding the small, fixed set of serial queues shared by ports whose
+ *  usesSharedReactor property is YES.
+ *
+ *  A port using the reactor has its read and write dispatch sources and its request handling
+ *  queue target one of these queues, so hundreds of ports are served by a handful of threads
+ *  instead of each port's events being spread over their own queues. Dispatch sources are
+ *  backed by kqueue, so readiness for all of them is still multiplexed by the kernel.
+ */
+@interface ORSSerialReactor : NSObject
+
++ (instancetype)sharedReactor;
+
+// Hands out the queues in turn, so ports are spread evenly between them
+- (dispatch_queue_t)nextQueue;
+
+@property (nonatomic, readonly) NSUInteger queueCount;
+
+@end
@@ -0,0 +1,58 @@
+//
+//  ORSSerialReactor.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialReactor.h"
+#import <stdatomic.h>
+
+enum { ORSSerialReactorMaximumQueueCount = 4 };
+
+@interface ORSSerialReactor ()
+{
+	dispatch_queue_t _queues[ORSSerialReactorMaximumQueueCount];
+	NSUInteger _queueCount;
+	atomic_uint_fast32_t _nextQueueIndex;
+}
+
+@end
+
+@implementation ORSSerialReactor
+
++ (instancetype)sharedReactor
+{
+	static ORSSerialReactor *sharedReactor = nil;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		sharedReactor = [[self alloc] init];
+	});
+	return sharedReactor;
+}
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		// One queue per core, up to a few. Serial I/O doesn't need more than that.
+		_queueCount = MAX(MIN([[NSProcessInfo processInfo] activeProcessorCount], (NSUInteger)ORSSerialReactorMaximumQueueCount), (NSUInteger)1);
+		for (NSUInteger i = 0; i < _queueCount; i++) {
+			NSString *label = [NSString stringWithFormat:@"com.openreelsoftware.ORSSerialPort.reactor.%lu", (unsigned long)i];
+			_queues[i] = dispatch_queue_create([label UTF8String], 0);
+			dispatch_set_target_queue(_queues[i], dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0));
+		}
+		atomic_init(&_nextQueueIndex, 0);
+	}
+	return self;
+}
+
+- (dispatch_queue_t)nextQueue
+{
+	NSUInteger index = atomic_fetch_add(&_nextQueueIndex, 1) % _queueCount;
+	return _queues[index];
+}
+
+- (NSUInteger)queueCount { return _queueCount; }
+
+@end
@@ -0,0 +1,39 @@
+//
+//  ORSSerialReadSlabPool.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Hands out memory for reads from large, reusable slabs, and wraps what was read in NSData
+ *  without copying it.
+ *
+ *  Consecutive reads are packed into the same slab. A slab goes back to the pool once it's
+ *  full and every NSData carved out of it has been deallocated, so steady-state reading does
+ *  no allocation other than the NSData objects themselves.
+ *
+ *  -reserveBytes: and -dataByCommittingBytes: must only be called from one thread at a time.
+ *  The returned data objects may be released on any thread.
+ */
+@interface ORSSerialReadSlabPool : NSObject
+
+- (instancetype)initWithSlabLength:(NSUInteger)slabLength NS_DESIGNATED_INITIALIZER;
+
+// Returns space for at least length bytes, valid until the next call to either method.
+- (uint8_t *)reserveBytes:(NSUInteger)length;
+
+// Wraps the first length bytes of the last reservation, which must not be longer than was reserved.
+- (NSData *)dataByCommittingBytes:(NSUInteger)length;
+
+// Only affects slabs allocated from now on.
+@property (nonatomic) NSUInteger slabLength;
+
+@end
@@ -0,0 +1,134 @@
+//
+//  ORSSerialReadSlabPool.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialReadSlabPool.h"
+#import <pthread.h>
+#import <stdatomic.h>
+
+static const NSUInteger ORSSerialReadSlabPoolMaximumFreeSlabs = 4;
+
+typedef struct ORSSerialReadSlab {
+	struct ORSSerialReadSlab *next; // Next free slab
+	atomic_long references; // One per outstanding NSData, plus one while it's the pool's current slab
+	NSUInteger length;
+	uint8_t bytes[];
+} ORSSerialReadSlab;
+
+@interface ORSSerialReadSlabPool ()
+{
+	ORSSerialReadSlab *_currentSlab;
+	NSUInteger _currentOffset;
+	NSUInteger _reservedLength;
+
+	pthread_mutex_t _freeSlabsLock;
+	ORSSerialReadSlab *_freeSlabs;
+	NSUInteger _freeSlabsCount;
+}
+
+@end
+
+@implementation ORSSerialReadSlabPool
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[ORSSerialReadSlabPool initWithSlabLength:]"];
+	return nil;
+}
+
+- (instancetype)initWithSlabLength:(NSUInteger)slabLength
+{
+	self = [super init];
+	if (self) {
+		_slabLength = slabLength;
+		pthread_mutex_init(&_freeSlabsLock, NULL);
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	// Outstanding data objects keep the pool alive, so the current slab is the only one still referenced
+	if (_currentSlab) free(_currentSlab);
+	while (_freeSlabs) {
+		ORSSerialReadSlab *slab = _freeSlabs;
+		_freeSlabs = slab->next;
+		free(slab);
+	}
+	pthread_mutex_destroy(&_freeSlabsLock);
+}
+
+- (uint8_t *)reserveBytes:(NSUInteger)length
+{
+	if (!_currentSlab || _currentSlab->length - _currentOffset < length) {
+		[self releaseSlab:_currentSlab];
+		_currentSlab = [self slabWithLength:MAX(length, self.slabLength)];
+		_currentOffset = 0;
+	}
+	_reservedLength = length;
+	return _currentSlab->bytes + _currentOffset;
+}
+
+- (NSData *)dataByCommittingBytes:(NSUInteger)length
+{
+	if (length > _reservedLength) {
+		[NSException raise:NSInvalidArgumentException format:@"Committed %lu bytes, but only %lu were reserved", (unsigned long)length, (unsigned long)_reservedLength];
+	}
+	_reservedLength = 0;
+	if (!length) return [NSData data];
+
+	ORSSerialReadSlab *slab = _currentSlab;
+	uint8_t *bytes = slab->bytes + _currentOffset;
+	_currentOffset += length;
+	atomic_fetch_add(&slab->references, 1);
+
+	// The deallocator keeps the pool alive until every slab has come back
+	return [[NSData alloc] initWithBytesNoCopy:bytes length:length deallocator:^(void *b, NSUInteger l) {
+		[self releaseSlab:slab];
+	}];
+}
+
+#pragma mark - Private
+
+- (ORSSerialReadSlab *)slabWithLength:(NSUInteger)length
+{
+	ORSSerialReadSlab *slab = NULL;
+	pthread_mutex_lock(&_freeSlabsLock);
+	if (_freeSlabs && _freeSlabs->length >= length) {
+		slab = _freeSlabs;
+		_freeSlabs = slab->next;
+		_freeSlabsCount--;
+	}
+	pthread_mutex_unlock(&_freeSlabsLock);
+
+	if (!slab) {
+		slab = malloc(sizeof(ORSSerialReadSlab) + length);
+		if (!slab) [NSException raise:NSMallocException format:@"Unable to allocate %lu byte read slab", (unsigned long)length];
+		slab->length = length;
+	}
+	slab->next = NULL;
+	atomic_init(&slab->references, 1);
+	return slab;
+}
+
+- (void)releaseSlab:(ORSSerialReadSlab *)slab
+{
+	if (!slab || atomic_fetch_sub(&slab->references, 1) != 1) return;
+
+	// Slabs made for the previous slab length aren't worth keeping
+	BOOL keep = NO;
+	pthread_mutex_lock(&_freeSlabsLock);
+	if (_freeSlabsCount < ORSSerialReadSlabPoolMaximumFreeSlabs && slab->length == self.slabLength) {
+		slab->next = _freeSlabs;
+		_freeSlabs = slab;
+		_freeSlabsCount++;
+		keep = YES;
+	}
+	pthread_mutex_unlock(&_freeSlabsLock);
+	if (!keep) free(slab);
+}
+
+@end
@@ -0,0 +1,41 @@
+//
+//  ORSSerialRegexPacketMatcher.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialPacketMatcher.h"
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+/**
+ *  Matcher for descriptors created with -initWithRegularExpression:maximumPacketLength:userInfo:.
+ *
+ *  The descriptor's evaluator decodes every window at the end of the buffer into a string and runs
+ *  the regular expression on it, for every window length, after every byte. Instead, this matcher
+ *  compiles the pattern into a position (Glushkov) automaton over bytes and runs it forward as a
+ *  lazily built DFA, so each byte costs one table lookup. When the DFA reaches an accepting state,
+ *  the automaton is run backwards over the window to find where the shortest packet starts.
+ *
+ *  Only a subset of ICU syntax is compiled: ASCII literals and escapes, `.`, character classes,
+ *  `\d \w \s` and their negations, groups, alternation, and greedy or lazy quantifiers, with an
+ *  optional leading `^`, and no options other than those affecting `.`. Patterns using anything
+ *  else, or that match the empty string, make -initWithPacketDescriptor: return nil so the
+ *  evaluator is used instead. So do descriptors with a checksum.
+ *
+ *  The DFA only matches ASCII. If the pattern can match other characters (e.g. with `.` or `\w`),
+ *  windows containing non-ASCII bytes are passed to the descriptor's evaluator, so packets found are
+ *  exactly those the evaluator would find.
+ */
+@interface ORSSerialRegexPacketMatcher : ORSSerialPacketMatcher
+
+// Returns nil if the descriptor's regular expression can't be compiled.
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor NS_DESIGNATED_INITIALIZER;
+
+@property (nonatomic, strong, readonly) ORSSerialPacketDescriptor *descriptor;
+
+@end
@@ -0,0 +1,799 @@
+//
+//  ORSSerialRegexPacketMatcher.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialRegexPacketMatcher.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import "ORSSerialBuffer.h"
+#import "ORSSerialStatistics.h"
+
+enum {
+	ORSSerialRegexMaximumPositions = 256, // Character sets in the pattern, after expanding counted repetitions
+	ORSSerialRegexMaximumNodes = 4096,
+	ORSSerialRegexMaximumStates = 1024, // Cached DFA states. The cache is flushed when it fills up.
+	ORSSerialRegexSetWords = ORSSerialRegexMaximumPositions / 64,
+	ORSSerialRegexStateTableSize = ORSSerialRegexMaximumStates * 2,
+};
+
+#pragma mark - Position Sets
+
+typedef struct {
+	uint64_t words[ORSSerialRegexSetWords];
+} ORSSerialRegexSet;
+
+static inline void ORSSerialRegexSetAdd(ORSSerialRegexSet *set, NSUInteger position)
+{
+	set->words[position / 64] |= (uint64_t)1 << (position % 64);
+}
+
+static inline void ORSSerialRegexSetUnion(ORSSerialRegexSet *set, const ORSSerialRegexSet *other)
+{
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) set->words[i] |= other->words[i];
+}
+
+static inline void ORSSerialRegexSetIntersect(ORSSerialRegexSet *set, const ORSSerialRegexSet *other)
+{
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) set->words[i] &= other->words[i];
+}
+
+static inline BOOL ORSSerialRegexSetIntersects(const ORSSerialRegexSet *set, const ORSSerialRegexSet *other)
+{
+	uint64_t common = 0;
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) common |= set->words[i] & other->words[i];
+	return common != 0;
+}
+
+static inline BOOL ORSSerialRegexSetIsEmpty(const ORSSerialRegexSet *set)
+{
+	uint64_t any = 0;
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) any |= set->words[i];
+	return any == 0;
+}
+
+// Sets result to the union of sets[i] for each position i in set
+static inline void ORSSerialRegexSetUnionOfSets(ORSSerialRegexSet *result, const ORSSerialRegexSet *set, const ORSSerialRegexSet *sets)
+{
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) {
+		for (uint64_t bits = set->words[i]; bits; bits &= bits - 1) {
+			ORSSerialRegexSetUnion(result, &sets[i * 64 + (NSUInteger)__builtin_ctzll(bits)]);
+		}
+	}
+}
+
+#pragma mark - Parsing
+
+// The characters matched by a character class. Only ASCII characters are tracked individually.
+typedef struct {
+	uint64_t ascii[2];
+	BOOL nonASCII; // May match characters outside ASCII
+} ORSSerialRegexCharacters;
+
+static inline void ORSSerialRegexCharactersAdd(ORSSerialRegexCharacters *characters, int character)
+{
+	characters->ascii[character / 64] |= (uint64_t)1 << (character % 64);
+}
+
+static inline BOOL ORSSerialRegexCharactersContains(const ORSSerialRegexCharacters *characters, int character)
+{
+	return character < 128 && (characters->ascii[character / 64] >> (character % 64)) & 1;
+}
+
+static void ORSSerialRegexCharactersAddRange(ORSSerialRegexCharacters *characters, int first, int last)
+{
+	for (int c=first; c<=last; c++) ORSSerialRegexCharactersAdd(characters, c);
+}
+
+static void ORSSerialRegexCharactersInvert(ORSSerialRegexCharacters *characters)
+{
+	characters->ascii[0] = ~characters->ascii[0];
+	characters->ascii[1] = ~characters->ascii[1];
+	characters->nonASCII = YES;
+}
+
+typedef enum {
+	ORSSerialRegexNodeEmpty,
+	ORSSerialRegexNodeCharacters,
+	ORSSerialRegexNodeConcatenation,
+	ORSSerialRegexNodeAlternation,
+	ORSSerialRegexNodeStar,
+	ORSSerialRegexNodePlus,
+	ORSSerialRegexNodeOptional,
+} ORSSerialRegexNodeKind;
+
+typedef struct {
+	ORSSerialRegexNodeKind kind;
+	NSInteger left; // Operand of repetitions
+	NSInteger right;
+	ORSSerialRegexCharacters characters;
+} ORSSerialRegexNode;
+
+// Parse functions return the index of the parsed node, or -1 if the pattern isn't supported
+typedef struct {
+	const char *pattern;
+	NSUInteger length;
+	NSUInteger index;
+	NSRegularExpressionOptions options;
+	ORSSerialRegexNode *nodes;
+	NSUInteger nodeCount;
+	NSUInteger nodeCapacity;
+} ORSSerialRegexParser;
+
+static NSInteger ORSSerialRegexParseAlternation(ORSSerialRegexParser *parser);
+
+static inline int ORSSerialRegexPeek(ORSSerialRegexParser *parser)
+{
+	return parser->index < parser->length ? parser->pattern[parser->index] : -1;
+}
+
+static NSInteger ORSSerialRegexAddNode(ORSSerialRegexParser *parser, ORSSerialRegexNodeKind kind, NSInteger left, NSInteger right, const ORSSerialRegexCharacters *characters)
+{
+	if (parser->nodeCount == ORSSerialRegexMaximumNodes) return -1;
+	if (parser->nodeCount == parser->nodeCapacity) {
+		parser->nodeCapacity = MAX(parser->nodeCapacity * 2, (NSUInteger)32);
+		parser->nodes = reallocf(parser->nodes, parser->nodeCapacity * sizeof(ORSSerialRegexNode));
+		if (!parser->nodes) return -1;
+	}
+	ORSSerialRegexNode *node = &parser->nodes[parser->nodeCount];
+	node->kind = kind;
+	node->left = left;
+	node->right = right;
+	if (characters) {
+		node->characters = *characters;
+	} else {
+		memset(&node->characters, 0, sizeof(node->characters));
+	}
+	return (NSInteger)parser->nodeCount++;
+}
+
+static NSInteger ORSSerialRegexCopyNode(ORSSerialRegexParser *parser, NSInteger index)
+{
+	ORSSerialRegexNode node = parser->nodes[index]; // Not a pointer, because adding nodes may move them
+	NSInteger left = -1, right = -1;
+	switch (node.kind) {
+		case ORSSerialRegexNodeEmpty:
+		case ORSSerialRegexNodeCharacters:
+			return ORSSerialRegexAddNode(parser, node.kind, -1, -1, &node.characters);
+		case ORSSerialRegexNodeConcatenation:
+		case ORSSerialRegexNodeAlternation:
+			left = ORSSerialRegexCopyNode(parser, node.left);
+			right = ORSSerialRegexCopyNode(parser, node.right);
+			if (left < 0 || right < 0) return -1;
+			return ORSSerialRegexAddNode(parser, node.kind, left, right, NULL);
+		default:
+			left = ORSSerialRegexCopyNode(parser, node.left);
+			if (left < 0) return -1;
+			return ORSSerialRegexAddNode(parser, node.kind, left, -1, NULL);
+	}
+}
+
+static int ORSSerialRegexHexValue(int c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+// Parses the escape after a backslash. single is set to the escaped character, or -1 for
+// escapes like \d that match more than one character.
+static BOOL ORSSerialRegexParseEscape(ORSSerialRegexParser *parser, ORSSerialRegexCharacters *characters, int *single)
+{
+	int c = ORSSerialRegexPeek(parser);
+	if (c < 0) return NO;
+	parser->index++;
+	*single = -1;
+
+	// ICU's classes are Unicode-aware, so they may match non-ASCII characters
+	switch (c) {
+		case 'd':
+		case 'D':
+			ORSSerialRegexCharactersAddRange(characters, '0', '9');
+			characters->nonASCII = YES;
+			if (c == 'D') ORSSerialRegexCharactersInvert(characters);
+			return YES;
+		case 'w':
+		case 'W':
+			ORSSerialRegexCharactersAddRange(characters, 'a', 'z');
+			ORSSerialRegexCharactersAddRange(characters, 'A', 'Z');
+			ORSSerialRegexCharactersAddRange(characters, '0', '9');
+			ORSSerialRegexCharactersAdd(characters, '_');
+			characters->nonASCII = YES;
+			if (c == 'W') ORSSerialRegexCharactersInvert(characters);
+			return YES;
+		case 's':
+		case 'S':
+			ORSSerialRegexCharactersAddRange(characters, '\t', '\r'); // \s is \p{WhiteSpace}
+			ORSSerialRegexCharactersAdd(characters, ' ');
+			characters->nonASCII = YES;
+			if (c == 'S') ORSSerialRegexCharactersInvert(characters);
+			return YES;
+		case 't': *single = '\t'; break;
+		case 'n': *single = '\n'; break;
+		case 'r': *single = '\r'; break;
+		case 'f': *single = '\f'; break;
+		case 'a': *single = 0x07; break;
+		case 'e': *single = 0x1B; break;
+		case 'x': {
+			if (parser->index + 2 > parser->length) return NO;
+			int high = ORSSerialRegexHexValue(parser->pattern[parser->index]);
+			int low = ORSSerialRegexHexValue(parser->pattern[parser->index + 1]);
+			if (high < 0 || low < 0 || high > 7) return NO;
+			parser->index += 2;
+			*single = high * 16 + low;
+			break;
+		}
+		default:
+			// Anchors, back references, properties, octal and Unicode escapes aren't supported.
+			// Anything else escapes a literal character.
+			if (isalnum(c)) return NO;
+			*single = c;
+			break;
+	}
+	ORSSerialRegexCharactersAdd(characters, *single);
+	return YES;
+}
+
+// Parses a set after its opening bracket
+static BOOL ORSSerialRegexParseSet(ORSSerialRegexParser *parser, ORSSerialRegexCharacters *characters)
+{
+	BOOL negated = NO;
+	if (ORSSerialRegexPeek(parser) == '^') {
+		negated = YES;
+		parser->index++;
+	}
+	if (ORSSerialRegexPeek(parser) == ']') return NO;
+
+	BOOL first = YES;
+	int previous = -1; // The last single character, which may start a range
+	while (YES) {
+		int c = ORSSerialRegexPeek(parser);
+		if (c < 0 || c == '[') return NO; // Nested sets and POSIX classes aren't supported
+		parser->index++;
+		if (c == ']') break;
+
+		int single = c;
+		if (c == '\\') {
+			ORSSerialRegexCharacters escaped = {{0, 0}, NO};
+			if (!ORSSerialRegexParseEscape(parser, &escaped, &single)) return NO;
+			characters->ascii[0] |= escaped.ascii[0];
+			characters->ascii[1] |= escaped.ascii[1];
+			characters->nonASCII |= escaped.nonASCII;
+		} else if (c == '&' && ORSSerialRegexPeek(parser) == '&') {
+			return NO; // Set intersection
+		} else if (c == '-' && !first && ORSSerialRegexPeek(parser) != ']') {
+			int last = ORSSerialRegexPeek(parser);
+			if (previous < 0 || last < 0 || last == '[') return NO;
+			parser->index++;
+			if (last == '\\') {
+				ORSSerialRegexCharacters escaped = {{0, 0}, NO};
+				if (!ORSSerialRegexParseEscape(parser, &escaped, &last) || last < 0) return NO;
+			}
+			if (last < previous) return NO;
+			ORSSerialRegexCharactersAddRange(characters, previous, last);
+			single = -1;
+		} else {
+			ORSSerialRegexCharactersAdd(characters, c);
+		}
+		previous = single;
+		first = NO;
+	}
+	if (negated) ORSSerialRegexCharactersInvert(characters);
+	return YES;
+}
+
+static BOOL ORSSerialRegexParseDigits(ORSSerialRegexParser *parser, NSUInteger *value)
+{
+	NSUInteger start = parser->index;
+	*value = 0;
+	while (isdigit(ORSSerialRegexPeek(parser))) {
+		if (parser->index - start == 4) return NO;
+		*value = *value * 10 + (NSUInteger)(parser->pattern[parser->index++] - '0');
+	}
+	return parser->index > start;
+}
+
+// Parses {n}, {n,} or {n,m} after the opening brace. maximum is NSNotFound if unbounded.
+static BOOL ORSSerialRegexParseInterval(ORSSerialRegexParser *parser, NSUInteger *minimum, NSUInteger *maximum)
+{
+	if (!ORSSerialRegexParseDigits(parser, minimum)) return NO;
+	*maximum = *minimum;
+	if (ORSSerialRegexPeek(parser) == ',') {
+		parser->index++;
+		if (!ORSSerialRegexParseDigits(parser, maximum)) *maximum = NSNotFound;
+	}
+	if (ORSSerialRegexPeek(parser) != '}') return NO;
+	parser->index++;
+	return *maximum >= *minimum;
+}
+
+static NSInteger ORSSerialRegexParseAtom(ORSSerialRegexParser *parser)
+{
+	ORSSerialRegexCharacters characters = {{0, 0}, NO};
+	int c = ORSSerialRegexPeek(parser);
+	parser->index++;
+	switch (c) {
+		case '(': {
+			if (ORSSerialRegexPeek(parser) == '?') {
+				parser->index++;
+				if (ORSSerialRegexPeek(parser) == '<' && isalpha(parser->index + 1 < parser->length ? parser->pattern[parser->index + 1] : 0)) {
+					// Named capture group
+					parser->index++;
+					while (isalnum(ORSSerialRegexPeek(parser))) parser->index++;
+					if (ORSSerialRegexPeek(parser) != '>') return -1;
+				} else if (ORSSerialRegexPeek(parser) != ':') {
+					return -1; // Lookaround, atomic groups, flags and comments
+				}
+				parser->index++;
+			}
+			NSInteger group = ORSSerialRegexParseAlternation(parser);
+			if (group < 0 || ORSSerialRegexPeek(parser) != ')') return -1;
+			parser->index++;
+			return group;
+		}
+		case '[':
+			if (!ORSSerialRegexParseSet(parser, &characters)) return -1;
+			break;
+		case '.':
+			ORSSerialRegexCharactersInvert(&characters);
+			if (!(parser->options & NSRegularExpressionDotMatchesLineSeparators)) {
+				if (parser->options & NSRegularExpressionUseUnixLineSeparators) {
+					characters.ascii[0] &= ~((uint64_t)1 << '\n');
+				} else {
+					characters.ascii[0] &= ~(uint64_t)0x3C00; // \n, \v, \f and \r
+				}
+			}
+			break;
+		case '\\': {
+			int single;
+			if (!ORSSerialRegexParseEscape(parser, &characters, &single)) return -1;
+			break;
+		}
+		case '^': case '$': case '|': case ')': case '*': case '+': case '?': case '{': case '}': case ']':
+			return -1;
+		default:
+			ORSSerialRegexCharactersAdd(&characters, c);
+			break;
+	}
+	return ORSSerialRegexAddNode(parser, ORSSerialRegexNodeCharacters, -1, -1, &characters);
+}
+
+static NSInteger ORSSerialRegexRepeat(ORSSerialRegexParser *parser, NSInteger atom, NSUInteger minimum, NSUInteger maximum)
+{
+	if (minimum == 0 && maximum == NSNotFound) return ORSSerialRegexAddNode(parser, ORSSerialRegexNodeStar, atom, -1, NULL);
+	if (minimum == 0 && maximum == 1) return ORSSerialRegexAddNode(parser, ORSSerialRegexNodeOptional, atom, -1, NULL);
+
+	// x{2,4} is expanded to xxx?x?, and x{2,} to xx+
+	NSUInteger count = (maximum == NSNotFound) ? minimum : maximum;
+	if (count > ORSSerialRegexMaximumPositions) return -1;
+	NSInteger result = -1;
+	for (NSUInteger i=0; i<count; i++) {
+		NSInteger item = i ? ORSSerialRegexCopyNode(parser, atom) : atom;
+		if (item >= 0 && maximum == NSNotFound && i == count - 1) {
+			item = ORSSerialRegexAddNode(parser, ORSSerialRegexNodePlus, item, -1, NULL);
+		} else if (item >= 0 && i >= minimum) {
+			item = ORSSerialRegexAddNode(parser, ORSSerialRegexNodeOptional, item, -1, NULL);
+		}
+		if (item < 0) return -1;
+		result = (result < 0) ? item : ORSSerialRegexAddNode(parser, ORSSerialRegexNodeConcatenation, result, item, NULL);
+		if (result < 0) return -1;
+	}
+	return (result < 0) ? ORSSerialRegexAddNode(parser, ORSSerialRegexNodeEmpty, -1, -1, NULL) : result;
+}
+
+static NSInteger ORSSerialRegexParseRepetition(ORSSerialRegexParser *parser)
+{
+	NSInteger atom = ORSSerialRegexParseAtom(parser);
+	if (atom < 0) return -1;
+
+	NSUInteger minimum, maximum;
+	switch (ORSSerialRegexPeek(parser)) {
+		case '*': minimum = 0; maximum = NSNotFound; parser->index++; break;
+		case '+': minimum = 1; maximum = NSNotFound; parser->index++; break;
+		case '?': minimum = 0; maximum = 1; parser->index++; break;
+		case '{':
+			parser->index++;
+			if (!ORSSerialRegexParseInterval(parser, &minimum, &maximum)) return -1;
+			break;
+		default:
+			return atom;
+	}
+
+	// Lazy quantifiers find a packet wherever greedy ones do. Possessive ones don't.
+	if (ORSSerialRegexPeek(parser) == '?') parser->index++;
+	int next = ORSSerialRegexPeek(parser);
+	if (next == '*' || next == '+' || next == '?' || next == '{') return -1;
+
+	return ORSSerialRegexRepeat(parser, atom, minimum, maximum);
+}
+
+static NSInteger ORSSerialRegexParseConcatenation(ORSSerialRegexParser *parser)
+{
+	NSInteger result = -1;
+	for (int c = ORSSerialRegexPeek(parser); c >= 0 && c != '|' && c != ')'; c = ORSSerialRegexPeek(parser)) {
+		NSInteger item = ORSSerialRegexParseRepetition(parser);
+		if (item < 0) return -1;
+		result = (result < 0) ? item : ORSSerialRegexAddNode(parser, ORSSerialRegexNodeConcatenation, result, item, NULL);
+		if (result < 0) return -1;
+	}
+	return (result < 0) ? ORSSerialRegexAddNode(parser, ORSSerialRegexNodeEmpty, -1, -1, NULL) : result;
+}
+
+static NSInteger ORSSerialRegexParseAlternation(ORSSerialRegexParser *parser)
+{
+	NSInteger result = ORSSerialRegexParseConcatenation(parser);
+	while (result >= 0 && ORSSerialRegexPeek(parser) == '|') {
+		parser->index++;
+		NSInteger right = ORSSerialRegexParseConcatenation(parser);
+		if (right < 0) return -1;
+		result = ORSSerialRegexAddNode(parser, ORSSerialRegexNodeAlternation, result, right, NULL);
+	}
+	return result;
+}
+
+#pragma mark - Position Automaton
+
+// Each character class in the pattern is a position. A packet matches if its bytes can be matched by
+// a sequence of positions starting with one in first, ending with one in last, where each position
+// is in the follow set of the one before.
+typedef struct {
+	NSUInteger positionCount;
+	ORSSerialRegexCharacters *characters;
+	ORSSerialRegexSet first;
+	ORSSerialRegexSet last;
+	ORSSerialRegexSet *follow;
+	ORSSerialRegexSet *precede; // precede[i] holds the positions whose follow sets contain i
+	uint8_t byteClasses[256]; // Bytes in the same class are matched by the same positions
+	NSUInteger byteClassCount;
+	ORSSerialRegexSet *byteClassPositions;
+	BOOL canMatchNonASCII;
+} ORSSerialRegexProgram;
+
+typedef struct {
+	BOOL nullable;
+	ORSSerialRegexSet first;
+	ORSSerialRegexSet last;
+} ORSSerialRegexSummary;
+
+static BOOL ORSSerialRegexBuild(ORSSerialRegexProgram *program, const ORSSerialRegexNode *nodes, NSInteger index, ORSSerialRegexSummary *summary)
+{
+	const ORSSerialRegexNode *node = &nodes[index];
+	memset(summary, 0, sizeof(*summary));
+	ORSSerialRegexSummary left, right;
+	switch (node->kind) {
+		case ORSSerialRegexNodeEmpty:
+			summary->nullable = YES;
+			return YES;
+		case ORSSerialRegexNodeCharacters: {
+			if (program->positionCount == ORSSerialRegexMaximumPositions) return NO;
+			NSUInteger position = program->positionCount++;
+			program->characters[position] = node->characters;
+			ORSSerialRegexSetAdd(&summary->first, position);
+			ORSSerialRegexSetAdd(&summary->last, position);
+			return YES;
+		}
+		case ORSSerialRegexNodeConcatenation:
+			if (!ORSSerialRegexBuild(program, nodes, node->left, &left) || !ORSSerialRegexBuild(program, nodes, node->right, &right)) return NO;
+			for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) {
+				for (uint64_t bits = left.last.words[i]; bits; bits &= bits - 1) {
+					ORSSerialRegexSetUnion(&program->follow[i * 64 + (NSUInteger)__builtin_ctzll(bits)], &right.first);
+				}
+			}
+			summary->nullable = left.nullable && right.nullable;
+			summary->first = left.first;
+			if (left.nullable) ORSSerialRegexSetUnion(&summary->first, &right.first);
+			summary->last = right.last;
+			if (right.nullable) ORSSerialRegexSetUnion(&summary->last, &left.last);
+			return YES;
+		case ORSSerialRegexNodeAlternation:
+			if (!ORSSerialRegexBuild(program, nodes, node->left, &left) || !ORSSerialRegexBuild(program, nodes, node->right, &right)) return NO;
+			summary->nullable = left.nullable || right.nullable;
+			summary->first = left.first;
+			ORSSerialRegexSetUnion(&summary->first, &right.first);
+			summary->last = left.last;
+			ORSSerialRegexSetUnion(&summary->last, &right.last);
+			return YES;
+		case ORSSerialRegexNodeStar:
+		case ORSSerialRegexNodePlus:
+		case ORSSerialRegexNodeOptional:
+			if (!ORSSerialRegexBuild(program, nodes, node->left, summary)) return NO;
+			if (node->kind != ORSSerialRegexNodePlus) summary->nullable = YES;
+			if (node->kind == ORSSerialRegexNodeOptional) return YES;
+			for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) {
+				for (uint64_t bits = summary->last.words[i]; bits; bits &= bits - 1) {
+					ORSSerialRegexSetUnion(&program->follow[i * 64 + (NSUInteger)__builtin_ctzll(bits)], &summary->first);
+				}
+			}
+			return YES;
+	}
+	return NO;
+}
+
+static void ORSSerialRegexProgramFree(ORSSerialRegexProgram *program)
+{
+	free(program->characters);
+	free(program->follow);
+	free(program->precede);
+	free(program->byteClassPositions);
+}
+
+// Returns NO if the pattern uses anything the automaton can't match exactly as NSRegularExpression
+// would. program must be freed either way.
+static BOOL ORSSerialRegexProgramInit(ORSSerialRegexProgram *program, const char *pattern, NSUInteger length, NSRegularExpressionOptions options)
+{
+	memset(program, 0, sizeof(*program));
+	NSRegularExpressionOptions supportedOptions = NSRegularExpressionDotMatchesLineSeparators |
+												  NSRegularExpressionAnchorsMatchLines |
+												  NSRegularExpressionUseUnixLineSeparators |
+												  NSRegularExpressionUseUnicodeWordBoundaries;
+	if (options & ~supportedOptions) return NO;
+
+	ORSSerialRegexParser parser = {
+		.pattern = pattern,
+		.length = length,
+		.options = options,
+	};
+	if (ORSSerialRegexPeek(&parser) == '^') parser.index++; // Windows are always matched from their start
+	NSInteger root = ORSSerialRegexParseAlternation(&parser);
+	BOOL supported = (root >= 0 && parser.index == parser.length);
+
+	ORSSerialRegexSummary summary;
+	if (supported) {
+		program->characters = calloc(ORSSerialRegexMaximumPositions, sizeof(ORSSerialRegexCharacters));
+		program->follow = calloc(ORSSerialRegexMaximumPositions, sizeof(ORSSerialRegexSet));
+		supported = ORSSerialRegexBuild(program, parser.nodes, root, &summary);
+	}
+	free(parser.nodes);
+
+	// A pattern matching the empty string matches a window of any length, including one that ends
+	// in the middle of a UTF-8 sequence, so leave it to the evaluator
+	if (!supported || summary.nullable) return NO;
+	program->first = summary.first;
+	program->last = summary.last;
+
+	program->precede = calloc(program->positionCount, sizeof(ORSSerialRegexSet));
+	for (NSUInteger i=0; i<program->positionCount; i++) {
+		program->canMatchNonASCII |= program->characters[i].nonASCII;
+		for (NSUInteger j=0; j<program->positionCount; j++) {
+			if ((program->follow[i].words[j / 64] >> (j % 64)) & 1) ORSSerialRegexSetAdd(&program->precede[j], i);
+		}
+	}
+
+	// Group bytes matched by exactly the same positions, to keep the DFA's transition table small.
+	// Non-ASCII bytes aren't matched by any position.
+	program->byteClassPositions = calloc(129, sizeof(ORSSerialRegexSet));
+	program->byteClassCount = 1; // Class 0 is matched by nothing
+	for (int byte=0; byte<256; byte++) {
+		ORSSerialRegexSet positions = {{0}};
+		for (NSUInteger i=0; i<program->positionCount; i++) {
+			if (ORSSerialRegexCharactersContains(&program->characters[i], byte)) ORSSerialRegexSetAdd(&positions, i);
+		}
+		NSUInteger byteClass = 0;
+		while (byteClass < program->byteClassCount && memcmp(&program->byteClassPositions[byteClass], &positions, sizeof(positions))) byteClass++;
+		if (byteClass == program->byteClassCount) program->byteClassPositions[program->byteClassCount++] = positions;
+		program->byteClasses[byte] = (uint8_t)byteClass;
+	}
+	return YES;
+}
+
+#pragma mark - Lazy DFA
+
+// DFA states are sets of positions that matched the last byte, for windows starting anywhere since the
+// last packet. States and transitions are only computed when first needed.
+typedef struct {
+	ORSSerialRegexSet *states;
+	BOOL *accepting;
+	int32_t *transitions; // transitions[state * byteClassCount + byteClass], or -1 if not computed yet
+	NSUInteger count;
+	NSUInteger capacity;
+	int32_t table[ORSSerialRegexStateTableSize]; // Hash table of state indexes, -1 if empty
+} ORSSerialRegexDFA;
+
+static void ORSSerialRegexDFAFlush(ORSSerialRegexDFA *dfa)
+{
+	dfa->count = 0;
+	memset(dfa->table, 0xFF, sizeof(dfa->table));
+}
+
+static void ORSSerialRegexDFAFree(ORSSerialRegexDFA *dfa)
+{
+	free(dfa->states);
+	free(dfa->accepting);
+	free(dfa->transitions);
+}
+
+static inline NSUInteger ORSSerialRegexSetHash(const ORSSerialRegexSet *set)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (NSUInteger i=0; i<ORSSerialRegexSetWords; i++) hash = (hash ^ set->words[i]) * 1099511628211ULL;
+	return (NSUInteger)(hash ^ (hash >> 32));
+}
+
+// Returns the index of the state for set, adding it if needed. If the cache was full and had to be
+// flushed, flushed is set to YES and previously returned indexes are no longer valid.
+static int32_t ORSSerialRegexDFAState(ORSSerialRegexDFA *dfa, const ORSSerialRegexProgram *program, const ORSSerialRegexSet *set, BOOL *flushed)
+{
+	NSUInteger slot = ORSSerialRegexSetHash(set) % ORSSerialRegexStateTableSize;
+	for (; dfa->table[slot] >= 0; slot = (slot + 1) % ORSSerialRegexStateTableSize) {
+		if (!memcmp(&dfa->states[dfa->table[slot]], set, sizeof(*set))) return dfa->table[slot];
+	}
+
+	if (dfa->count == ORSSerialRegexMaximumStates) {
+		ORSSerialRegexDFAFlush(dfa);
+		*flushed = YES;
+		return ORSSerialRegexDFAState(dfa, program, set, flushed);
+	}
+	if (dfa->count == dfa->capacity) {
+		dfa->capacity = MIN(MAX(dfa->capacity * 2, (NSUInteger)16), (NSUInteger)ORSSerialRegexMaximumStates);
+		dfa->states = reallocf(dfa->states, dfa->capacity * sizeof(ORSSerialRegexSet));
+		dfa->accepting = reallocf(dfa->accepting, dfa->capacity * sizeof(BOOL));
+		dfa->transitions = reallocf(dfa->transitions, dfa->capacity * program->byteClassCount * sizeof(int32_t));
+	}
+	int32_t state = (int32_t)dfa->count++;
+	dfa->states[state] = *set;
+	dfa->accepting[state] = ORSSerialRegexSetIntersects(set, &program->last);
+	memset(&dfa->transitions[state * program->byteClassCount], 0xFF, program->byteClassCount * sizeof(int32_t));
+	dfa->table[slot] = state;
+	return state;
+}
+
+static inline int32_t ORSSerialRegexDFAStep(ORSSerialRegexDFA *dfa, const ORSSerialRegexProgram *program, int32_t state, uint8_t byte)
+{
+	NSUInteger transition = state * program->byteClassCount + program->byteClasses[byte];
+	int32_t next = dfa->transitions[transition];
+	if (next >= 0) return next;
+
+	// Every byte may also start a packet
+	ORSSerialRegexSet set = program->first;
+	ORSSerialRegexSetUnionOfSets(&set, &dfa->states[state], program->follow);
+	ORSSerialRegexSetIntersect(&set, &program->byteClassPositions[program->byteClasses[byte]]);
+
+	BOOL flushed = NO;
+	next = ORSSerialRegexDFAState(dfa, program, &set, &flushed);
+	if (!flushed) dfa->transitions[transition] = next;
+	return next;
+}
+
+#pragma mark -
+
+@interface ORSSerialRegexPacketMatcher ()
+{
+	ORSSerialRegexProgram _program;
+	ORSSerialRegexDFA *_dfa;
+	int32_t _state;
+	NSUInteger _maximumPacketLength;
+
+	NSUInteger _clearPosition; // Position of the first byte after the last packet, NSNotFound until scanning starts
+	NSUInteger _lastNonASCIIPosition; // NSNotFound if there hasn't been one
+}
+
+@end
+
+@implementation ORSSerialRegexPacketMatcher
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[%@ initWithPacketDescriptor:]", NSStringFromClass([self class])];
+	return nil;
+}
+
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	self = [super init];
+	if (self) {
+		if (descriptor.checksumAlgorithm != ORSSerialPacketChecksumNone) return nil;
+		NSRegularExpression *regex = descriptor.regularExpression;
+		NSData *pattern = [regex.pattern dataUsingEncoding:NSASCIIStringEncoding allowLossyConversion:NO];
+		if (!pattern || !ORSSerialRegexProgramInit(&_program, [pattern bytes], [pattern length], regex.options)) return nil;
+
+		_descriptor = descriptor;
+		_maximumPacketLength = descriptor.maximumPacketLength;
+		_dfa = calloc(1, sizeof(ORSSerialRegexDFA));
+		ORSSerialRegexDFAFlush(_dfa);
+		_lastNonASCIIPosition = NSNotFound;
+		[self reset];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	ORSSerialRegexProgramFree(&_program);
+	if (_dfa) ORSSerialRegexDFAFree(_dfa);
+	free(_dfa);
+}
+
+- (void)beginScanningWindow:(ORSSerialBuffer *)window fromPosition:(NSUInteger)position
+{
+	[super beginScanningWindow:window fromPosition:position];
+	if (_clearPosition == NSNotFound) _clearPosition = position;
+}
+
+- (BOOL)scanForNextPacket
+{
+	_packet = nil;
+	if (!_maximumPacketLength) _position = _endPosition;
+
+	while (_position < _endPosition) {
+		NSUInteger position = _position++;
+		uint8_t byte = _windowBytes[position - _windowStartPosition];
+		if (byte & 0x80) _lastNonASCIIPosition = position;
+
+		_state = ORSSerialRegexDFAStep(_dfa, &_program, _state, byte);
+
+		NSUInteger received = position + 1;
+		NSUInteger earliestStart = MAX(_clearPosition, received > _maximumPacketLength ? received - _maximumPacketLength : 0);
+		NSUInteger start = NSNotFound;
+		if (_dfa->accepting[_state]) start = [self latestStartOfMatchEndingAtPosition:position earliestStart:earliestStart];
+
+		// Windows matched by the DFA are all ASCII, so they're shorter than any containing the last non-ASCII byte
+		if (start == NSNotFound && _program.canMatchNonASCII &&
+			_lastNonASCIIPosition != NSNotFound && _lastNonASCIIPosition >= earliestStart) {
+			start = [self latestStartOfEvaluatedPacketEndingAtPosition:position earliestStart:earliestStart];
+		}
+		if (start == NSNotFound) continue;
+
+		_packet = [_window dataInRange:NSMakeRange(start, received - start)];
+		_packetDescriptor = self.descriptor;
+		_packetEndPosition = position;
+		[self reset];
+		return YES;
+	}
+	return NO;
+}
+
+- (void)reset
+{
+	BOOL flushed = NO;
+	ORSSerialRegexSet empty = {{0}};
+	_state = ORSSerialRegexDFAState(_dfa, &_program, &empty, &flushed);
+	_clearPosition = _window ? _position : NSNotFound;
+}
+
+#pragma mark - Private
+
+// Runs the automaton backwards from the positions that matched the byte at position, returning the
+// start of the shortest window the whole pattern matches, or NSNotFound.
+- (NSUInteger)latestStartOfMatchEndingAtPosition:(NSUInteger)position earliestStart:(NSUInteger)earliestStart
+{
+	ORSSerialRegexSet set = _dfa->states[_state];
+	ORSSerialRegexSetIntersect(&set, &_program.last);
+	for (NSUInteger start = position; ; start--) {
+		if (ORSSerialRegexSetIntersects(&set, &_program.first)) return start;
+		if (start == earliestStart) break;
+
+		uint8_t byte = _windowBytes[start - 1 - _windowStartPosition];
+		ORSSerialRegexSet previous = {{0}};
+		ORSSerialRegexSetUnionOfSets(&previous, &set, _program.precede);
+		ORSSerialRegexSetIntersect(&previous, &_program.byteClassPositions[_program.byteClasses[byte]]);
+		if (ORSSerialRegexSetIsEmpty(&previous)) break;
+		set = previous;
+	}
+	return NSNotFound;
+}
+
+// Windows that contain non-ASCII bytes are left to the descriptor's evaluator, shortest first. Shorter
+// windows, which start after the last non-ASCII byte, have already been tried by the DFA.
+- (NSUInteger)latestStartOfEvaluatedPacketEndingAtPosition:(NSUInteger)position earliestStart:(NSUInteger)earliestStart
+{
+	NSUInteger received = position + 1;
+	NSUInteger evaluations = 0;
+	NSUInteger result = NSNotFound;
+	for (NSUInteger start = _lastNonASCIIPosition + 1; start-- > earliestStart; ) {
+		evaluations++;
+		// The descriptor only looks at this synchronously, so there's no need to copy it out of the window
+		NSData *window = [NSData dataWithBytesNoCopy:(void *)(_windowBytes + (start - _windowStartPosition))
+											  length:received - start
+										freeWhenDone:NO];
+		if ([self.descriptor dataIsValidPacket:window]) {
+			result = start;
+			break;
+		}
+	}
+	[self.statistics recordEvaluatorInvocations:evaluations];
+	return result;
+}
+
+@end
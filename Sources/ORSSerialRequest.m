@@ -33,6 +33,9 @@
 @property (nonatomic, strong, readwrite) id userInfo;
 @property (nonatomic, readwrite) NSTimeInterval timeoutInterval;
 @property (nonatomic, strong) ORSSerialPacketDescriptor *responseDescriptor;
+@property (nonatomic, strong, readwrite) id correlationTag;
+@property (nonatomic, readwrite) ORSSerialRequestPriority priority;
+@property (nonatomic, strong, readwrite) NSDate *deadline;
 @property (nonatomic, strong, readwrite) NSString *UUIDString;
 
 @end
@@ -47,10 +50,50 @@
 	return [[self alloc] initWithDataToSend:dataToSend userInfo:userInfo timeoutInterval:timeout responseDescriptor:responseDescriptor];
 }
 
++ (instancetype)requestWithDataToSend:(NSData *)dataToSend
+							 userInfo:(id)userInfo
+					  timeoutInterval:(NSTimeInterval)timeout
+				   responseDescriptor:(ORSSerialPacketDescriptor *)responseDescriptor
+					   correlationTag:(id)correlationTag
+{
+	return [[self alloc] initWithDataToSend:dataToSend userInfo:userInfo timeoutInterval:timeout responseDescriptor:responseDescriptor correlationTag:correlationTag];
+}
+
++ (instancetype)requestWithDataToSend:(NSData *)dataToSend
+							 userInfo:(id)userInfo
+					  timeoutInterval:(NSTimeInterval)timeout
+				   responseDescriptor:(ORSSerialPacketDescriptor *)responseDescriptor
+					   correlationTag:(id)correlationTag
+							 priority:(ORSSerialRequestPriority)priority
+							 deadline:(NSDate *)deadline
+{
+	return [[self alloc] initWithDataToSend:dataToSend userInfo:userInfo timeoutInterval:timeout responseDescriptor:responseDescriptor correlationTag:correlationTag priority:priority deadline:deadline];
+}
+
 - (instancetype)initWithDataToSend:(NSData *)dataToSend
 									userInfo:(id)userInfo
 							 timeoutInterval:(NSTimeInterval)timeout
 						  responseDescriptor:(ORSSerialPacketDescriptor *)responseDescriptor
+{
+	return [self initWithDataToSend:dataToSend userInfo:userInfo timeoutInterval:timeout responseDescriptor:responseDescriptor correlationTag:nil];
+}
+
+- (instancetype)initWithDataToSend:(NSData *)dataToSend
+						  userInfo:(id)userInfo
+				   timeoutInterval:(NSTimeInterval)timeout
+				responseDescriptor:(ORSSerialPacketDescriptor *)responseDescriptor
+					correlationTag:(id)correlationTag
+{
+	return [self initWithDataToSend:dataToSend userInfo:userInfo timeoutInterval:timeout responseDescriptor:responseDescriptor correlationTag:correlationTag priority:ORSSerialRequestPriorityNormal deadline:nil];
+}
+
+- (instancetype)initWithDataToSend:(NSData *)dataToSend
+						  userInfo:(id)userInfo
+				   timeoutInterval:(NSTimeInterval)timeout
+				responseDescriptor:(ORSSerialPacketDescriptor *)responseDescriptor
+					correlationTag:(id)correlationTag
+						  priority:(ORSSerialRequestPriority)priority
+						  deadline:(NSDate *)deadline
 {
 	self = [super init];
 	if (self) {
@@ -58,6 +101,9 @@
 		_userInfo = userInfo;
 		_timeoutInterval = timeout;
 		_responseDescriptor = responseDescriptor;
+		_correlationTag = correlationTag;
+		_priority = priority;
+		_deadline = deadline;
 		CFUUIDRef uuid = CFUUIDCreate(kCFAllocatorDefault);
 		_UUIDString = CFBridgingRelease(CFUUIDCreateString(kCFAllocatorDefault, uuid));
 		CFRelease(uuid);
@@ -0,0 +1,46 @@
+//
+//  ORSSerialRequestScheduler.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ORSSerialRequest;
+
+/**
+ *  Private class used by ORSSerialPort to hold requests waiting to be sent.
+ *
+ *  Requests are kept in one linked list per priority level, so adding a request, taking
+ *  the next one and removing any given one are all constant time. Requests come out
+ *  highest priority first, and in the order they were added within a priority.
+ *
+ *  Each request with a deadline gets a timer on the shared timer wheel while it's queued, so
+ *  requests whose deadlines pass while they're waiting behind others are reported then,
+ *  rather than when they reach the front of the queue.
+ *
+ *  All methods are thread safe.
+ */
+@interface ORSSerialRequestScheduler : NSObject
+
+- (instancetype)init;
+
+// expirationHandler is called on queue when the deadline of a request that's still queued passes.
+// The request isn't removed, so the handler can decide what to do with it.
+- (instancetype)initWithExpirationQueue:(dispatch_queue_t)queue
+					  expirationHandler:(void (^)(ORSSerialRequest *request))expirationHandler NS_DESIGNATED_INITIALIZER;
+
+- (void)addRequest:(ORSSerialRequest *)request;
+
+// Removes and returns the next request to send, or nil if there are none
+- (ORSSerialRequest *)nextRequest;
+
+// Returns NO if request wasn't in the receiver
+- (BOOL)removeRequest:(ORSSerialRequest *)request;
+- (void)removeAllRequests;
+
+@property (readonly) NSUInteger count;
+@property (readonly) NSArray *requests; // In the order they'll be returned by -nextRequest
+
+@end
@@ -0,0 +1,199 @@
+//
+//  ORSSerialRequestScheduler.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialRequestScheduler.h"
+#import "ORSSerial/ORSSerialRequest.h"
+#import "ORSSerialTimerWheel.h"
+#import <pthread.h>
+
+#if OS_OBJECT_USE_OBJC && __has_feature(objc_arc)
+#define ORS_GCD_RELEASE(x)
+#define ORS_GCD_RETAIN(x)
+#else
+#define ORS_GCD_RELEASE(x) if (x) { dispatch_release(x); }
+#define ORS_GCD_RETAIN(x) if (x) { dispatch_retain(x); }
+#endif
+
+enum { ORSSerialRequestSchedulerPriorityCount = ORSSerialRequestPriorityHigh + 1 }; // Usable as an array size
+
+@interface ORSSerialRequestSchedulerNode : NSObject
+{
+@public
+	ORSSerialRequest *_request;
+	NSUInteger _priority;
+	ORSSerialTimerWheelTimer *_expirationTimer; // Only for requests with a deadline
+	ORSSerialRequestSchedulerNode *_next;
+	__unsafe_unretained ORSSerialRequestSchedulerNode *_previous; // Owned by the previous node's _next, or the list's head
+}
+@end
+
+@implementation ORSSerialRequestSchedulerNode
+@end
+
+@interface ORSSerialRequestScheduler ()
+{
+	pthread_mutex_t _lock;
+	ORSSerialRequestSchedulerNode *_heads[ORSSerialRequestSchedulerPriorityCount];
+	__unsafe_unretained ORSSerialRequestSchedulerNode *_tails[ORSSerialRequestSchedulerPriorityCount];
+	NSUInteger _count;
+}
+
+@property (nonatomic, strong) NSMapTable *nodesByRequest; // Keyed by pointer identity
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong) dispatch_queue_t expirationQueue;
+#else
+@property (nonatomic) dispatch_queue_t expirationQueue;
+#endif
+@property (nonatomic, copy) void (^expirationHandler)(ORSSerialRequest *request);
+
+@end
+
+@implementation ORSSerialRequestScheduler
+
+- (instancetype)init
+{
+	return [self initWithExpirationQueue:NULL expirationHandler:nil];
+}
+
+- (instancetype)initWithExpirationQueue:(dispatch_queue_t)queue expirationHandler:(void (^)(ORSSerialRequest *))expirationHandler
+{
+	self = [super init];
+	if (self) {
+		pthread_mutex_init(&_lock, NULL);
+		_expirationQueue = queue;
+		ORS_GCD_RETAIN(queue);
+		_expirationHandler = [expirationHandler copy];
+		_nodesByRequest = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+													valueOptions:NSPointerFunctionsStrongMemory
+														capacity:0];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[self removeAllRequests]; // Unlinks nodes one by one, rather than recursively releasing a long list
+	ORS_GCD_RELEASE(_expirationQueue);
+	pthread_mutex_destroy(&_lock);
+}
+
+- (void)addRequest:(ORSSerialRequest *)request
+{
+	if (!request) return;
+	
+	ORSSerialRequestSchedulerNode *node = [[ORSSerialRequestSchedulerNode alloc] init];
+	node->_request = request;
+	node->_priority = MIN((NSUInteger)request.priority, ORSSerialRequestSchedulerPriorityCount - 1);
+	
+	pthread_mutex_lock(&_lock);
+	if ([self.nodesByRequest objectForKey:request]) {
+		pthread_mutex_unlock(&_lock);
+		return; // Already scheduled
+	}
+	NSUInteger priority = node->_priority;
+	node->_previous = _tails[priority];
+	if (_tails[priority]) {
+		_tails[priority]->_next = node;
+	} else {
+		_heads[priority] = node;
+	}
+	_tails[priority] = node;
+	[self.nodesByRequest setObject:node forKey:request];
+	_count++;
+	
+	NSDate *deadline = request.deadline;
+	void (^expirationHandler)(ORSSerialRequest *) = self.expirationHandler;
+	if (deadline && expirationHandler) {
+		node->_expirationTimer = [[ORSSerialTimerWheel sharedTimerWheel] scheduleTimerWithTimeInterval:[deadline timeIntervalSinceNow]
+																								 queue:self.expirationQueue
+																							   handler:^{ expirationHandler(request); }];
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (ORSSerialRequest *)nextRequest
+{
+	ORSSerialRequest *request = nil;
+	pthread_mutex_lock(&_lock);
+	for (NSUInteger i = ORSSerialRequestSchedulerPriorityCount; i > 0; i--) {
+		ORSSerialRequestSchedulerNode *node = _heads[i-1];
+		if (!node) continue;
+		request = node->_request;
+		[self unlinkNode:node];
+		break;
+	}
+	pthread_mutex_unlock(&_lock);
+	return request;
+}
+
+- (BOOL)removeRequest:(ORSSerialRequest *)request
+{
+	if (!request) return NO;
+	pthread_mutex_lock(&_lock);
+	ORSSerialRequestSchedulerNode *node = [self.nodesByRequest objectForKey:request];
+	if (node) [self unlinkNode:node];
+	pthread_mutex_unlock(&_lock);
+	return node != nil;
+}
+
+- (void)removeAllRequests
+{
+	pthread_mutex_lock(&_lock);
+	for (NSUInteger i = 0; i < ORSSerialRequestSchedulerPriorityCount; i++) {
+		while (_heads[i]) [self unlinkNode:_heads[i]];
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)count
+{
+	pthread_mutex_lock(&_lock);
+	NSUInteger count = _count;
+	pthread_mutex_unlock(&_lock);
+	return count;
+}
+
+- (NSArray *)requests
+{
+	NSMutableArray *requests = [NSMutableArray array];
+	pthread_mutex_lock(&_lock);
+	for (NSUInteger i = ORSSerialRequestSchedulerPriorityCount; i > 0; i--) {
+		for (ORSSerialRequestSchedulerNode *node = _heads[i-1]; node; node = node->_next) {
+			[requests addObject:node->_request];
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+	return requests;
+}
+
+#pragma mark - Private
+
+// Must be called with _lock held
+- (void)unlinkNode:(ORSSerialRequestSchedulerNode *)node
+{
+	ORSSerialRequestSchedulerNode *strongNode = node; // Keep it alive until it's fully unlinked
+	NSUInteger priority = node->_priority;
+	ORSSerialRequestSchedulerNode *next = node->_next;
+	if (node->_previous) {
+		node->_previous->_next = next;
+	} else {
+		_heads[priority] = next;
+	}
+	if (next) {
+		next->_previous = node->_previous;
+	} else {
+		_tails[priority] = node->_previous;
+	}
+	node->_next = nil;
+	node->_previous = nil;
+	[[ORSSerialTimerWheel sharedTimerWheel] cancelTimer:node->_expirationTimer];
+	node->_expirationTimer = nil;
+	[self.nodesByRequest removeObjectForKey:strongNode->_request];
+	_count--;
+}
+
+@end
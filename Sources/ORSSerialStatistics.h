@@ -0,0 +1,47 @@
+//
+//  ORSSerialStatistics.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ORSSerialPacketDescriptor;
+@class ORSSerialPortStatistics;
+
+// Monotonic clock in nanoseconds, used for latencies, timer wheel ticks and modem line polling.
+// dispatch_time() values are in Mach time units, which aren't nanoseconds on every Mac.
+uint64_t ORSSerialStatisticsNanoseconds(void);
+
+/**
+ *  Private class used by ORSSerialPort to keep its runtime statistics.
+ *
+ *  Counters and histogram buckets are relaxed atomics, so recording never takes a lock and
+ *  -snapshot can be called from any thread at any time. A snapshot taken while the port is
+ *  busy may be a few events out of step between fields, but each field is exact.
+ *
+ *  Histograms are log-linear like HdrHistogram: values below 16 have a bucket each, and every
+ *  power of two above that is split into 16 buckets, so values are kept to within about 6%.
+ */
+@interface ORSSerialStatistics : NSObject
+
+- (void)recordReadOfLength:(NSUInteger)length;
+- (void)recordWriteOfLength:(NSUInteger)length; // One write call
+- (void)recordWriteStall; // A write found no room in the port
+- (void)recordEvaluatorInvocations:(NSUInteger)count;
+- (void)recordRequestTimeout;
+- (void)recordRequestExpiration;
+- (void)recordRequestRoundTripTime:(uint64_t)nanoseconds;
+- (void)recordReceiveToDelegateLatency:(uint64_t)nanoseconds;
+
+// These two must only be called on the port's requestHandlingQueue. Counts are kept for
+// descriptors that are still installed.
+- (void)setPacketDescriptors:(NSArray *)descriptors;
+- (void)recordPacketMatchingDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+- (void)setQueuedRequestCount:(NSUInteger)count;
+
+- (ORSSerialPortStatistics *)snapshotWithPendingRequestCount:(NSUInteger)pendingRequestCount;
+
+@end
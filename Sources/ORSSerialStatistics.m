@@ -0,0 +1,302 @@
+//
+//  ORSSerialStatistics.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialStatistics.h"
+#import "ORSSerial/ORSSerialPortStatistics.h"
+#import "ORSSerial/ORSSerialPacketDescriptor.h"
+#import <stdatomic.h>
+#import <mach/mach_time.h>
+
+enum {
+	ORSSerialHistogramSubBucketBits = 4,
+	ORSSerialHistogramSubBucketCount = 1 << ORSSerialHistogramSubBucketBits,
+	ORSSerialHistogramMaximumExponent = 47, // Larger values (over a day in nanoseconds) go in the last bucket
+	ORSSerialHistogramBucketCount = (ORSSerialHistogramMaximumExponent - ORSSerialHistogramSubBucketBits + 2) * ORSSerialHistogramSubBucketCount,
+};
+
+typedef struct {
+	atomic_uint_fast64_t buckets[ORSSerialHistogramBucketCount];
+	atomic_uint_fast64_t count;
+	atomic_uint_fast64_t sum;
+	atomic_uint_fast64_t minimum;
+	atomic_uint_fast64_t maximum;
+} ORSSerialHistogramCounts;
+
+uint64_t ORSSerialStatisticsNanoseconds(void)
+{
+	static mach_timebase_info_data_t timebase;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{ mach_timebase_info(&timebase); });
+	return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+static NSUInteger ORSSerialHistogramBucketIndex(uint64_t value)
+{
+	if (value < ORSSerialHistogramSubBucketCount) return (NSUInteger)value;
+	unsigned int exponent = 63 - __builtin_clzll(value);
+	if (exponent > ORSSerialHistogramMaximumExponent) return ORSSerialHistogramBucketCount - 1;
+	unsigned int shift = exponent - ORSSerialHistogramSubBucketBits;
+	NSUInteger subBucket = (NSUInteger)(value >> shift) & (ORSSerialHistogramSubBucketCount - 1);
+	return (shift + 1) * ORSSerialHistogramSubBucketCount + subBucket;
+}
+
+// Largest value that goes in bucket
+static uint64_t ORSSerialHistogramBucketValue(NSUInteger index)
+{
+	if (index < ORSSerialHistogramSubBucketCount) return index;
+	unsigned int shift = (unsigned int)(index / ORSSerialHistogramSubBucketCount) - 1;
+	uint64_t lowest = (uint64_t)(ORSSerialHistogramSubBucketCount + index % ORSSerialHistogramSubBucketCount) << shift;
+	return lowest + ((uint64_t)1 << shift) - 1;
+}
+
+static void ORSSerialHistogramCountsInit(ORSSerialHistogramCounts *counts)
+{
+	atomic_init(&counts->minimum, UINT64_MAX);
+}
+
+static void ORSSerialHistogramRecord(ORSSerialHistogramCounts *counts, uint64_t value)
+{
+	atomic_fetch_add_explicit(&counts->buckets[ORSSerialHistogramBucketIndex(value)], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&counts->count, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&counts->sum, value, memory_order_relaxed);
+
+	uint_fast64_t minimum = atomic_load_explicit(&counts->minimum, memory_order_relaxed);
+	while (value < minimum && !atomic_compare_exchange_weak_explicit(&counts->minimum, &minimum, value, memory_order_relaxed, memory_order_relaxed)) {}
+	uint_fast64_t maximum = atomic_load_explicit(&counts->maximum, memory_order_relaxed);
+	while (value > maximum && !atomic_compare_exchange_weak_explicit(&counts->maximum, &maximum, value, memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+#pragma mark - ORSSerialHistogram
+
+@interface ORSSerialHistogram ()
+{
+	uint64_t _buckets[ORSSerialHistogramBucketCount];
+}
+
+- (instancetype)initWithCounts:(ORSSerialHistogramCounts *)counts;
+
+@end
+
+@implementation ORSSerialHistogram
+
+- (instancetype)initWithCounts:(ORSSerialHistogramCounts *)counts
+{
+	self = [super init];
+	if (self) {
+		uint64_t total = 0;
+		for (NSUInteger i = 0; i < ORSSerialHistogramBucketCount; i++) {
+			_buckets[i] = atomic_load_explicit(&counts->buckets[i], memory_order_relaxed);
+			total += _buckets[i];
+		}
+		_count = total; // Matches the buckets, even if values were recorded while copying them
+		if (total) {
+			_minimum = atomic_load_explicit(&counts->minimum, memory_order_relaxed);
+			_maximum = atomic_load_explicit(&counts->maximum, memory_order_relaxed);
+			_mean = (double)atomic_load_explicit(&counts->sum, memory_order_relaxed) / atomic_load_explicit(&counts->count, memory_order_relaxed);
+		}
+	}
+	return self;
+}
+
+- (uint64_t)valueAtPercentile:(double)percentile
+{
+	if (!self.count) return 0;
+
+	uint64_t target = (uint64_t)ceil(MIN(MAX(percentile, 0.0), 100.0) / 100.0 * self.count);
+	uint64_t seen = 0;
+	for (NSUInteger i = 0; i < ORSSerialHistogramBucketCount; i++) {
+		seen += _buckets[i];
+		if (seen >= MAX(target, (uint64_t)1)) return MIN(ORSSerialHistogramBucketValue(i), self.maximum);
+	}
+	return self.maximum;
+}
+
+- (NSString *)description
+{
+	return [NSString stringWithFormat:@"<%@: %p count: %llu, p50: %llu, p99: %llu, max: %llu>", NSStringFromClass([self class]), self,
+			self.count, [self valueAtPercentile:50], [self valueAtPercentile:99], self.maximum];
+}
+
+@end
+
+#pragma mark - ORSSerialPortStatistics
+
+@interface ORSSerialPortStatistics ()
+
+@property (nonatomic, readwrite) uint64_t bytesReceived;
+@property (nonatomic, readwrite) uint64_t readCount;
+@property (nonatomic, strong, readwrite) ORSSerialHistogram *readSizes;
+@property (nonatomic, readwrite) uint64_t bytesSent;
+@property (nonatomic, readwrite) uint64_t writeCount;
+@property (nonatomic, readwrite) uint64_t writeStallCount;
+@property (nonatomic, readwrite) uint64_t packetCount;
+@property (nonatomic, strong) NSMapTable *packetCountsByDescriptor;
+@property (nonatomic, readwrite) uint64_t evaluatorInvocationCount;
+@property (nonatomic, readwrite) NSUInteger queuedRequestCount;
+@property (nonatomic, readwrite) NSUInteger pendingRequestCount;
+@property (nonatomic, readwrite) uint64_t requestTimeoutCount;
+@property (nonatomic, readwrite) uint64_t requestExpirationCount;
+@property (nonatomic, strong, readwrite) ORSSerialHistogram *requestRoundTripTimes;
+@property (nonatomic, strong, readwrite) ORSSerialHistogram *receiveToDelegateLatencies;
+
+@end
+
+@implementation ORSSerialPortStatistics
+
+- (NSArray *)packetDescriptors
+{
+	return NSAllMapTableKeys(self.packetCountsByDescriptor) ?: @[];
+}
+
+- (uint64_t)packetCountForDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	return [[self.packetCountsByDescriptor objectForKey:descriptor] unsignedLongLongValue];
+}
+
+@end
+
+#pragma mark - ORSSerialStatistics
+
+// Packets received for one installed descriptor
+@interface ORSSerialPacketCounter : NSObject
+{
+@public
+	atomic_uint_fast64_t _count;
+}
+
+@property (nonatomic, strong) ORSSerialPacketDescriptor *descriptor;
+
+@end
+
+@implementation ORSSerialPacketCounter
+@end
+
+@interface ORSSerialStatistics ()
+{
+	atomic_uint_fast64_t _bytesReceived;
+	atomic_uint_fast64_t _readCount;
+	atomic_uint_fast64_t _bytesSent;
+	atomic_uint_fast64_t _writeCount;
+	atomic_uint_fast64_t _writeStallCount;
+	atomic_uint_fast64_t _packetCount;
+	atomic_uint_fast64_t _evaluatorInvocationCount;
+	atomic_uint_fast64_t _queuedRequestCount;
+	atomic_uint_fast64_t _requestTimeoutCount;
+	atomic_uint_fast64_t _requestExpirationCount;
+	ORSSerialHistogramCounts _readSizes;
+	ORSSerialHistogramCounts _requestRoundTripTimes;
+	ORSSerialHistogramCounts _receiveToDelegateLatencies;
+}
+
+@property (nonatomic, strong) NSMapTable *packetCounters; // Only used on the port's requestHandlingQueue
+@property (copy) NSArray *publishedPacketCounters; // For snapshots
+
+@end
+
+@implementation ORSSerialStatistics
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		ORSSerialHistogramCountsInit(&_readSizes);
+		ORSSerialHistogramCountsInit(&_requestRoundTripTimes);
+		ORSSerialHistogramCountsInit(&_receiveToDelegateLatencies);
+		_packetCounters = [NSMapTable strongToStrongObjectsMapTable];
+		_publishedPacketCounters = @[];
+	}
+	return self;
+}
+
+- (void)recordReadOfLength:(NSUInteger)length
+{
+	atomic_fetch_add_explicit(&_bytesReceived, length, memory_order_relaxed);
+	atomic_fetch_add_explicit(&_readCount, 1, memory_order_relaxed);
+	ORSSerialHistogramRecord(&_readSizes, length);
+}
+
+- (void)recordWriteOfLength:(NSUInteger)length
+{
+	atomic_fetch_add_explicit(&_bytesSent, length, memory_order_relaxed);
+	atomic_fetch_add_explicit(&_writeCount, 1, memory_order_relaxed);
+}
+
+- (void)recordWriteStall { atomic_fetch_add_explicit(&_writeStallCount, 1, memory_order_relaxed); }
+
+- (void)recordEvaluatorInvocations:(NSUInteger)count
+{
+	atomic_fetch_add_explicit(&_evaluatorInvocationCount, count, memory_order_relaxed);
+}
+
+- (void)recordRequestTimeout { atomic_fetch_add_explicit(&_requestTimeoutCount, 1, memory_order_relaxed); }
+- (void)recordRequestExpiration { atomic_fetch_add_explicit(&_requestExpirationCount, 1, memory_order_relaxed); }
+
+- (void)recordRequestRoundTripTime:(uint64_t)nanoseconds
+{
+	ORSSerialHistogramRecord(&_requestRoundTripTimes, nanoseconds);
+}
+
+- (void)recordReceiveToDelegateLatency:(uint64_t)nanoseconds
+{
+	ORSSerialHistogramRecord(&_receiveToDelegateLatencies, nanoseconds);
+}
+
+- (void)setPacketDescriptors:(NSArray *)descriptors
+{
+	NSMapTable *packetCounters = [NSMapTable strongToStrongObjectsMapTable];
+	for (ORSSerialPacketDescriptor *descriptor in descriptors) {
+		ORSSerialPacketCounter *counter = [self.packetCounters objectForKey:descriptor];
+		if (!counter) {
+			counter = [[ORSSerialPacketCounter alloc] init];
+			counter.descriptor = descriptor;
+		}
+		[packetCounters setObject:counter forKey:descriptor];
+	}
+	self.packetCounters = packetCounters;
+	self.publishedPacketCounters = NSAllMapTableValues(packetCounters);
+}
+
+- (void)recordPacketMatchingDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	atomic_fetch_add_explicit(&_packetCount, 1, memory_order_relaxed);
+	ORSSerialPacketCounter *counter = [self.packetCounters objectForKey:descriptor];
+	if (counter) atomic_fetch_add_explicit(&counter->_count, 1, memory_order_relaxed);
+}
+
+- (void)setQueuedRequestCount:(NSUInteger)count
+{
+	atomic_store_explicit(&_queuedRequestCount, count, memory_order_relaxed);
+}
+
+- (ORSSerialPortStatistics *)snapshotWithPendingRequestCount:(NSUInteger)pendingRequestCount
+{
+	ORSSerialPortStatistics *snapshot = [[ORSSerialPortStatistics alloc] init];
+	snapshot.bytesReceived = atomic_load_explicit(&_bytesReceived, memory_order_relaxed);
+	snapshot.readCount = atomic_load_explicit(&_readCount, memory_order_relaxed);
+	snapshot.readSizes = [[ORSSerialHistogram alloc] initWithCounts:&_readSizes];
+	snapshot.bytesSent = atomic_load_explicit(&_bytesSent, memory_order_relaxed);
+	snapshot.writeCount = atomic_load_explicit(&_writeCount, memory_order_relaxed);
+	snapshot.writeStallCount = atomic_load_explicit(&_writeStallCount, memory_order_relaxed);
+	snapshot.packetCount = atomic_load_explicit(&_packetCount, memory_order_relaxed);
+	snapshot.evaluatorInvocationCount = atomic_load_explicit(&_evaluatorInvocationCount, memory_order_relaxed);
+	snapshot.queuedRequestCount = (NSUInteger)atomic_load_explicit(&_queuedRequestCount, memory_order_relaxed);
+	snapshot.pendingRequestCount = pendingRequestCount;
+	snapshot.requestTimeoutCount = atomic_load_explicit(&_requestTimeoutCount, memory_order_relaxed);
+	snapshot.requestExpirationCount = atomic_load_explicit(&_requestExpirationCount, memory_order_relaxed);
+	snapshot.requestRoundTripTimes = [[ORSSerialHistogram alloc] initWithCounts:&_requestRoundTripTimes];
+	snapshot.receiveToDelegateLatencies = [[ORSSerialHistogram alloc] initWithCounts:&_receiveToDelegateLatencies];
+
+	NSMapTable *packetCounts = [NSMapTable strongToStrongObjectsMapTable];
+	for (ORSSerialPacketCounter *counter in self.publishedPacketCounters) {
+		[packetCounts setObject:@(atomic_load_explicit(&counter->_count, memory_order_relaxed)) forKey:counter.descriptor];
+	}
+	snapshot.packetCountsByDescriptor = packetCounts;
+
+	return snapshot;
+}
+
+@end
@@ -0,0 +1,36 @@
+//
+//  ORSSerialTimerWheel.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ORSSerialTimerWheelTimer;
+
+/**
+ *  Private class used by ORSSerialPort to time out requests, shared by all ports.
+ *
+ *  Timers are kept in a hierarchical timing wheel: four levels of 256 slots each, with
+ *  4 ms ticks at the lowest level, so arming and cancelling a timer are constant time no
+ *  matter how many are armed. A single dispatch timer advances the wheel, and only runs
+ *  while at least one timer is armed. Timers never fire early, and fire up to two ticks late.
+ *
+ *  All methods are thread safe.
+ */
+@interface ORSSerialTimerWheel : NSObject
+
++ (instancetype)sharedTimerWheel;
+
+// handler is called once on queue after interval, unless the timer is cancelled first
+- (ORSSerialTimerWheelTimer *)scheduleTimerWithTimeInterval:(NSTimeInterval)interval
+													  queue:(dispatch_queue_t)queue
+													handler:(dispatch_block_t)handler;
+
+// Does nothing if timer has already fired. A handler that has already been dispatched may still run.
+- (void)cancelTimer:(ORSSerialTimerWheelTimer *)timer;
+
+@property (readonly) NSUInteger count; // Number of armed timers
+
+@end
@@ -0,0 +1,271 @@
+//
+//  ORSSerialTimerWheel.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialTimerWheel.h"
+#import "ORSSerialStatistics.h"
+#import <pthread.h>
+
+#if OS_OBJECT_USE_OBJC && __has_feature(objc_arc)
+#define ORS_GCD_RELEASE(x)
+#define ORS_GCD_RETAIN(x)
+#else
+#define ORS_GCD_RELEASE(x) if (x) { dispatch_release(x); }
+#define ORS_GCD_RETAIN(x) if (x) { dispatch_retain(x); }
+#endif
+
+static const uint64_t ORSSerialTimerWheelTickLength = 4 * NSEC_PER_MSEC;
+enum {
+	ORSSerialTimerWheelLevelCount = 4,
+	ORSSerialTimerWheelSlotBits = 8,
+	ORSSerialTimerWheelSlotCount = 1 << ORSSerialTimerWheelSlotBits,
+	ORSSerialTimerWheelSlotMask = ORSSerialTimerWheelSlotCount - 1,
+};
+
+@interface ORSSerialTimerWheelTimer : NSObject
+{
+@public
+	uint64_t _expiryTick;
+	NSUInteger _level;
+	NSUInteger _slot;
+	BOOL _armed;
+	dispatch_block_t _handler;
+	ORSSerialTimerWheelTimer *_next;
+	__unsafe_unretained ORSSerialTimerWheelTimer *_previous; // Owned by the previous timer's _next, or the slot's head
+}
+
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong) dispatch_queue_t queue;
+#else
+@property (nonatomic) dispatch_queue_t queue;
+#endif
+
+@end
+
+@implementation ORSSerialTimerWheelTimer
+
+- (void)dealloc
+{
+	ORS_GCD_RELEASE(_queue);
+}
+
+- (void)setQueue:(dispatch_queue_t)queue
+{
+	if (queue == _queue) return;
+	ORS_GCD_RETAIN(queue);
+	ORS_GCD_RELEASE(_queue);
+	_queue = queue;
+}
+
+@end
+
+@interface ORSSerialTimerWheel ()
+{
+	pthread_mutex_t _lock;
+	ORSSerialTimerWheelTimer *_slots[ORSSerialTimerWheelLevelCount][ORSSerialTimerWheelSlotCount];
+	uint64_t _startTime; // Wheel time 0, in nanoseconds since boot
+	uint64_t _currentTick; // Every tick up to and including this one has been processed
+	NSUInteger _count;
+	BOOL _ticking;
+}
+
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) dispatch_source_t tickTimer;
+#else
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) dispatch_source_t tickTimer;
+#endif
+
+@end
+
+@implementation ORSSerialTimerWheel
+
++ (instancetype)sharedTimerWheel
+{
+	static ORSSerialTimerWheel *sharedTimerWheel = nil;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		sharedTimerWheel = [[self alloc] init];
+	});
+	return sharedTimerWheel;
+}
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		pthread_mutex_init(&_lock, NULL);
+		_startTime = ORSSerialStatisticsNanoseconds();
+		_queue = dispatch_queue_create("com.openreelsoftware.ORSSerialPort.timerWheel", 0);
+		_tickTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+		dispatch_source_set_timer(_tickTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+		__weak ORSSerialTimerWheel *weakSelf = self;
+		dispatch_source_set_event_handler(_tickTimer, ^{ [weakSelf advance]; });
+		dispatch_resume(_tickTimer);
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_tickTimer) {
+		dispatch_source_cancel(_tickTimer);
+		ORS_GCD_RELEASE(_tickTimer);
+	}
+	ORS_GCD_RELEASE(_queue);
+	pthread_mutex_destroy(&_lock);
+}
+
+- (ORSSerialTimerWheelTimer *)scheduleTimerWithTimeInterval:(NSTimeInterval)interval
+													  queue:(dispatch_queue_t)queue
+													handler:(dispatch_block_t)handler
+{
+	ORSSerialTimerWheelTimer *timer = [[ORSSerialTimerWheelTimer alloc] init];
+	timer.queue = queue;
+	timer->_handler = [handler copy];
+	
+	uint64_t ticks = (uint64_t)(MAX(interval, 0.0) * NSEC_PER_SEC + ORSSerialTimerWheelTickLength - 1) / ORSSerialTimerWheelTickLength;
+	
+	pthread_mutex_lock(&_lock);
+	// Read under the lock, so -advance can't have processed this tick's slot in between
+	uint64_t nowTick = [self tickAtTime:ORSSerialStatisticsNanoseconds()];
+	if (!_count) {
+		// Nothing was armed, so the wheel may have stopped a while ago. There's nothing to catch up on.
+		_currentTick = nowTick;
+	}
+	// Counted from now rather than from the last tick processed, which may lag behind. Part of the current
+	// tick has already gone by, so the timer waits until the end of its last whole tick, and never fires early.
+	timer->_expiryTick = nowTick + ticks + 1;
+	[self insertTimer:timer];
+	_count++;
+	if (!_ticking) {
+		_ticking = YES;
+		dispatch_source_set_timer(self.tickTimer, dispatch_time(DISPATCH_TIME_NOW, ORSSerialTimerWheelTickLength), ORSSerialTimerWheelTickLength, ORSSerialTimerWheelTickLength / 4);
+	}
+	pthread_mutex_unlock(&_lock);
+	
+	return timer;
+}
+
+- (void)cancelTimer:(ORSSerialTimerWheelTimer *)timer
+{
+	if (!timer) return;
+	pthread_mutex_lock(&_lock);
+	if (timer->_armed) {
+		[self unlinkTimer:timer];
+		timer->_handler = nil;
+		_count--;
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)count
+{
+	pthread_mutex_lock(&_lock);
+	NSUInteger count = _count;
+	pthread_mutex_unlock(&_lock);
+	return count;
+}
+
+#pragma mark - Private
+
+- (uint64_t)tickAtTime:(uint64_t)time
+{
+	return time > _startTime ? (time - _startTime) / ORSSerialTimerWheelTickLength : 0;
+}
+
+// Runs on queue each tick while timers are armed
+- (void)advance
+{
+	NSMutableArray *expired = [NSMutableArray array];
+	
+	pthread_mutex_lock(&_lock);
+	uint64_t nowTick = [self tickAtTime:ORSSerialStatisticsNanoseconds()];
+	while (_currentTick < nowTick && _count) {
+		_currentTick++;
+		
+		// Each time a level wraps around, the next level's timers for the coming period move down
+		for (NSUInteger level = 1; level < ORSSerialTimerWheelLevelCount; level++) {
+			if ((_currentTick >> (ORSSerialTimerWheelSlotBits * (level - 1))) & ORSSerialTimerWheelSlotMask) break;
+			[self cascadeSlot:(_currentTick >> (ORSSerialTimerWheelSlotBits * level)) & ORSSerialTimerWheelSlotMask ofLevel:level];
+		}
+		
+		NSUInteger slot = _currentTick & ORSSerialTimerWheelSlotMask;
+		while (_slots[0][slot]) {
+			ORSSerialTimerWheelTimer *timer = _slots[0][slot];
+			[self unlinkTimer:timer];
+			_count--;
+			[expired addObject:timer];
+		}
+	}
+	if (!_count && _ticking) {
+		_ticking = NO;
+		dispatch_source_set_timer(self.tickTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+	}
+	pthread_mutex_unlock(&_lock);
+	
+	for (ORSSerialTimerWheelTimer *timer in expired) {
+		dispatch_block_t handler = timer->_handler;
+		timer->_handler = nil;
+		if (handler) dispatch_async(timer.queue, handler);
+	}
+}
+
+// Must be called with _lock held
+- (void)insertTimer:(ORSSerialTimerWheelTimer *)timer
+{
+	uint64_t expiryTick = MAX(timer->_expiryTick, _currentTick); // Timers cascading down may be due this tick
+	uint64_t delta = expiryTick - _currentTick;
+	NSUInteger level = 0;
+	while (level < ORSSerialTimerWheelLevelCount - 1 && delta >= ((uint64_t)1 << (ORSSerialTimerWheelSlotBits * (level + 1)))) level++;
+	
+	// Beyond the top level's range, park the timer in the furthest slot. It moves down when that comes around.
+	uint64_t maximumDelta = ((uint64_t)1 << (ORSSerialTimerWheelSlotBits * ORSSerialTimerWheelLevelCount)) - 1;
+	if (delta > maximumDelta) expiryTick = _currentTick + maximumDelta;
+	
+	NSUInteger slot = (expiryTick >> (ORSSerialTimerWheelSlotBits * level)) & ORSSerialTimerWheelSlotMask;
+	timer->_level = level;
+	timer->_slot = slot;
+	timer->_armed = YES;
+	timer->_previous = nil;
+	timer->_next = _slots[level][slot];
+	if (timer->_next) timer->_next->_previous = timer;
+	_slots[level][slot] = timer;
+}
+
+// Must be called with _lock held
+- (void)unlinkTimer:(ORSSerialTimerWheelTimer *)timer
+{
+	ORSSerialTimerWheelTimer *strongTimer = timer; // Keep it alive until it's fully unlinked
+	ORSSerialTimerWheelTimer *next = strongTimer->_next;
+	if (strongTimer->_previous) {
+		strongTimer->_previous->_next = next;
+	} else {
+		_slots[strongTimer->_level][strongTimer->_slot] = next;
+	}
+	if (next) next->_previous = strongTimer->_previous;
+	strongTimer->_next = nil;
+	strongTimer->_previous = nil;
+	strongTimer->_armed = NO;
+}
+
+// Must be called with _lock held
+- (void)cascadeSlot:(NSUInteger)slot ofLevel:(NSUInteger)level
+{
+	ORSSerialTimerWheelTimer *timer = _slots[level][slot];
+	_slots[level][slot] = nil;
+	while (timer) {
+		ORSSerialTimerWheelTimer *next = timer->_next;
+		timer->_next = nil;
+		timer->_previous = nil;
+		if (next) next->_previous = nil;
+		[self insertTimer:timer];
+		timer = next;
+	}
+}
+
+@end
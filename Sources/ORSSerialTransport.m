@@ -0,0 +1,172 @@
+//
+//  ORSSerialTransport.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#import "ORSSerial/ORSSerialTransport.h"
+#import <fcntl.h>
+#import <unistd.h>
+#import <util.h>
+#import <stdatomic.h>
+#import <sys/socket.h>
+
+#pragma mark - ORSSerialFileDescriptorTransport
+
+@interface ORSSerialFileDescriptorTransport ()
+
+@property (copy, readwrite) NSString *path;
+@property (copy, readwrite) NSString *name;
+
+@end
+
+@implementation ORSSerialFileDescriptorTransport
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[ORSSerialFileDescriptorTransport initWithPath:name:]"];
+	return nil;
+}
+
+- (instancetype)initWithPath:(NSString *)path name:(NSString *)name
+{
+	self = [super init];
+	if (self) {
+		_path = [path copy];
+		_name = [name copy];
+	}
+	return self;
+}
+
+- (int)openFileDescriptor
+{
+	return open([self.path cStringUsingEncoding:NSASCIIStringEncoding], O_RDWR | O_NOCTTY | O_EXLOCK | O_NONBLOCK);
+}
+
+- (int)closeFileDescriptor:(int)fileDescriptor { return close(fileDescriptor); }
+
+- (BOOL)supportsTerminalAttributes { return YES; }
+- (BOOL)supportsModemLines { return YES; }
+
+@end
+
+#pragma mark - ORSSerialPseudoTerminalTransport
+
+@interface ORSSerialPseudoTerminalTransport ()
+{
+	int _terminalFileDescriptor; // Kept open so the terminal exists while the port is closed
+}
+
+@property (copy, readwrite) NSString *path;
+
+@end
+
+@implementation ORSSerialPseudoTerminalTransport
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		_peerFileDescriptor = _terminalFileDescriptor = -1; // Nothing for -dealloc to close if this fails
+		char name[PATH_MAX];
+		if (openpty(&_peerFileDescriptor, &_terminalFileDescriptor, name, NULL, NULL) == -1) return nil;
+		_path = [NSString stringWithUTF8String:name];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_terminalFileDescriptor >= 0) close(_terminalFileDescriptor);
+	if (_peerFileDescriptor >= 0) close(_peerFileDescriptor);
+}
+
+- (int)openFileDescriptor
+{
+	return open([self.path fileSystemRepresentation], O_RDWR | O_NOCTTY | O_NONBLOCK);
+}
+
+- (int)closeFileDescriptor:(int)fileDescriptor { return close(fileDescriptor); }
+
+- (NSString *)name { return [self.path lastPathComponent]; }
+- (BOOL)supportsTerminalAttributes { return YES; }
+- (BOOL)supportsModemLines { return NO; }
+
+@end
+
+#pragma mark - ORSSerialLoopbackTransport
+
+static atomic_uint_fast32_t ORSSerialLoopbackTransportCount;
+
+@interface ORSSerialLoopbackTransport ()
+{
+	int _portFileDescriptor; // The port gets its own duplicate each time it's opened
+}
+
+@property (copy, readwrite) NSString *path;
+
+@end
+
+@implementation ORSSerialLoopbackTransport
+
+- (instancetype)init
+{
+	self = [super init];
+	if (self) {
+		_portFileDescriptor = _peerFileDescriptor = -1; // Nothing for -dealloc to close if this fails
+		int descriptors[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == -1) return nil;
+		_portFileDescriptor = descriptors[0];
+		_peerFileDescriptor = descriptors[1];
+		unsigned long index = atomic_fetch_add(&ORSSerialLoopbackTransportCount, 1);
+		_path = [NSString stringWithFormat:@"loopback-%lu", index];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_portFileDescriptor >= 0) close(_portFileDescriptor);
+	if (_peerFileDescriptor >= 0) close(_peerFileDescriptor);
+}
+
+- (int)openFileDescriptor
+{
+	int descriptor = dup(_portFileDescriptor);
+	if (descriptor == -1) return -1;
+	int flags = fcntl(descriptor, F_GETFL);
+	if (flags == -1 || fcntl(descriptor, F_SETFL, flags | O_NONBLOCK) == -1) {
+		int code = errno;
+		close(descriptor);
+		errno = code;
+		return -1;
+	}
+	return descriptor;
+}
+
+- (int)closeFileDescriptor:(int)fileDescriptor { return close(fileDescriptor); }
+
+- (NSString *)name { return self.path; }
+- (BOOL)supportsTerminalAttributes { return NO; }
+- (BOOL)supportsModemLines { return NO; }
+
+@end
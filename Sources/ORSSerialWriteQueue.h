@@ -0,0 +1,70 @@
+//
+//  ORSSerialWriteQueue.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ORSSerialStatistics;
+
+// Keep older versions of the compiler happy
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+typedef void(^ORSSerialWriteCompletionHandler)(NSError *error);
+
+/**
+ *  Private class used by ORSSerialPort to write data to a non-blocking file descriptor
+ *  without blocking the caller.
+ *
+ *  Data is queued as is (immutable data isn't copied) and written from a private queue
+ *  whenever a write dispatch source says the descriptor can take more. Everything queued
+ *  (up to maximumBatchLength) is written with a single writev() call, and partial writes just
+ *  advance an offset into the data at the head of the queue. Each piece of data can have
+ *  a completion handler, called once it has all been written or has failed.
+ *
+ *  All handlers are called on the write queue's private queue.
+ */
+@interface ORSSerialWriteQueue : NSObject
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor;
+
+// When targetQueue isn't NULL, the write queue's private queue targets it
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor targetQueue:(dispatch_queue_t)targetQueue NS_DESIGNATED_INITIALIZER;
+
+// Safe to call from any thread.
+- (void)enqueueData:(NSData *)data completionHandler:(ORSSerialWriteCompletionHandler)completionHandler;
+
+// Keeps writing what's already queued, as the file descriptor has room, for up to timeout. Data
+// still queued after that fails with ECANCELED, and so does data enqueued after this is called.
+// Returns immediately. completionHandler is called once everything has been written or failed,
+// after which the file descriptor is no longer used. The queue keeps itself alive until then.
+- (void)finishWritingWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(void))completionHandler;
+
+// Bytes queued but not yet written
+@property (readonly) NSUInteger queuedLength;
+
+// When queuedLength goes above this, highWaterMarkHandler is called with YES. It's called with NO
+// once queuedLength has dropped back to half of this or less.
+@property NSUInteger highWaterMark;
+@property (readonly, getter=isAboveHighWaterMark) BOOL aboveHighWaterMark;
+@property (copy) void (^highWaterMarkHandler)(BOOL aboveHighWaterMark);
+
+// When more than 0, data queued while idle waits up to this long for more data to write along
+// with it, unless maximumBatchLength bytes are queued first.
+@property NSTimeInterval coalescingInterval;
+@property NSUInteger maximumBatchLength; // Maximum bytes per write call. Default is NSUIntegerMax.
+
+@property (readonly) NSUInteger writeCallCount;
+@property (readonly) NSUInteger writeCallsSaved; // Extra calls writing each piece of data on its own would have taken
+
+// Write calls and stalls are recorded here, if set
+@property (strong) ORSSerialStatistics *statistics;
+
+// Called once for each write error. All data queued when it happens fails with the same error.
+@property (copy) void (^errorHandler)(NSError *error);
+
+@end
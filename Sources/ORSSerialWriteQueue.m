@@ -0,0 +1,291 @@
+//
+//  ORSSerialWriteQueue.m
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+
+#import "ORSSerialWriteQueue.h"
+#import "ORSSerialStatistics.h"
+#import <unistd.h>
+#import <sys/uio.h>
+
+static const int ORSSerialWriteQueueMaximumIOVectors = 64;
+
+#if OS_OBJECT_USE_OBJC && __has_feature(objc_arc)
+#define ORS_GCD_RELEASE(x)
+#else
+#define ORS_GCD_RELEASE(x) if (x) { dispatch_release(x); }
+#endif
+
+@interface ORSSerialWriteQueue ()
+{
+	int _fileDescriptor;
+	BOOL _writeSourceSuspended;
+	BOOL _cancelled; // Set once finishing has begun
+	BOOL _finished;
+	BOOL _coalescingTimerArmed;
+	NSUInteger _headOffset; // Bytes of the first queued data already written
+}
+
+@property (nonatomic, strong) NSMutableArray *queuedData;
+@property (nonatomic, strong) NSMutableArray *completionHandlers; // NSNull for data without one
+@property (nonatomic, copy) void (^finishHandler)(void);
+@property (readwrite) NSUInteger queuedLength;
+@property (readwrite, getter=isAboveHighWaterMark) BOOL aboveHighWaterMark;
+@property (readwrite) NSUInteger writeCallCount;
+@property (readwrite) NSUInteger writeCallsSaved;
+
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong) dispatch_queue_t queue;
+@property (nonatomic, strong) dispatch_source_t writeSource;
+@property (nonatomic, strong) dispatch_source_t coalescingTimer;
+#else
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic) dispatch_source_t writeSource;
+@property (nonatomic) dispatch_source_t coalescingTimer;
+#endif
+
+@end
+
+@implementation ORSSerialWriteQueue
+
+- (instancetype)init NS_UNAVAILABLE
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Use -[ORSSerialWriteQueue initWithFileDescriptor:]"];
+	return nil;
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor
+{
+	return [self initWithFileDescriptor:fileDescriptor targetQueue:NULL];
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor targetQueue:(dispatch_queue_t)targetQueue
+{
+	self = [super init];
+	if (self) {
+		_fileDescriptor = fileDescriptor;
+		_queuedData = [NSMutableArray array];
+		_completionHandlers = [NSMutableArray array];
+		_queue = dispatch_queue_create("com.openreelsoftware.ORSSerialPort.writeQueue", 0);
+		if (targetQueue) dispatch_set_target_queue(_queue, targetQueue);
+
+		// The source only runs while there's something to write
+		_writeSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_WRITE, fileDescriptor, 0, _queue);
+		__weak ORSSerialWriteQueue *weakSelf = self;
+		dispatch_source_set_event_handler(_writeSource, ^{ [weakSelf writeQueuedData]; });
+		_writeSourceSuspended = YES;
+
+		// Idle until armed by -enqueueData:completionHandler:
+		_coalescingTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, _queue);
+		dispatch_source_set_timer(_coalescingTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+		dispatch_source_set_event_handler(_coalescingTimer, ^{ [weakSelf coalescingIntervalDidElapse]; });
+		dispatch_resume(_coalescingTimer);
+
+		_maximumBatchLength = NSUIntegerMax;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_writeSource) {
+		dispatch_source_cancel(_writeSource);
+		if (_writeSourceSuspended) dispatch_resume(_writeSource); // Suspended sources can't be released
+		ORS_GCD_RELEASE(_writeSource);
+	}
+	if (_coalescingTimer) {
+		dispatch_source_cancel(_coalescingTimer);
+		ORS_GCD_RELEASE(_coalescingTimer);
+	}
+	ORS_GCD_RELEASE(_queue);
+}
+
+- (void)enqueueData:(NSData *)data completionHandler:(ORSSerialWriteCompletionHandler)completionHandler
+{
+	data = [data copy]; // Free unless data is mutable, in which case the caller might change it
+	dispatch_async(self.queue, ^{
+		if (_cancelled) {
+			if (completionHandler) completionHandler([NSError errorWithDomain:NSPOSIXErrorDomain code:ECANCELED userInfo:nil]);
+			return;
+		}
+		if (![data length]) {
+			if (completionHandler) completionHandler(nil);
+			return;
+		}
+
+		[self.queuedData addObject:data];
+		[self.completionHandlers addObject:completionHandler ? [completionHandler copy] : [NSNull null]];
+		self.queuedLength += [data length];
+		[self updateHighWaterMarkState];
+
+		// If the port was idle, give more data a chance to arrive so it can all go in one write
+		NSTimeInterval coalescingInterval = self.coalescingInterval;
+		if (!_writeSourceSuspended || _coalescingTimerArmed) {
+			if (_coalescingTimerArmed && self.queuedLength >= self.maximumBatchLength) [self coalescingIntervalDidElapse];
+		} else if (coalescingInterval > 0 && self.queuedLength < self.maximumBatchLength) {
+			_coalescingTimerArmed = YES;
+			uint64_t interval = (uint64_t)(coalescingInterval * NSEC_PER_SEC);
+			dispatch_source_set_timer(self.coalescingTimer, dispatch_time(DISPATCH_TIME_NOW, interval), DISPATCH_TIME_FOREVER, interval / 10);
+		} else {
+			[self resumeWriteSource];
+		}
+	});
+}
+
+- (void)finishWritingWithTimeout:(NSTimeInterval)timeout completionHandler:(void (^)(void))completionHandler
+{
+	dispatch_async(self.queue, ^{
+		if (_cancelled) {
+			if (completionHandler) completionHandler();
+			return;
+		}
+		_cancelled = YES;
+		self.finishHandler = completionHandler;
+
+		// What's left is written by the write source as usual, so nothing waits on a descriptor the
+		// other end has stopped reading. The coalescing timer becomes the deadline, and its handler
+		// keeps self alive until it's cancelled.
+		_coalescingTimerArmed = NO;
+		dispatch_source_set_event_handler(self.coalescingTimer, ^{ [self finishDraining]; });
+		uint64_t interval = (uint64_t)(MAX(timeout, 0) * NSEC_PER_SEC);
+		dispatch_source_set_timer(self.coalescingTimer, dispatch_time(DISPATCH_TIME_NOW, interval), DISPATCH_TIME_FOREVER, interval / 10);
+
+		if ([self.queuedData count]) {
+			[self resumeWriteSource];
+		} else {
+			[self finishDraining];
+		}
+	});
+}
+
+#pragma mark - Private
+
+- (void)resumeWriteSource
+{
+	if (!_writeSourceSuspended) return;
+	_writeSourceSuspended = NO;
+	dispatch_resume(self.writeSource);
+}
+
+- (void)coalescingIntervalDidElapse
+{
+	_coalescingTimerArmed = NO;
+	dispatch_source_set_timer(self.coalescingTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+	if (!_cancelled) [self resumeWriteSource];
+}
+
+// Runs on queue when the file descriptor has room for more data
+- (void)writeQueuedData
+{
+	struct iovec vectors[ORSSerialWriteQueueMaximumIOVectors];
+	NSUInteger maximumBatchLength = MAX(self.maximumBatchLength, (NSUInteger)1);
+	while ([self.queuedData count]) {
+		// Gather as much queued data as allowed into one call
+		int vectorCount = 0;
+		NSUInteger batchLength = 0;
+		for (NSData *data in self.queuedData) {
+			if (vectorCount == ORSSerialWriteQueueMaximumIOVectors || batchLength == maximumBatchLength) break;
+			NSUInteger offset = vectorCount ? 0 : _headOffset;
+			NSUInteger length = MIN([data length] - offset, maximumBatchLength - batchLength);
+			vectors[vectorCount].iov_base = (void *)((const uint8_t *)[data bytes] + offset);
+			vectors[vectorCount].iov_len = length;
+			vectorCount++;
+			batchLength += length;
+		}
+
+		ssize_t written = writev(_fileDescriptor, vectors, vectorCount);
+		self.writeCallCount++;
+		if (written < 0) {
+			int code = errno;
+			if (code == EINTR) continue;
+			if (code == EAGAIN) {
+				[self.statistics recordWriteStall];
+				return; // Wait until there's room
+			}
+			// Whatever went wrong will affect everything queued, so it's all failed, but reported once
+			NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:code userInfo:nil];
+			while ([self.queuedData count]) [self finishHeadWithError:error];
+			[self updateHighWaterMarkState];
+			if (self.errorHandler) self.errorHandler(error);
+			break;
+		}
+		[self.statistics recordWriteOfLength:written];
+
+		// Writing each piece of data separately would have taken a call for every one this touched
+		NSUInteger touchedCount = 0;
+		while (written > 0) {
+			NSUInteger remaining = [self.queuedData[0] length] - _headOffset;
+			touchedCount++;
+			if ((NSUInteger)written < remaining) {
+				_headOffset += written;
+				self.queuedLength -= written;
+				break;
+			}
+			written -= remaining;
+			[self finishHeadWithError:nil];
+		}
+		if (touchedCount > 1) self.writeCallsSaved += touchedCount - 1;
+		[self updateHighWaterMarkState];
+	}
+
+	if (_cancelled) {
+		[self finishDraining];
+		return;
+	}
+
+	// Nothing left to write, so stop listening for room until something is queued
+	if (!_writeSourceSuspended) {
+		_writeSourceSuspended = YES;
+		dispatch_suspend(self.writeSource);
+	}
+}
+
+// Called on queue once finishing has begun, when everything has been written or the deadline has passed
+- (void)finishDraining
+{
+	if (_finished) return;
+	_finished = YES;
+	dispatch_source_cancel(self.coalescingTimer);
+	dispatch_source_cancel(self.writeSource);
+	[self resumeWriteSource]; // Suspended sources can't be released
+
+	NSError *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ECANCELED userInfo:nil];
+	while ([self.queuedData count]) [self finishHeadWithError:error];
+
+	void (^finishHandler)(void) = self.finishHandler;
+	self.finishHandler = nil;
+	if (finishHandler) finishHandler();
+}
+
+- (void)finishHeadWithError:(NSError *)error
+{
+	NSData *data = self.queuedData[0];
+	id completionHandler = self.completionHandlers[0];
+	self.queuedLength -= [data length] - _headOffset;
+	_headOffset = 0;
+	[self.queuedData removeObjectAtIndex:0];
+	[self.completionHandlers removeObjectAtIndex:0];
+
+	if (completionHandler != [NSNull null]) ((ORSSerialWriteCompletionHandler)completionHandler)(error);
+}
+
+- (void)updateHighWaterMarkState
+{
+	NSUInteger queuedLength = self.queuedLength;
+	NSUInteger highWaterMark = self.highWaterMark;
+	BOOL above = self.isAboveHighWaterMark;
+	if (!above && queuedLength > highWaterMark) {
+		above = YES;
+	} else if (above && queuedLength <= highWaterMark / 2) {
+		above = NO;
+	} else {
+		return;
+	}
+
+	self.aboveHighWaterMark = above;
+	if (self.highWaterMarkHandler) self.highWaterMarkHandler(above);
+}
+
+@end
@@ -27,4 +27,7 @@
 #import <ORSSerial/ORSSerialPort.h>
 #import <ORSSerial/ORSSerialPortManager.h>
 #import <ORSSerial/ORSSerialRequest.h>
-#import <ORSSerial/ORSSerialPacketDescriptor.h>
\ No newline at end of file
+#import <ORSSerial/ORSSerialPacketDescriptor.h>
+#import <ORSSerial/ORSSerialIncrementalPacketEvaluator.h>
+#import <ORSSerial/ORSSerialTransport.h>
+#import <ORSSerial/ORSSerialPortStatistics.h>
\ No newline at end of file
@@ -0,0 +1,120 @@
+//
+//  ORSSerialIncrementalPacketEvaluator.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_END
+#define nullable
+#define nonnullable
+#define __nullable
+#endif
+
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Result of passing received data to an ORSSerialIncrementalPacketEvaluator.
+ */
+typedef NS_ENUM(NSUInteger, ORSSerialPacketEvaluation) {
+	ORSSerialPacketEvaluationNeedsMoreData = 0, // No packet ends in the data yet
+	ORSSerialPacketEvaluationFoundPacket, // The evaluator's range is a packet
+	ORSSerialPacketEvaluationDiscard, // The first range.length bytes can't be part of a packet
+};
+
+/**
+ *  An incremental evaluator finds packets in received data as it arrives, keeping whatever state
+ *  it needs between calls, instead of being asked whether each possible packet is valid after every
+ *  byte like an ORSSerialPacketEvaluator block. A port creates an evaluator for each packet descriptor
+ *  created with -[ORSSerialPacketDescriptor initWithMaximumPacketLength:userInfo:incrementalEvaluatorFactory:]
+ *  that's installed on it, and only calls it on the port's request handling queue.
+ *
+ *  Each call is passed the pending bytes: those received since the end of the last packet, less any
+ *  that have been discarded. Bytes before newBytesOffset were passed to the previous call, so an
+ *  evaluator only needs to examine the rest. When bytes are discarded, the remaining ones are passed
+ *  again with newBytesOffset reduced to match, even if no new data has been received.
+ *
+ *  If maximumPacketLength bytes are pending and the evaluator needs more data, the oldest byte is
+ *  discarded as though the evaluator had asked for it to be.
+ */
+@protocol ORSSerialIncrementalPacketEvaluator <NSObject>
+
+/**
+ *  Evaluates pending received data.
+ *
+ *  @param bytes          The pending bytes, oldest first. Only valid during the call.
+ *  @param length         The number of pending bytes.
+ *  @param newBytesOffset The offset of the first byte not passed to the previous call.
+ *  @param range          On return, if a packet was found, its range in bytes. Bytes before it are
+ *                        discarded, and bytes after it are passed to the next call as new bytes. To
+ *                        discard bytes, set range.length to the number to discard from the start.
+ *
+ *  @return ORSSerialPacketEvaluationFoundPacket when range is a complete packet (the earliest ending, if
+ *  there are several), ORSSerialPacketEvaluationDiscard to discard bytes, or ORSSerialPacketEvaluationNeedsMoreData.
+ */
+- (ORSSerialPacketEvaluation)evaluateBytes:(const uint8_t *)bytes
+									length:(NSUInteger)length
+							newBytesOffset:(NSUInteger)newBytesOffset
+									 range:(NSRange *)range;
+
+/**
+ *  Discards any state kept about pending bytes. Called after each packet is found, and when
+ *  the port discards partially received packets.
+ */
+- (void)reset;
+
+@end
+
+/**
+ *  Block returning a new incremental evaluator. Called once for each port (and each request)
+ *  using a descriptor, so that each has its own evaluator state.
+ */
+typedef id<ORSSerialIncrementalPacketEvaluator> __nonnull (^ORSSerialIncrementalPacketEvaluatorFactory)(void);
+
+/**
+ *  Adapts a BOOL(^)(NSData *) packet evaluator block to the ORSSerialIncrementalPacketEvaluator protocol.
+ *
+ *  As for descriptors created with -[ORSSerialPacketDescriptor initWithMaximumPacketLength:userInfo:responseEvaluator:],
+ *  the packet found is the shortest valid one ending at the earliest byte possible. Every pending window
+ *  ending at each new byte is passed to the block, so this is only as fast as using the block directly,
+ *  but lets existing evaluator blocks be used anywhere an incremental evaluator is expected.
+ */
+@interface ORSSerialBlockPacketEvaluator : NSObject <ORSSerialIncrementalPacketEvaluator>
+
+- (instancetype)initWithEvaluator:(BOOL(^)(NSData * __nullable inputData))evaluator NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The number of times the block has been called.
+ */
+@property (nonatomic, readonly) NSUInteger evaluatorInvocationCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -26,6 +26,12 @@
 
 #import <Foundation/Foundation.h>
 
+#ifdef SWIFTPM
+#import "ORSSerial/ORSSerialIncrementalPacketEvaluator.h"
+#else
+#import <ORSSerial/ORSSerialIncrementalPacketEvaluator.h>
+#endif
+
 // Keep older versions of the compiler happy
 #ifndef NS_ASSUME_NONNULL_BEGIN
 #define NS_ASSUME_NONNULL_BEGIN
@@ -47,6 +53,42 @@ NS_ASSUME_NONNULL_BEGIN
  */
 typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
 
+/**
+ * Block that returns the correlation tag carried by a valid packet (e.g. a sequence number
+ * parsed out of its header), or nil if it doesn't have one.
+ */
+typedef id __nullable (^ORSSerialPacketCorrelationTagExtractor)(NSData *packetData);
+
+/**
+ *  Byte order of the length field in packets described by a descriptor created with
+ *  -initWithSyncBytes:lengthFieldOffset:lengthFieldWidth:lengthFieldByteOrder:lengthAdjustment:maximumPacketLength:userInfo:
+ */
+typedef NS_ENUM(NSUInteger, ORSSerialPacketLengthFieldByteOrder) {
+	ORSSerialPacketLengthFieldBigEndian = 0,
+	ORSSerialPacketLengthFieldLittleEndian
+};
+
+/**
+ *  Byte stuffing scheme used to frame packets described by a descriptor created with
+ *  -initWithFraming:maximumPacketLength:userInfo:
+ */
+typedef NS_ENUM(NSUInteger, ORSSerialPacketFraming) {
+	ORSSerialPacketFramingNone = 0,
+	ORSSerialPacketFramingCOBS, // Consistent Overhead Byte Stuffing, with frames ending in 0x00
+	ORSSerialPacketFramingSLIP, // RFC 1055, with frames ending in END (0xC0)
+};
+
+/**
+ *  Checksum carried by packets described by a descriptor. The byte order of each is the one it's
+ *  conventionally sent in.
+ */
+typedef NS_ENUM(NSUInteger, ORSSerialPacketChecksumAlgorithm) {
+	ORSSerialPacketChecksumNone = 0,
+	ORSSerialPacketChecksumCRC16Modbus, // CRC-16/MODBUS, low byte first
+	ORSSerialPacketChecksumCRC16CCITT, // CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), high byte first
+	ORSSerialPacketChecksumCRC32, // CRC-32 as used by Ethernet and zlib, low byte first
+};
+
 /**
  *  An instance of ORSSerialPacketDescriptor is used to describe a packet format. ORSSerialPort
  *  can use these to "packetize" incoming data. Normally, bytes received by a serial port are
@@ -91,6 +133,27 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
 								   userInfo:(nullable id)userInfo
 						  responseEvaluator:(ORSSerialPacketEvaluator)responseEvaluator NS_DESIGNATED_INITIALIZER;
 
+/**
+ *  Creates an initializes an ORSSerialPacketDescriptor instance using incremental evaluators.
+ *
+ *  Rather than being asked whether each possible packet is valid after every byte, an incremental
+ *  evaluator is passed received data as it arrives, and says when a packet ends, or that bytes can
+ *  be discarded. This makes custom packet formats as fast to match as the built in ones.
+ *
+ *  @param maxPacketLength The maximum length of a valid packet. This value _must_ be correctly specified.
+ *  @param userInfo        An arbitrary userInfo object. May be nil.
+ *  @param factory         A block returning a new evaluator. It's called for each port the descriptor
+ *                         is installed on, and each request using it, so evaluators can keep state.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ *
+ *  @see ORSSerialIncrementalPacketEvaluator
+ *  @see ORSSerialBlockPacketEvaluator
+ */
+- (instancetype)initWithMaximumPacketLength:(NSUInteger)maxPacketLength
+								   userInfo:(nullable id)userInfo
+				incrementalEvaluatorFactory:(ORSSerialIncrementalPacketEvaluatorFactory)factory;
+
 /**
  *	Creates an initializes an ORSSerialPacketDescriptor instance using fixed packet data.
  *
@@ -162,6 +225,11 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
  *  If your packets are not naturally represented as strings, consider using
  *  -initWithMaximumPacketLength:userInfo:responseEvaluator: instead.
  *
+ *  Patterns made of literals, character classes, groups, alternation and quantifiers are compiled
+ *  so that received data can be matched a byte at a time, which is much faster than evaluating the regex
+ *  on every possible packet. Patterns using anchors (other than a leading `^`), lookaround, back references,
+ *  or options other than those affecting `.` are supported, but are slower to match.
+ *
  *  @param regex    An NSRegularExpression instance for which valid packets are a match.
  *  @param maxPacketLength The maximum length of a valid packet. This value _must_ be correctly specified.
  *  @param userInfo An arbitrary userInfoObject. May be nil.
@@ -172,6 +240,61 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
 					  maximumPacketLength:(NSUInteger)maxPacketLength
 								 userInfo:(nullable id)userInfo;
 
+/**
+ *  Creates an initializes an ORSSerialPacketDescriptor instance for binary packets that start with
+ *  a fixed sync sequence and have a header containing the packet's length.
+ *
+ *  A packet starts with syncBytes, and its length in bytes (including the sync bytes, header and any
+ *  trailer) is the value of the length field plus lengthAdjustment. For example, for packets made up
+ *  of a 2 byte sync word, a 1 byte length field counting only the payload, the payload, and a 2 byte
+ *  checksum, use a lengthFieldOffset of 2, a lengthFieldWidth of 1 and a lengthAdjustment of 5.
+ *
+ *  Received data is framed by tracking where each packet will end once its header has been received,
+ *  rather than by evaluating every possible packet after each byte. Every occurrence of the sync bytes
+ *  is tracked, so a corrupted packet or a false sync doesn't prevent the next packet being found.
+ *
+ *  @param syncBytes         The bytes every packet starts with. Must not be empty.
+ *  @param lengthFieldOffset The offset of the length field from the start of the packet.
+ *  @param lengthFieldWidth  The size of the length field, in bytes. Must be 1 to 4.
+ *  @param byteOrder         The byte order of the length field.
+ *  @param lengthAdjustment  Added to the value of the length field to give the packet's length.
+ *  @param maxPacketLength   The maximum length of a valid packet. Packets whose length field gives
+ *                           a longer length are ignored.
+ *  @param userInfo          An arbitrary userInfo object. May be nil.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ */
+- (instancetype)initWithSyncBytes:(NSData *)syncBytes
+				lengthFieldOffset:(NSUInteger)lengthFieldOffset
+				 lengthFieldWidth:(NSUInteger)lengthFieldWidth
+			 lengthFieldByteOrder:(ORSSerialPacketLengthFieldByteOrder)byteOrder
+				 lengthAdjustment:(NSInteger)lengthAdjustment
+			  maximumPacketLength:(NSUInteger)maxPacketLength
+						 userInfo:(nullable id)userInfo;
+
+/**
+ *  Creates an initializes an ORSSerialPacketDescriptor instance for packets framed using COBS or SLIP
+ *  byte stuffing.
+ *
+ *  Packets delivered to the port's delegate, and responses to requests using the descriptor, are
+ *  the decoded payloads, without delimiters or escapes. Use -encodedDataForPacket: to frame data
+ *  before passing it to -[ORSSerialPort sendData:].
+ *
+ *  Frame delimiters are searched for a chunk of received data at a time, so framing is much faster
+ *  than evaluating every possible packet after each byte. Empty frames and frames that aren't
+ *  validly encoded are ignored.
+ *
+ *  @param framing         The byte stuffing scheme. Must not be ORSSerialPacketFramingNone.
+ *  @param maxPacketLength The maximum length of a decoded payload. The descriptor's maximumPacketLength
+ *                         is the longest frame such a payload can be encoded into.
+ *  @param userInfo        An arbitrary userInfo object. May be nil.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ */
+- (instancetype)initWithFraming:(ORSSerialPacketFraming)framing
+			maximumPacketLength:(NSUInteger)maxPacketLength
+					   userInfo:(nullable id)userInfo;
+
 /**
  *  Can be used to determine if a block of data is a valid packet matching the descriptor encapsulated
  *  by the receiver.
@@ -185,12 +308,110 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
 /**
  *  Can be used to determine and extract a packet from a buffer, matching up to the end of the buffer.
  *
+ *  For descriptors created with -initWithFraming:maximumPacketLength:userInfo:, the frame ending
+ *  the buffer is decoded, and its payload is returned. For line descriptors, the line ending the
+ *  buffer is returned. For descriptors with incremental evaluators, the whole buffer is evaluated,
+ *  and the last packet found is returned if it ends the buffer.
+ *
  *  @param buffer Data received from serial port.
  *
  *  @return Data corresponding to valid packet, or nil.
  */
 - (nullable NSData *)packetMatchingAtEndOfBuffer:(nullable NSData *)buffer;
 
+/**
+ *  Creates an initializes an ORSSerialPacketDescriptor instance for lines of text (or other data)
+ *  ending with a terminator, e.g. "\r\n".
+ *
+ *  Each packet is a line, including its terminator, made up of the bytes received since the end of
+ *  the previous line. Empty lines are ignored, as are lines longer than maxPacketLength.
+ *
+ *  This matches the same lines as a prefix/suffix descriptor for which every line is a packet, but
+ *  received data is searched for terminators a chunk at a time, so it's much faster.
+ *
+ *  @param lineTerminator  The bytes ending each line. Must not be empty.
+ *  @param maxPacketLength The maximum length of a line, including its terminator.
+ *  @param userInfo        An arbitrary userInfo object. May be nil.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ *
+ *  @see -initWithLineTerminatorString:maximumPacketLength:userInfo:
+ */
+- (instancetype)initWithLineTerminator:(NSData *)lineTerminator
+				   maximumPacketLength:(NSUInteger)maxPacketLength
+							  userInfo:(nullable id)userInfo;
+
+/**
+ *  Creates an initializes an ORSSerialPacketDescriptor instance for lines of text ending with
+ *  lineTerminatorString, which is assumed to be an ASCII or UTF8 string.
+ *
+ *  @param lineTerminatorString The string ending each line, e.g. @"\r\n". Must not be empty.
+ *  @param maxPacketLength      The maximum length of a line in bytes, including its terminator.
+ *  @param userInfo             An arbitrary userInfo object. May be nil.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ *
+ *  @see -initWithLineTerminator:maximumPacketLength:userInfo:
+ */
+- (instancetype)initWithLineTerminatorString:(NSString *)lineTerminatorString
+						 maximumPacketLength:(NSUInteger)maxPacketLength
+									userInfo:(nullable id)userInfo;
+
+/**
+ *  Creates a packet descriptor describing the same packets as descriptor, which also carry a checksum.
+ *
+ *  Packets must satisfy the descriptor's evaluator and carry a valid checksum, so evaluator blocks
+ *  don't need to check it themselves. The checksum is only computed for candidate packets, rather than
+ *  for every window of received data, and for length prefixed packets, it's computed as data arrives.
+ *
+ *  For descriptors created with -initWithFraming:maximumPacketLength:userInfo:, offsets are
+ *  within the decoded payload.
+ *
+ *  The new descriptor has the same userInfo as descriptor, but its own uuid.
+ *
+ *  @param descriptor    The descriptor describing packets without regard to their checksum.
+ *  @param algorithm     The checksum algorithm, or ORSSerialPacketChecksumNone.
+ *  @param offset        The offset of the first byte covered by the checksum, e.g. to skip sync bytes.
+ *  @param trailerLength The number of bytes following the checksum at the end of the packet, which
+ *                       aren't covered by it. The checksum covers every byte from offset up to itself.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ */
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+					   checksumAlgorithm:(ORSSerialPacketChecksumAlgorithm)algorithm
+						  checksumOffset:(NSUInteger)offset
+				   checksumTrailerLength:(NSUInteger)trailerLength;
+
+/**
+ *  Creates a packet descriptor describing the same packets as descriptor, whose correlation tags
+ *  are extracted by correlationTagExtractor. Use it as a request's response descriptor to match
+ *  responses to several pending requests by tag.
+ *
+ *  The new descriptor has the same userInfo as descriptor, but its own uuid.
+ *
+ *  @param descriptor              The descriptor describing the responses.
+ *  @param correlationTagExtractor A block returning the correlation tag carried by a response.
+ *
+ *  @return An initizliaized ORSSerialPacketDesciptor instance.
+ *
+ *  @see correlationTagExtractor
+ */
+- (instancetype)initWithPacketDescriptor:(ORSSerialPacketDescriptor *)descriptor
+				 correlationTagExtractor:(ORSSerialPacketCorrelationTagExtractor)correlationTagExtractor;
+
+/**
+ *  Encodes a packet for sending to a device expecting packets described by the receiver.
+ *
+ *  For descriptors created with -initWithFraming:maximumPacketLength:userInfo:, packet is
+ *  byte stuffed and delimited. SLIP frames are preceded by END as well as ending with it.
+ *  For other descriptors, packet is returned unchanged.
+ *
+ *  @param packet The payload to send.
+ *
+ *  @return The data to pass to -[ORSSerialPort sendData:].
+ */
+- (NSData *)encodedDataForPacket:(NSData *)packet;
+
 /**
  *  The fixed packetData for packets described by the receiver. Will be nil for packet
  *  descriptors not created using -initWithPacketData:userInfo:
@@ -215,6 +436,66 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
  */
 @property (nonatomic, strong, readonly, nullable) NSRegularExpression *regularExpression;
 
+/**
+ *  The sync bytes that packets described by the receiver start with. Will be nil for packet descriptors
+ *  not created using -initWithSyncBytes:lengthFieldOffset:lengthFieldWidth:lengthFieldByteOrder:lengthAdjustment:maximumPacketLength:userInfo:.
+ *  The length field properties below are only meaningful if this is non-nil.
+ */
+@property (nonatomic, strong, readonly, nullable) NSData *syncBytes;
+
+/**
+ *  The offset of the length field from the start of packets described by the receiver.
+ */
+@property (nonatomic, readonly) NSUInteger lengthFieldOffset;
+
+/**
+ *  The size in bytes of the length field in packets described by the receiver.
+ */
+@property (nonatomic, readonly) NSUInteger lengthFieldWidth;
+
+/**
+ *  The byte order of the length field in packets described by the receiver.
+ */
+@property (nonatomic, readonly) ORSSerialPacketLengthFieldByteOrder lengthFieldByteOrder;
+
+/**
+ *  Added to the value of the length field to give the length of packets described by the receiver.
+ */
+@property (nonatomic, readonly) NSInteger lengthAdjustment;
+
+/**
+ *  Returns the evaluators used to find packets described by the receiver. Will be nil for packet
+ *  descriptors not created using -initWithMaximumPacketLength:userInfo:incrementalEvaluatorFactory:.
+ */
+@property (nonatomic, copy, readonly, nullable) ORSSerialIncrementalPacketEvaluatorFactory incrementalEvaluatorFactory;
+
+/**
+ *  The terminator ending lines described by the receiver. Will be nil for packet descriptors not created
+ *  using -initWithLineTerminator:maximumPacketLength:userInfo: or -initWithLineTerminatorString:maximumPacketLength:userInfo:.
+ */
+@property (nonatomic, strong, readonly, nullable) NSData *lineTerminator;
+
+/**
+ *  The byte stuffing scheme framing packets described by the receiver. ORSSerialPacketFramingNone for
+ *  packet descriptors not created using -initWithFraming:maximumPacketLength:userInfo:.
+ */
+@property (nonatomic, readonly) ORSSerialPacketFraming framing;
+
+/**
+ *  The checksum carried by packets described by the receiver. ORSSerialPacketChecksumNone by default.
+ */
+@property (nonatomic, readonly) ORSSerialPacketChecksumAlgorithm checksumAlgorithm;
+
+/**
+ *  The offset of the first byte covered by the checksum.
+ */
+@property (nonatomic, readonly) NSUInteger checksumOffset;
+
+/**
+ *  The number of bytes following the checksum at the end of packets described by the receiver.
+ */
+@property (nonatomic, readonly) NSUInteger checksumTrailerLength;
+
 /**
  *  The maximum lenght of a packet described by the receiver.
  */
@@ -231,6 +512,18 @@ typedef BOOL(^ORSSerialPacketEvaluator)(NSData * __nullable inputData);
  */
 @property (nonatomic, strong, readonly) NSUUID *uuid;
 
+/**
+ *  Extracts the correlation tag from responses described by the receiver, so that responses
+ *  to several pending requests can be told apart. nil by default.
+ *
+ *  When a request's response descriptor has a correlation tag extractor and the request has
+ *  a correlationTag, only a response with an equal tag is accepted as its response, regardless
+ *  of the order responses arrive in.
+ *
+ *  @see -initWithPacketDescriptor:correlationTagExtractor:
+ */
+@property (nonatomic, copy, readonly, nullable) ORSSerialPacketCorrelationTagExtractor correlationTagExtractor;
+
 @end
 
 NS_ASSUME_NONNULL_END
\ No newline at end of file
@@ -35,6 +35,7 @@
 #define nullable
 #define nonnullable
 #define __nullable
+#define null_resettable
 #endif
 
 #ifndef NS_DESIGNATED_INITIALIZER
@@ -57,9 +58,11 @@ typedef NS_ENUM(NSUInteger, ORSSerialPortParity) {
 };
 
 @protocol ORSSerialPortDelegate;
+@protocol ORSSerialTransport;
 
 @class ORSSerialRequest;
 @class ORSSerialPacketDescriptor;
+@class ORSSerialPortStatistics;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -163,6 +166,18 @@ NS_ASSUME_NONNULL_BEGIN
  */
 + (nullable ORSSerialPort *)serialPortWithDevice:(io_object_t)device;
 
+/**
+ *  Returns an `ORSSerialPort` instance that reads from and writes to `transport`
+ *  instead of a serial port device.
+ *
+ *  @param transport The transport to use.
+ *
+ *  @return An initalized `ORSSerialPort` instance.
+ *
+ *  @see -initWithTransport:
+ */
++ (ORSSerialPort *)serialPortWithTransport:(id<ORSSerialTransport>)transport;
+
 /**
  *  Returns an `ORSSerialPort` instance representing the serial port at `devicePath`.
  *
@@ -196,6 +211,23 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable instancetype)initWithDevice:(io_object_t)device;
 
+/**
+ *  Returns an `ORSSerialPort` instance that reads from and writes to `transport`
+ *  instead of a serial port device.
+ *
+ *  This is mainly useful for testing and benchmarking code that uses ORSSerialPort
+ *  without hardware, e.g. with an `ORSSerialPseudoTerminalTransport` or an
+ *  `ORSSerialLoopbackTransport`. The returned port's `path` and `name` are the
+ *  transport's, and its `IOKitDevice` is 0.
+ *
+ *  @param transport The transport to use.
+ *
+ *  @return An initalized `ORSSerialPort` instance.
+ *
+ *  @see +serialPortWithTransport:
+ */
+- (instancetype)initWithTransport:(id<ORSSerialTransport>)transport;
+
 /** ---------------------------------------------------------------------------------------
  * @name Opening and Closing
  *  ---------------------------------------------------------------------------------------
@@ -239,40 +271,60 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  *  Sends data out through the serial port represented by the receiver.
  *
- *  This method attempts to send all data synchronously. That is, the method
- *  will not return until all passed in data has been sent, or an error has occurred.
+ *  This method returns immediately. The data is added to the end of the port's write
+ *  queue, and written in the background as fast as the port can take it. Data is always
+ *  sent in the order it was passed to this method.
  *
- *  If an error occurs, the ORSSerialPortDelegate method `-serialPort:didEncounterError:` will
- *  be called. The exception to this is if sending data fails because the port
+ *  If an error occurs while writing, the ORSSerialPortDelegate method `-serialPort:didEncounterError:`
+ *  will be called. The exception to this is if sending data fails because the port
  *  is closed. In that case, this method returns NO, but `-serialPort:didEncounterError:`
  *  is *not* called. You can ensure that the port is open by calling `-isOpen` before 
  *  calling this method.
  *
- *  @note This method can take a long time to return when a very large amount of data
- *  is passed in, due to the relatively slow nature of serial communication. It is better
- *  to send data in discrete short packets if possible.
+ *  @note Immutable data is queued as is, not copied, so there's no need to split up large
+ *  amounts of data. Data still queued when the port is closed is written before it closes,
+ *  as long as that takes no more than a couple of seconds. Closing never waits indefinitely
+ *  for a port that has stopped accepting data.
+ *  Use -queuedWriteLength and -writeHighWaterMark to avoid queueing data faster than the
+ *  port can send it.
  *
  *  @param data An `NSData` object containing the data to be sent.
  *
- *  @return YES if sending data succeeded, NO if an error occurred.
+ *  @return YES if the data was queued to be sent, NO if the port is closed.
  */
 - (BOOL)sendData:(NSData *)data;
 
+/**
+ *  Sends data out through the serial port represented by the receiver, and calls
+ *  completionHandler once it has all been written.
+ *
+ *  Like -sendData:, this method returns immediately.
+ *
+ *  @param data              An `NSData` object containing the data to be sent.
+ *  @param completionHandler Called on delegateQueue once all of data has been written to the port,
+ *  with a nil error, or once writing it has failed. If the port is closed before the data could be
+ *  written, the error's code is ECANCELED. Not called if this method returns NO.
+ *
+ *  @return YES if the data was queued to be sent, NO if the port is closed.
+ */
+- (BOOL)sendData:(NSData *)data completionHandler:(nullable void (^)(NSError * __nullable error))completionHandler;
+
 /**
  *  Sends the data in request, and begins watching for a valid response to the request,
  *  to be delivered to the delegate.
  *
- *  If the receiver already has one or more pending requests, the request is queued to be
- *  sent after all previous requests have received valid responses or have timed out
+ *  If the receiver already has maximumPendingRequestCount pending requests, the request is queued to be
+ *  sent once one of them has received a valid response or has timed out
  *  and this method will return YES. If there are no pending requests, the request
  *  is sent immediately and NO is returned if an error occurs.
  *
- *  @note This method calls through to -sendData:, and the same caveat
- *  about it taking a long time to send very large requests applies.
+ *  @note This method calls through to -sendData:, so the request's data is sent in the
+ *  background, after any data already in the write queue.
  *
  *  @param request An ORSSerialRequest instance including the data to be sent.
  *
- *  @return YES if sending the request's data succeeded, NO if an error occurred.
+ *  @return YES if the request's data was queued to be sent, NO if the port is closed or the
+ *  request's deadline has already passed.
  */
 - (BOOL)sendRequest:(ORSSerialRequest *)request;
 
@@ -314,6 +366,10 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param descriptor An ORSerialPacketDescriptor instance describing the packets the receiver
  *  should listen for.
  *
+ *  @note This method may be called on any thread. It doesn't wait for received data to be
+ *  parsed, so descriptors can be added and removed at a high rate without holding up reception.
+ *  Packets are matched against the new set of descriptors starting with the next data received.
+ *
  *  @see -stopListeningForPacketsMatchingDescriptor:
  *  @see -serialPort:didReceivePacket:matchingDescriptor:
  */
@@ -344,6 +400,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, weak, nullable) id<ORSSerialPortDelegate> delegate;
 
+/**
+ *  The queue on which delegate methods are called, and on which Key Value Observing
+ *  notifications for CTS, DSR and DCD are posted. The default is the main queue.
+ *  Setting this property to nil restores the default.
+ *
+ *  Using a background queue avoids funneling every port's data and packets through the
+ *  main thread, which is useful in applications without a user interface. The queue
+ *  must be a serial queue, so callbacks are made one at a time and in order.
+ *  This property should be set before the port is opened.
+ */
+#if OS_OBJECT_USE_OBJC
+@property (nonatomic, strong, null_resettable) dispatch_queue_t delegateQueue;
+#else
+@property (nonatomic, null_resettable) dispatch_queue_t delegateQueue;
+#endif
+
 /** ---------------------------------------------------------------------------------------
  * @name Request/Response Properties
  *  ---------------------------------------------------------------------------------------
@@ -351,16 +423,39 @@ NS_ASSUME_NONNULL_BEGIN
 
 /**
  *  The previously-sent request for which the port is awaiting a response, or nil
- *  if there is no pending request.
+ *  if there is no pending request. When more than one request is pending, this is
+ *  the one that was sent first.
  *
  *	This property can be observed using Key Value Observing.
  */
 @property (strong, readonly, nullable) ORSSerialRequest *pendingRequest;
 
+/**
+ *  All previously-sent requests for which the port is awaiting responses, in the order
+ *  they were sent, or an empty array if there are no pending requests.
+ *
+ *	This property can be observed using Key Value Observing.
+ */
+@property (strong, readonly) ORSArrayOf(ORSSerialRequest *) *pendingRequests;
+
+/**
+ *  The maximum number of requests that can be awaiting responses at once. The default is 1,
+ *  meaning each request is only sent once the previous one has been answered or has timed out.
+ *  Values less than 1 are treated as 1.
+ *
+ *  With a larger value, up to this many requests are sent without waiting, and each is
+ *  still timed out on its own. If a request has a correlationTag and its response descriptor
+ *  has a correlationTagExtractor, the response carrying that tag is matched to it no matter
+ *  what order responses arrive in. Other requests are assumed to be answered in the order
+ *  they were sent.
+ */
+@property (nonatomic) NSUInteger maximumPendingRequestCount;
+
 /**
  *  Requests in the queue waiting to be sent, or an empty array if there are no queued requests.
- *  Requests are sent from the queue in FIFO order. That is, the first request in the array
- *  returned by this property is the next request to be sent.
+ *  Requests with a higher priority are sent first, and requests with the same priority are sent
+ *  in FIFO order. The first request in the array returned by this property is the next request
+ *  to be sent, unless its deadline passes first.
  *
  *	This property can be observed using Key Value Observing.
  *
@@ -381,6 +476,18 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, strong, readonly) ORSArrayOf(ORSSerialPacketDescriptor *) *packetDescriptors;
 
+/**
+ *  If YES, received data that's part of a packet or response is claimed by it. No packet or
+ *  response delivered afterwards includes any of that data, and packets other descriptors had
+ *  partially received in it are discarded. This is useful when installed descriptors can match
+ *  overlapping data, to keep the others from finding spurious packets in data already
+ *  delivered.
+ *
+ *  The default is NO, in which case each descriptor, and the pending requests' response
+ *  descriptors, find packets in all received data independently of each other.
+ */
+@property (nonatomic) BOOL usesExclusivePacketMatching;
+
 /** ---------------------------------------------------------------------------------------
  * @name Port Properties
  *  ---------------------------------------------------------------------------------------
@@ -401,6 +508,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (readonly) io_object_t IOKitDevice;
 
+/**
+ *  The transport the port reads from and writes to. (read-only)
+ */
+@property (strong, readonly) id<ORSSerialTransport> transport;
+
 /**
  *  The name of the serial port. 
  *  
@@ -462,6 +574,77 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic) BOOL allowsNonStandardBaudRates;
 
+/**
+ *  The maximum number of bytes read from the port at once. The default is 16384.
+ *
+ *  Each read is sized to the amount of data waiting to be read, up to this length,
+ *  so at high baud rates a larger value means fewer reads and fewer, larger
+ *  calls to -serialPort:didReceiveData:. Values less than 1 are treated as 1.
+ */
+@property (nonatomic) NSUInteger maximumReadLength;
+
+/**
+ *  When YES, the port does its reading and writing on one of a small, fixed set of
+ *  queues shared by every port using it, rather than on queues of its own. This keeps
+ *  the number of threads doing serial I/O bounded when hundreds of ports are open at
+ *  once. The default is NO.
+ *
+ *  Changes take effect the next time the port is opened.
+ */
+@property (nonatomic) BOOL usesSharedReactor;
+
+/**
+ *  The number of bytes that have been passed to -sendData: but not yet written to the port.
+ */
+@property (nonatomic, readonly) NSUInteger queuedWriteLength;
+
+/**
+ *  The number of queued bytes beyond which the write queue is considered full. The default is 65536.
+ *
+ *  When queuedWriteLength goes above this, the delegate's -serialPort:writeQueueIsAboveHighWaterMark:
+ *  method is called with YES. It's called with NO once queuedWriteLength has dropped to half of this
+ *  or less. Data sent while the queue is full is still queued; this just tells you when to hold off.
+ */
+@property (nonatomic) NSUInteger writeHighWaterMark;
+
+/**
+ *  How long data sent while the port is idle waits for more data to be sent along with it,
+ *  in seconds. The default is 0, which writes data as soon as it's sent.
+ *
+ *  Everything waiting in the write queue is always written with a single `writev()` call, up to
+ *  maximumWriteBatchLength bytes. Setting a short interval (e.g. 0.0002) lets many small
+ *  back-to-back calls to -sendData: share one system call, at the cost of at most this much
+ *  added latency. The wait is cut short once maximumWriteBatchLength bytes are queued.
+ */
+@property (nonatomic) NSTimeInterval writeCoalescingInterval;
+
+/**
+ *  The maximum number of bytes written to the port in one system call. The default is 16384.
+ *  Values less than 1 are treated as 1.
+ */
+@property (nonatomic) NSUInteger maximumWriteBatchLength;
+
+/**
+ *  The number of write system calls made since the port was last opened.
+ */
+@property (nonatomic, readonly) NSUInteger writeCallCount;
+
+/**
+ *  The number of additional write system calls that would have been made since the port was
+ *  last opened if the data passed to each call to -sendData: had been written on its own.
+ */
+@property (nonatomic, readonly) NSUInteger writeCallsSavedByCoalescing;
+
+/**
+ *  A snapshot of the port's runtime statistics: bytes and reads in and out, packets
+ *  received per descriptor, request counts, and latency histograms.
+ *
+ *  Each access returns a new snapshot. Statistics are kept with atomic counters, so taking
+ *  a snapshot never waits for the port to finish what it's doing, and is cheap enough to
+ *  do often, e.g. to feed a monitoring system.
+ */
+@property (nonatomic, strong, readonly) ORSSerialPortStatistics *statistics;
+
 /**
  *  The number of stop bits. Values other than 1 or 2 are invalid.
  */
@@ -532,7 +715,8 @@ NS_ASSUME_NONNULL_BEGIN
  *  - YES means 1 or high state.
  *  - NO means 0 or low state.
  *
- *  This property is observable using Key Value Observing.
+ *  This property is observable using Key Value Observing. Changes are noticed within 50 ms,
+ *  and much sooner while the port's modem lines are changing.
  */
 @property (nonatomic, readonly) BOOL CTS;
 
@@ -542,7 +726,8 @@ NS_ASSUME_NONNULL_BEGIN
  *  - YES means 1 or high state.
  *  - NO means 0 or low state.
  *
- *  This property is observable using Key Value Observing.
+ *  This property is observable using Key Value Observing. Changes are noticed within 50 ms,
+ *  and much sooner while the port's modem lines are changing.
  */
 @property (nonatomic, readonly) BOOL DSR;
 
@@ -552,7 +737,8 @@ NS_ASSUME_NONNULL_BEGIN
  *  - YES means 1 or high state.
  *  - NO means 0 or low state.
  *
- *  This property is observable using Key Value Observing.
+ *  This property is observable using Key Value Observing. Changes are noticed within 50 ms,
+ *  and much sooner while the port's modem lines are changing.
  */
 @property (nonatomic, readonly) BOOL DCD;
 
@@ -564,9 +750,8 @@ NS_ASSUME_NONNULL_END
  *  The ORSSerialPortDelegate protocol defines methods to be implemented
  *  by the delegate of an `ORSSerialPort` object.
  *
- *  *Note*: All `ORSSerialPortDelegate` methods are always called on the main queue.
- *  If you need to handle them on a background queue, you must dispatch your handling
- *  to a background queue in your implementation of the delegate method.
+ *  *Note*: All `ORSSerialPortDelegate` methods are called on the port's `delegateQueue`,
+ *  which is the main queue unless you've set it to something else.
  */
 
 NS_ASSUME_NONNULL_BEGIN
@@ -604,15 +789,38 @@ NS_ASSUME_NONNULL_BEGIN
  *  @param serialPort		The `ORSSerialPort` instance representing the port that received `packetData`.
  *  @param packetData		The An `NSData` instance containing the received packet data.
  *  @param descriptor		The packet descriptor object for which packetData is a match.
+ *
+ *  @note packetData is an immutable view of the memory the packet was received into, rather than
+ *  a copy. Holding on to it keeps that memory alive, so if you keep packets around for a long
+ *  time, consider keeping a copy made with `+[NSData dataWithBytes:length:]` instead.
  */
 - (void)serialPort:(ORSSerialPort *)serialPort didReceivePacket:(NSData *)packetData matchingDescriptor:(ORSSerialPacketDescriptor *)descriptor;
 
+/**
+ *  Called instead of -serialPort:didReceivePacket:matchingDescriptor: if implemented, with
+ *  one or more packets matching descriptors installed with -startListeningForPacketsMatchingDescriptor:.
+ *
+ *  Packets received while a previous call is still waiting to be made are added to that call
+ *  rather than getting calls of their own. A delegate that can't keep up with incoming packets
+ *  therefore gets fewer calls with more packets in each, instead of falling further behind.
+ *  Packets are still delivered in the order they were received, and before any response that
+ *  was received after them.
+ *
+ *  @param serialPort	The `ORSSerialPort` instance representing the port that received the packets.
+ *  @param packets		The received packets, oldest first.
+ *  @param descriptors	The packet descriptor each packet matched, in the same order as packets.
+ */
+- (void)serialPort:(ORSSerialPort *)serialPort didReceivePackets:(ORSArrayOf(NSData *) *)packets matchingDescriptors:(ORSArrayOf(ORSSerialPacketDescriptor *) *)descriptors;
+
 /**
  *  Called when a valid, complete response is received for a previously sent request.
  *
  *  @param serialPort   The `ORSSerialPort` instance representing the port that received `responseData`.
  *  @param responseData The An `NSData` instance containing the received response data.
  *  @param request      The request to which the responseData is a respone.
+ *
+ *  @note Like packets, responseData is an immutable view of the memory it was received into.
+ *  See -serialPort:didReceivePacket:matchingDescriptor:.
  */
 - (void)serialPort:(ORSSerialPort *)serialPort didReceiveResponse:(NSData *)responseData toRequest:(ORSSerialRequest *)request;
 
@@ -627,6 +835,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)serialPort:(ORSSerialPort *)serialPort requestDidTimeout:(ORSSerialRequest *)request;
 
+/**
+ *  Called when a request's deadline passes before it could be sent. The request is dropped
+ *  without being sent.
+ *
+ *  @param serialPort The `ORSSerialPort` instance representing the port the request was sent to.
+ *  @param request    The request that expired.
+ */
+- (void)serialPort:(ORSSerialPort *)serialPort requestDidExpire:(ORSSerialRequest *)request;
+
 /**
  *  Called when an error occurs during an operation involving a serial port.
  *
@@ -647,6 +864,17 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)serialPort:(ORSSerialPort *)serialPort didEncounterError:(NSError *)error;
 
+/**
+ *  Called when the amount of data waiting to be sent goes above the port's writeHighWaterMark,
+ *  and again when it drops back to half of writeHighWaterMark or less.
+ *
+ *  Use this to stop sending data while the port can't keep up, and start again once it has caught up.
+ *
+ *  @param serialPort          The `ORSSerialPort` instance representing the port.
+ *  @param aboveHighWaterMark  YES if the write queue has just filled up, NO if it has just drained.
+ */
+- (void)serialPort:(ORSSerialPort *)serialPort writeQueueIsAboveHighWaterMark:(BOOL)aboveHighWaterMark;
+
 /**
  *  Called when a serial port is successfully opened.
  *
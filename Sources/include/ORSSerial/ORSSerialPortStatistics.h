@@ -0,0 +1,177 @@
+//
+//  ORSSerialPortStatistics.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_END
+#define nullable
+#define nonnullable
+#define __nullable
+#endif
+
+#ifndef ORSArrayOf
+	#if __has_feature(objc_generics)
+		#define ORSArrayOf(TYPE) NSArray<TYPE>
+	#else
+		#define ORSArrayOf(TYPE) NSArray
+	#endif
+#endif // #ifndef ORSArrayOf
+
+@class ORSSerialPacketDescriptor;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A snapshot of the distribution of a set of recorded values, e.g. latencies in
+ *  nanoseconds or read sizes in bytes.
+ *
+ *  Values are recorded into logarithmic buckets, so values returned by this class
+ *  are accurate to within about 6% (values less than 16 are exact).
+ */
+@interface ORSSerialHistogram : NSObject
+
+/**
+ *  Returns the value that `percentile` percent of recorded values are less than or
+ *  equal to, e.g. pass 99.9 for the 99.9th percentile. Returns 0 if nothing has been recorded.
+ */
+- (uint64_t)valueAtPercentile:(double)percentile;
+
+/**
+ *  The number of values recorded.
+ */
+@property (nonatomic, readonly) uint64_t count;
+
+/**
+ *  The smallest value recorded, or 0 if nothing has been recorded.
+ */
+@property (nonatomic, readonly) uint64_t minimum;
+
+/**
+ *  The largest value recorded, or 0 if nothing has been recorded.
+ */
+@property (nonatomic, readonly) uint64_t maximum;
+
+/**
+ *  The mean of the values recorded, or 0 if nothing has been recorded.
+ */
+@property (nonatomic, readonly) double mean;
+
+@end
+
+/**
+ *  A snapshot of an ORSSerialPort's runtime statistics, as returned by
+ *  `-[ORSSerialPort statistics]`. Counts are totals since the port was created.
+ */
+@interface ORSSerialPortStatistics : NSObject
+
+/**
+ *  The number of bytes read from the port.
+ */
+@property (nonatomic, readonly) uint64_t bytesReceived;
+
+/**
+ *  The number of reads that returned data.
+ */
+@property (nonatomic, readonly) uint64_t readCount;
+
+/**
+ *  The sizes, in bytes, of reads that returned data.
+ */
+@property (nonatomic, strong, readonly) ORSSerialHistogram *readSizes;
+
+/**
+ *  The number of bytes written to the port.
+ */
+@property (nonatomic, readonly) uint64_t bytesSent;
+
+/**
+ *  The number of write calls made.
+ */
+@property (nonatomic, readonly) uint64_t writeCount;
+
+/**
+ *  The number of times data was waiting to be written but the port had no room for it.
+ */
+@property (nonatomic, readonly) uint64_t writeStallCount;
+
+/**
+ *  The number of packets received, for all installed packet descriptors.
+ */
+@property (nonatomic, readonly) uint64_t packetCount;
+
+/**
+ *  The packet descriptors installed when the snapshot was taken.
+ */
+@property (nonatomic, copy, readonly) ORSArrayOf(ORSSerialPacketDescriptor *) *packetDescriptors;
+
+/**
+ *  Returns the number of packets received matching `descriptor`, or 0 if `descriptor`
+ *  wasn't installed when the snapshot was taken.
+ */
+- (uint64_t)packetCountForDescriptor:(ORSSerialPacketDescriptor *)descriptor;
+
+/**
+ *  The number of times a packet descriptor's evaluator block was called, for packet
+ *  descriptors and response descriptors that can't be matched incrementally.
+ */
+@property (nonatomic, readonly) uint64_t evaluatorInvocationCount;
+
+/**
+ *  The number of requests waiting to be sent.
+ */
+@property (nonatomic, readonly) NSUInteger queuedRequestCount;
+
+/**
+ *  The number of requests sent and waiting for responses.
+ */
+@property (nonatomic, readonly) NSUInteger pendingRequestCount;
+
+/**
+ *  The number of requests that timed out.
+ */
+@property (nonatomic, readonly) uint64_t requestTimeoutCount;
+
+/**
+ *  The number of requests dropped because their deadline passed before they were sent.
+ */
+@property (nonatomic, readonly) uint64_t requestExpirationCount;
+
+/**
+ *  Time from sending each request to receiving its response, in nanoseconds.
+ */
+@property (nonatomic, strong, readonly) ORSSerialHistogram *requestRoundTripTimes;
+
+/**
+ *  Time from reading the data that completed each packet or response to calling
+ *  the delegate with it, in nanoseconds.
+ */
+@property (nonatomic, strong, readonly) ORSSerialHistogram *receiveToDelegateLatencies;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -47,6 +47,15 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ *  Priorities used to decide which queued request is sent next.
+ */
+typedef NS_ENUM(NSUInteger, ORSSerialRequestPriority) {
+	ORSSerialRequestPriorityLow = 0,
+	ORSSerialRequestPriorityNormal,
+	ORSSerialRequestPriorityHigh
+};
+
 /**
  *  An ORSSerialRequest encapsulates a generic "request" command sent via the serial
  *  port. 
@@ -76,6 +85,48 @@ NS_ASSUME_NONNULL_BEGIN
 					  timeoutInterval:(NSTimeInterval)timeout
 					responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor;
 
+/**
+ *  Creates and initializes an ORSSerialRequest instance with a correlation tag.
+ *
+ *  @param dataToSend			The data to be sent on the serial port.
+ *  @param userInfo				An arbitrary userInfo object.
+ *  @param timeout				The maximum amount of time in seconds to wait for a response. Pass -1.0 to wait indefinitely.
+ *  @param responseDescriptor	A packet descriptor used to evaluate whether received data constitutes a valid response to the request.
+ *  May be nil. If responseDescriptor is nil, the request is assumed not to require a response, and the next request in the queue will
+ *  be sent immediately.
+ *  @param correlationTag		The tag the device includes in its response to this request. See correlationTag.
+ *
+ *  @return An initialized ORSSerialRequest instance.
+ */
++ (instancetype)requestWithDataToSend:(NSData *)dataToSend
+							 userInfo:(nullable id)userInfo
+					  timeoutInterval:(NSTimeInterval)timeout
+				   responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor
+					   correlationTag:(nullable id)correlationTag;
+
+/**
+ *  Creates and initializes an ORSSerialRequest instance with a priority and a deadline.
+ *
+ *  @param dataToSend			The data to be sent on the serial port.
+ *  @param userInfo				An arbitrary userInfo object.
+ *  @param timeout				The maximum amount of time in seconds to wait for a response. Pass -1.0 to wait indefinitely.
+ *  @param responseDescriptor	A packet descriptor used to evaluate whether received data constitutes a valid response to the request.
+ *  May be nil. If responseDescriptor is nil, the request is assumed not to require a response, and the next request in the queue will
+ *  be sent immediately.
+ *  @param correlationTag		The tag the device includes in its response to this request. See correlationTag.
+ *  @param priority				The request's priority. See priority.
+ *  @param deadline				The time after which the request is no longer worth sending, or nil. See deadline.
+ *
+ *  @return An initialized ORSSerialRequest instance.
+ */
++ (instancetype)requestWithDataToSend:(NSData *)dataToSend
+							 userInfo:(nullable id)userInfo
+					  timeoutInterval:(NSTimeInterval)timeout
+				   responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor
+					   correlationTag:(nullable id)correlationTag
+							 priority:(ORSSerialRequestPriority)priority
+							 deadline:(nullable NSDate *)deadline;
+
 /**
  *  Initializes an ORSSerialRequest instance.
  *
@@ -93,6 +144,48 @@ NS_ASSUME_NONNULL_BEGIN
 				   timeoutInterval:(NSTimeInterval)timeout
 				 responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor;
 
+/**
+ *  Initializes an ORSSerialRequest instance with a correlation tag.
+ *
+ *  @param dataToSend			The data to be sent on the serial port.
+ *  @param userInfo				An arbitrary userInfo object.
+ *  @param timeout				The maximum amount of time in seconds to wait for a response. Pass -1.0 to wait indefinitely.
+ *  @param responseDescriptor	A packet descriptor used to evaluate whether received data constitutes a valid response to the request.
+ *  May be nil. If responseDescriptor is nil, the request is assumed not to require a response, and the next request in the queue will
+ *  be sent immediately.
+ *  @param correlationTag		The tag the device includes in its response to this request. See correlationTag.
+ *
+ *  @return An initialized ORSSerialRequest instance.
+ */
+- (instancetype)initWithDataToSend:(NSData *)dataToSend
+						  userInfo:(nullable id)userInfo
+				   timeoutInterval:(NSTimeInterval)timeout
+				responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor
+					correlationTag:(nullable id)correlationTag;
+
+/**
+ *  Initializes an ORSSerialRequest instance with a priority and a deadline.
+ *
+ *  @param dataToSend			The data to be sent on the serial port.
+ *  @param userInfo				An arbitrary userInfo object.
+ *  @param timeout				The maximum amount of time in seconds to wait for a response. Pass -1.0 to wait indefinitely.
+ *  @param responseDescriptor	A packet descriptor used to evaluate whether received data constitutes a valid response to the request.
+ *  May be nil. If responseDescriptor is nil, the request is assumed not to require a response, and the next request in the queue will
+ *  be sent immediately.
+ *  @param correlationTag		The tag the device includes in its response to this request. See correlationTag.
+ *  @param priority				The request's priority. See priority.
+ *  @param deadline				The time after which the request is no longer worth sending, or nil. See deadline.
+ *
+ *  @return An initialized ORSSerialRequest instance.
+ */
+- (instancetype)initWithDataToSend:(NSData *)dataToSend
+						  userInfo:(nullable id)userInfo
+				   timeoutInterval:(NSTimeInterval)timeout
+				responseDescriptor:(nullable ORSSerialPacketDescriptor *)responseDescriptor
+					correlationTag:(nullable id)correlationTag
+						  priority:(ORSSerialRequestPriority)priority
+						  deadline:(nullable NSDate *)deadline;
+
 /**
  *  Data to be sent on the serial port when the receiver is sent.
  */
@@ -116,6 +209,33 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, strong, readonly, nullable) ORSSerialPacketDescriptor *responseDescriptor;
 
+/**
+ *  Identifies the response to this request when several requests are pending at once
+ *  (see ORSSerialPort's maximumPendingRequestCount).
+ *
+ *  If the response descriptor has a correlationTagExtractor, only a response whose extracted
+ *  tag is equal (-isEqual:) to this is accepted as the response to this request. Otherwise,
+ *  or if this is nil, responses are assumed to arrive in the order requests were sent.
+ */
+@property (nonatomic, strong, readonly, nullable) id correlationTag;
+
+/**
+ *  The request's priority. Queued requests with a higher priority are sent before those
+ *  with a lower one, and requests with the same priority are sent in the order they were
+ *  queued. The default is ORSSerialRequestPriorityNormal.
+ */
+@property (nonatomic, readonly) ORSSerialRequestPriority priority;
+
+/**
+ *  The time after which the request is no longer worth sending, or nil (the default) if it
+ *  doesn't have one.
+ *
+ *  A queued request is dropped without being sent as soon as its deadline passes, even if
+ *  it's waiting behind other requests, and the port's delegate is sent
+ *  -serialPort:requestDidExpire:.
+ */
+@property (nonatomic, strong, readonly, nullable) NSDate *deadline;
+
 /**
  *  Unique identifier for the request.
  */
@@ -0,0 +1,150 @@
+//
+//  ORSSerialTransport.h
+//  ORSSerialPort
+//
+//  Copyright (c) 2026 Open Reel Software. All rights reserved.
+//
+//	Permission is hereby granted, free of charge, to any person obtaining a
+//	copy of this software and associated documentation files (the
+//	"Software"), to deal in the Software without restriction, including
+//	without limitation the rights to use, copy, modify, merge, publish,
+//	distribute, sublicense, and/or sell copies of the Software, and to
+//	permit persons to whom the Software is furnished to do so, subject to
+//	the following conditions:
+//
+//	The above copyright notice and this permission notice shall be included
+//	in all copies or substantial portions of the Software.
+//
+//	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//	OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//	CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//	TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//	SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#import <Foundation/Foundation.h>
+
+// Keep older versions of the compiler happy
+#ifndef NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_BEGIN
+#define NS_ASSUME_NONNULL_END
+#define nullable
+#define nonnullable
+#define __nullable
+#endif
+
+#ifndef NS_DESIGNATED_INITIALIZER
+#define NS_DESIGNATED_INITIALIZER
+#endif
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A transport is what an ORSSerialPort reads from and writes to. It opens and closes
+ *  a file descriptor, and says which terminal features that descriptor supports.
+ *  Everything else (reading, writing, packet parsing and request handling) is done by
+ *  the port, the same way for every transport.
+ *
+ *  Ports created with `-initWithPath:` or `-initWithDevice:` use an
+ *  `ORSSerialFileDescriptorTransport`. Use `-[ORSSerialPort initWithTransport:]` to
+ *  create a port with a different transport, e.g. to drive a port from a pseudo
+ *  terminal or entirely in memory in tests and benchmarks.
+ */
+@protocol ORSSerialTransport <NSObject>
+
+/**
+ *  Opens the transport.
+ *
+ *  @return A non-blocking file descriptor that can be both read and written, or -1
+ *  with errno set if the transport couldn't be opened.
+ */
+- (int)openFileDescriptor;
+
+/**
+ *  Closes a file descriptor returned by `-openFileDescriptor`.
+ *
+ *  @return 0 on success, or -1 with errno set.
+ */
+- (int)closeFileDescriptor:(int)fileDescriptor;
+
+/**
+ *  The path of the device, or another name that uniquely identifies the transport.
+ */
+@property (copy, readonly) NSString *path;
+
+/**
+ *  The name of the transport, suitable for presenting to the user.
+ */
+@property (copy, readonly) NSString *name;
+
+/**
+ *  YES if the file descriptor is a terminal, so the port can set its baud rate,
+ *  parity, flow control, etc. When NO, those settings are kept but not applied.
+ */
+@property (readonly) BOOL supportsTerminalAttributes;
+
+/**
+ *  YES if the file descriptor has modem control lines. When NO, RTS and DTR
+ *  changes aren't applied, and CTS, DSR and DCD are always NO.
+ */
+@property (readonly) BOOL supportsModemLines;
+
+@end
+
+/**
+ *  Transport for a serial port device, opened by path. This is the transport used
+ *  by ports created with `-[ORSSerialPort initWithPath:]` and `-[ORSSerialPort initWithDevice:]`.
+ */
+@interface ORSSerialFileDescriptorTransport : NSObject <ORSSerialTransport>
+
+- (instancetype)initWithPath:(NSString *)path name:(NSString *)name NS_DESIGNATED_INITIALIZER;
+
+@end
+
+/**
+ *  Transport for a pseudo terminal created along with the transport. The port uses the
+ *  terminal (slave) side, and its path is the port's path.
+ *
+ *  A pseudo terminal behaves like a real serial port for termios settings, but has no
+ *  modem control lines.
+ */
+@interface ORSSerialPseudoTerminalTransport : NSObject <ORSSerialTransport>
+
+/**
+ *  Creates a new pseudo terminal. Returns nil if one couldn't be created.
+ */
+- (nullable instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The controlling (master) side of the pseudo terminal, open for as long as the
+ *  transport exists. Data written to it is received by the port, and data the port
+ *  sends can be read from it.
+ */
+@property (readonly) int peerFileDescriptor;
+
+@end
+
+/**
+ *  Transport that connects the port to one end of an in-memory stream (a Unix domain
+ *  socket pair), with no device or terminal involved.
+ *
+ *  Termios settings and modem lines aren't supported. Useful for running a port's
+ *  packet parsing and request handling at memory speed, without hardware.
+ */
+@interface ORSSerialLoopbackTransport : NSObject <ORSSerialTransport>
+
+/**
+ *  Creates a new stream. Returns nil if one couldn't be created.
+ */
+- (nullable instancetype)init NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The other end of the stream, open for as long as the transport exists. Data written
+ *  to it is received by the port, and data the port sends can be read from it.
+ */
+@property (readonly) int peerFileDescriptor;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -18,6 +18,31 @@
 
 @end
 
+// Incremental evaluator for packets starting with '!' and ending with ';'
+@interface ORSTIncrementalPacketEvaluator : NSObject <ORSSerialIncrementalPacketEvaluator>
+@end
+
+@implementation ORSTIncrementalPacketEvaluator
+
+- (ORSSerialPacketEvaluation)evaluateBytes:(const uint8_t *)bytes length:(NSUInteger)length newBytesOffset:(NSUInteger)newBytesOffset range:(NSRange *)range
+{
+	if (length && bytes[0] != '!') {
+		const uint8_t *start = memchr(bytes, '!', length);
+		*range = NSMakeRange(0, start ? (NSUInteger)(start - bytes) : length);
+		return ORSSerialPacketEvaluationDiscard;
+	}
+	for (NSUInteger i=MAX(newBytesOffset, (NSUInteger)1); i<length; i++) {
+		if (bytes[i] != ';') continue;
+		*range = NSMakeRange(0, i+1);
+		return ORSSerialPacketEvaluationFoundPacket;
+	}
+	return ORSSerialPacketEvaluationNeedsMoreData;
+}
+
+- (void)reset { }
+
+@end
+
 @interface ORSSerialPacketDescriptor_Tests : XCTestCase <ORSSerialPortDelegate>
 
 @property (nonatomic, strong) ORSSerialPort *port;
@@ -160,6 +185,231 @@
 	XCTAssertFalse([descriptor dataIsValidPacket:ORSTStringToData_(@"!foo;x")], @"Invalid packet not rejected by descriptor.");
 }
 
+- (void)testParsingWithRegex
+{
+	XCTestExpectation *expectation1 = [self expectationWithDescription:@"Regex parsing expectation 1"];
+	XCTestExpectation *expectation2 = [self expectationWithDescription:@"Regex parsing expectation 2"];
+	XCTestExpectation *expectation3 = [self expectationWithDescription:@"Regex parsing expectation 3"];
+	NSDictionary *userInfo = @{ORSTStringToData_(@"!ab;"): expectation1,
+							   [@"!\u00e9;" dataUsingEncoding:NSUTF8StringEncoding]: expectation2,
+							   ORSTStringToData_(@"!1_2;"): expectation3};
+	NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:@"!\\w+;" options:0 error:NULL];
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithRegularExpression:regex
+																					 maximumPacketLength:10
+																								userInfo:userInfo];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	// Non-ASCII characters are matched too
+	[self.port receiveData:ORSTStringToData_(@"!ab;x!")];
+	[self.port receiveData:[@"\u00e9;!!1" dataUsingEncoding:NSUTF8StringEncoding]];
+	[self.port receiveData:ORSTStringToData_(@"_2;")];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectations failed: %@", error);
+		}
+	}];
+}
+
+- (void)testParsingLines
+{
+	XCTestExpectation *expectation1 = [self expectationWithDescription:@"Line parsing expectation 1"];
+	XCTestExpectation *expectation2 = [self expectationWithDescription:@"Line parsing expectation 2"];
+	NSDictionary *userInfo = @{ORSTStringToData_(@"OK\r\n"): expectation1,
+							   ORSTStringToData_(@"TEMP 21.5\r\n"): expectation2};
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithLineTerminatorString:@"\r\n"
+																						maximumPacketLength:16
+																								   userInfo:userInfo];
+	XCTAssertEqualObjects([descriptor packetMatchingAtEndOfBuffer:ORSTStringToData_(@"OK\r\nTEMP 21.5\r\n")], ORSTStringToData_(@"TEMP 21.5\r\n"), @"Incorrect line matched at end of buffer.");
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	// Empty lines are ignored, and a terminator may be split across reads
+	[self.port receiveData:ORSTStringToData_(@"OK\r\nTEMP 2")];
+	[self.port receiveData:ORSTStringToData_(@"1.5\r")];
+	[self.port receiveData:ORSTStringToData_(@"\n\r\n")];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectations failed: %@", error);
+		}
+	}];
+}
+
+- (void)testIncrementalEvaluator
+{
+	XCTestExpectation *expectation1 = [self expectationWithDescription:@"Incremental evaluator parsing expectation 1"];
+	XCTestExpectation *expectation2 = [self expectationWithDescription:@"Incremental evaluator parsing expectation 2"];
+	NSDictionary *userInfo = @{ORSTStringToData_(@"!foo;"): expectation1,
+							   ORSTStringToData_(@"!bar;"): expectation2};
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithMaximumPacketLength:10
+																								  userInfo:userInfo
+																			   incrementalEvaluatorFactory:^{ return [[ORSTIncrementalPacketEvaluator alloc] init]; }];
+	XCTAssertTrue([descriptor dataIsValidPacket:ORSTStringToData_(@"!foo;")], @"Valid packet rejected by descriptor.");
+	XCTAssertFalse([descriptor dataIsValidPacket:ORSTStringToData_(@"x!foo;")], @"Invalid packet not rejected by descriptor.");
+	
+	// Block evaluators work through the adapter
+	ORSSerialPacketDescriptor *blockDescriptor = [[ORSSerialPacketDescriptor alloc] initWithMaximumPacketLength:10 userInfo:nil incrementalEvaluatorFactory:^{
+		return [[ORSSerialBlockPacketEvaluator alloc] initWithEvaluator:^BOOL(NSData *data) {
+			return [[self defaultPacketDescriptorWithUserInfo:nil] dataIsValidPacket:data];
+		}];
+	}];
+	XCTAssertEqualObjects([blockDescriptor packetMatchingAtEndOfBuffer:ORSTStringToData_(@"!a;x!foo;")], ORSTStringToData_(@"!foo;"), @"Incorrect packet matched at end of buffer.");
+	
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	[self.port receiveData:ORSTStringToData_(@"xx!fo")];
+	[self.port receiveData:ORSTStringToData_(@"o;!b")];
+	[self.port receiveData:ORSTStringToData_(@"ar;")];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectations failed: %@", error);
+		}
+	}];
+}
+
+- (void)testLengthPrefixedPackets
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Length prefixed packet parsing expectation"];
+	expectation.expectedFulfillmentCount = 2;
+	const uint8_t syncBytes[] = {0xAA, 0x55};
+	const uint8_t packetBytes[] = {0xAA, 0x55, 0x00, 0x03, 0x01, 0x02, 0x03};
+	NSData *packet = [NSData dataWithBytes:packetBytes length:sizeof(packetBytes)];
+	
+	// 2 sync bytes and a 2 byte big endian length field giving the length of the payload
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithSyncBytes:[NSData dataWithBytes:syncBytes length:sizeof(syncBytes)]
+																			   lengthFieldOffset:2
+																				lengthFieldWidth:2
+																			lengthFieldByteOrder:ORSSerialPacketLengthFieldBigEndian
+																				lengthAdjustment:4
+																			 maximumPacketLength:32
+																						userInfo:@{packet: expectation}];
+	XCTAssertTrue([descriptor dataIsValidPacket:packet], @"Valid packet rejected by descriptor.");
+	XCTAssertFalse([descriptor dataIsValidPacket:[packet subdataWithRange:NSMakeRange(0, 6)]], @"Invalid packet not rejected by descriptor.");
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	// A false sync with a bad length mustn't hide the packet after it
+	const uint8_t garbage[] = {0x55, 0xAA, 0x55, 0x00, 0x7F, 0xAA};
+	[self.port receiveData:[NSData dataWithBytes:garbage length:sizeof(garbage)]];
+	[self.port receiveData:packet];
+	[self.port receiveData:[packet subdataWithRange:NSMakeRange(0, 3)]];
+	[self.port receiveData:[packet subdataWithRange:NSMakeRange(3, 4)]];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
+- (void)testCOBSAndSLIPFraming
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"COBS framed packet parsing expectation"];
+	expectation.expectedFulfillmentCount = 2;
+	const uint8_t payloadBytes[] = {0x11, 0x22, 0x00, 0xC0, 0xDB};
+	NSData *payload = [NSData dataWithBytes:payloadBytes length:sizeof(payloadBytes)];
+	
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithFraming:ORSSerialPacketFramingCOBS
+																		   maximumPacketLength:16
+																					  userInfo:@{payload: expectation}];
+	const uint8_t cobsBytes[] = {0x03, 0x11, 0x22, 0x03, 0xC0, 0xDB, 0x00};
+	NSData *frame = [descriptor encodedDataForPacket:payload];
+	XCTAssertEqualObjects(frame, [NSData dataWithBytes:cobsBytes length:sizeof(cobsBytes)], @"Incorrect COBS encoding.");
+	XCTAssertTrue([descriptor dataIsValidPacket:frame], @"Valid frame rejected by descriptor.");
+	XCTAssertEqualObjects([descriptor packetMatchingAtEndOfBuffer:frame], payload, @"Incorrect COBS decoding.");
+	
+	ORSSerialPacketDescriptor *slipDescriptor = [[ORSSerialPacketDescriptor alloc] initWithFraming:ORSSerialPacketFramingSLIP maximumPacketLength:16 userInfo:nil];
+	const uint8_t slipBytes[] = {0xC0, 0x11, 0x22, 0x00, 0xDB, 0xDC, 0xDB, 0xDD, 0xC0};
+	NSData *slipFrame = [slipDescriptor encodedDataForPacket:payload];
+	XCTAssertEqualObjects(slipFrame, [NSData dataWithBytes:slipBytes length:sizeof(slipBytes)], @"Incorrect SLIP encoding.");
+	XCTAssertTrue([slipDescriptor dataIsValidPacket:slipFrame], @"Valid frame rejected by descriptor.");
+	XCTAssertEqualObjects([slipDescriptor packetMatchingAtEndOfBuffer:slipFrame], payload, @"Incorrect SLIP decoding.");
+	
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	// A corrupted frame is dropped, and the delimiter ending it starts the next one
+	const uint8_t garbage[] = {0x05, 0x11, 0x00};
+	[self.port receiveData:[NSData dataWithBytes:garbage length:sizeof(garbage)]];
+	[self.port receiveData:frame];
+	[self.port receiveData:[frame subdataWithRange:NSMakeRange(0, 4)]];
+	[self.port receiveData:[frame subdataWithRange:NSMakeRange(4, 3)]];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
+- (void)testPacketChecksums
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Checksummed packet parsing expectation"];
+	const uint8_t syncBytes[] = {0xAA, 0x55};
+	const uint8_t packetBytes[] = {0xAA, 0x55, 0x03, 0x01, 0x02, 0x03, 0x10, 0xC1};
+	const uint8_t corruptedBytes[] = {0xAA, 0x55, 0x03, 0x01, 0x02, 0x04, 0x10, 0xC1};
+	NSData *packet = [NSData dataWithBytes:packetBytes length:sizeof(packetBytes)];
+	NSData *corruptedPacket = [NSData dataWithBytes:corruptedBytes length:sizeof(corruptedBytes)];
+	
+	// 1 byte length field giving the length of the payload, and a CRC covering the length and payload
+	ORSSerialPacketDescriptor *framing = [[ORSSerialPacketDescriptor alloc] initWithSyncBytes:[NSData dataWithBytes:syncBytes length:sizeof(syncBytes)]
+																			lengthFieldOffset:2
+																			 lengthFieldWidth:1
+																		 lengthFieldByteOrder:ORSSerialPacketLengthFieldBigEndian
+																			 lengthAdjustment:5
+																		  maximumPacketLength:32
+																					 userInfo:@{packet: expectation}];
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketDescriptor:framing
+																					  checksumAlgorithm:ORSSerialPacketChecksumCRC16Modbus
+																						 checksumOffset:2
+																				  checksumTrailerLength:0];
+	XCTAssertEqual(framing.checksumAlgorithm, ORSSerialPacketChecksumNone, @"Original descriptor shouldn't have changed.");
+	XCTAssertNotEqualObjects(descriptor, framing, @"Checksummed descriptor should be a distinct descriptor.");
+	XCTAssertTrue([descriptor dataIsValidPacket:packet], @"Valid packet rejected by descriptor.");
+	XCTAssertFalse([descriptor dataIsValidPacket:corruptedPacket], @"Packet with bad checksum not rejected by descriptor.");
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	[self.port receiveData:corruptedPacket];
+	[self.port receiveData:[packet subdataWithRange:NSMakeRange(0, 5)]];
+	[self.port receiveData:[packet subdataWithRange:NSMakeRange(5, 3)]];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
+- (void)testPacketStartingInsideFrameWithBadChecksum
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Packet inside rejected frame parsing expectation"];
+	const uint8_t syncBytes[] = {0xAA, 0x55};
+	const uint8_t packetBytes[] = {0xAA, 0x55, 0x03, 0x01, 0x02, 0x03, 0x10, 0xC1};
+	const uint8_t headerBytes[] = {0xAA, 0x55, 0x04}; // Claims a frame that swallows the start of the real packet
+	NSData *packet = [NSData dataWithBytes:packetBytes length:sizeof(packetBytes)];
+	
+	ORSSerialPacketDescriptor *framing = [[ORSSerialPacketDescriptor alloc] initWithSyncBytes:[NSData dataWithBytes:syncBytes length:sizeof(syncBytes)]
+																			lengthFieldOffset:2
+																			 lengthFieldWidth:1
+																		 lengthFieldByteOrder:ORSSerialPacketLengthFieldBigEndian
+																			 lengthAdjustment:5
+																		  maximumPacketLength:32
+																					 userInfo:@{packet: expectation}];
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketDescriptor:framing
+																					  checksumAlgorithm:ORSSerialPacketChecksumCRC16Modbus
+																						 checksumOffset:2
+																				  checksumTrailerLength:0];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	NSMutableData *stream = [NSMutableData dataWithBytes:headerBytes length:sizeof(headerBytes)];
+	[stream appendData:packet];
+	[self.port receiveData:stream];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
 - (void)testParsingWithLeadingBadData
 {
 	XCTestExpectation *expectation = [self expectationWithDescription:@"Leading bad data packet parsing expectation"];
@@ -271,6 +521,223 @@
 	}];
 }
 
+- (void)testParsingPacketSpanningMultipleReceives
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Packet spanning multiple receives parsing expectation"];
+	NSDictionary *userInfo = @{[@"$$ab$c##" dataUsingEncoding:NSASCIIStringEncoding]: expectation};
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"$$"
+																					   suffixString:@"##"
+																				maximumPacketLength:10
+																						   userInfo:userInfo];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	[self.port receiveData:[@"x$" dataUsingEncoding:NSASCIIStringEncoding]];
+	[self.port receiveData:[@"$a" dataUsingEncoding:NSASCIIStringEncoding]];
+	[self.port receiveData:[@"b$c#" dataUsingEncoding:NSASCIIStringEncoding]];
+	[self.port receiveData:[@"#" dataUsingEncoding:NSASCIIStringEncoding]];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
+- (void)testPacketData
+{
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Fixed packet data parsing expectation"];
+	expectation.expectedFulfillmentCount = 2;
+	NSData *packetData = [@"OK\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketData:packetData
+																						  userInfo:@{packetData: expectation}];
+	XCTAssertTrue([descriptor dataIsValidPacket:packetData], @"Valid packet rejected by descriptor.");
+	XCTAssertFalse([descriptor dataIsValidPacket:ORSTStringToData_(@"OK\r")], @"Invalid packet not rejected by descriptor.");
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	[self.port receiveData:[@"OOK\r\nO" dataUsingEncoding:NSASCIIStringEncoding]];
+	[self.port receiveData:[@"K\r\nOK\r" dataUsingEncoding:NSASCIIStringEncoding]];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectation %@ failed: %@", expectation, error);
+		}
+	}];
+}
+
+- (void)testParsingWithDescriptorsSharingSuffix
+{
+	XCTestExpectation *expectation1 = [self expectationWithDescription:@"Shared suffix parsing expectation 1"];
+	XCTestExpectation *expectation2 = [self expectationWithDescription:@"Shared suffix parsing expectation 2"];
+	XCTestExpectation *expectation3 = [self expectationWithDescription:@"Shared suffix parsing expectation 3"];
+	expectation3.expectedFulfillmentCount = 2;
+	ORSSerialPacketDescriptor *descriptor1 = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"<"
+																						suffixString:@">"
+																				 maximumPacketLength:10
+																							userInfo:@{ORSTStringToData_(@"<ab>"): expectation1}];
+	ORSSerialPacketDescriptor *descriptor2 = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"a"
+																						suffixString:@">"
+																				 maximumPacketLength:10
+																							userInfo:@{ORSTStringToData_(@"a>"): expectation2}];
+	ORSSerialPacketDescriptor *descriptor3 = [[ORSSerialPacketDescriptor alloc] initWithPacketData:ORSTStringToData_(@">")
+																						  userInfo:@{ORSTStringToData_(@">"): expectation3}];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor1];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor3];
+	
+	// Descriptors added while a packet is in progress only see data received after they were added
+	[self.port receiveData:ORSTStringToData_(@"<a")];
+	[self.port startListeningForPacketsMatchingDescriptor:descriptor2];
+	[self.port receiveData:ORSTStringToData_(@"b>a>")];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectations failed: %@", error);
+		}
+	}];
+}
+
+- (void)testAutomatonMatchesEvaluators
+{
+	// Overlapping prefixes, suffixes and fixed packets, all matched by the shared automaton
+	NSArray *literalDescriptors = @[[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"<" suffixString:@">" maximumPacketLength:8 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"<<" suffixString:@">>" maximumPacketLength:12 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"<" suffixString:@";" maximumPacketLength:6 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"a" suffixString:@">" maximumPacketLength:5 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"ab" suffixString:@"b" maximumPacketLength:7 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPrefixString:nil suffixString:@">;" maximumPacketLength:4 userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPacketData:ORSTStringToData_(@"ab") userInfo:[NSMutableArray array]],
+									[[ORSSerialPacketDescriptor alloc] initWithPacketData:ORSTStringToData_(@"><") userInfo:[NSMutableArray array]]];
+	
+	// The same descriptors matched one at a time by their evaluator blocks
+	NSMutableArray *evaluatorDescriptors = [NSMutableArray array];
+	for (ORSSerialPacketDescriptor *descriptor in literalDescriptors) {
+		[evaluatorDescriptors addObject:[[ORSSerialPacketDescriptor alloc] initWithMaximumPacketLength:descriptor.maximumPacketLength
+																							   userInfo:[NSMutableArray array]
+																					  responseEvaluator:descriptor.responseEvaluator]];
+	}
+	XCTestExpectation *expectation = [self expectationWithDescription:@"End of stream"];
+	ORSSerialPacketDescriptor *endDescriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketData:ORSTStringToData_(@"#END#") userInfo:@{ORSTStringToData_(@"#END#"): expectation}];
+	for (ORSSerialPacketDescriptor *descriptor in [literalDescriptors arrayByAddingObjectsFromArray:evaluatorDescriptors]) {
+		[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	}
+	[self.port startListeningForPacketsMatchingDescriptor:endDescriptor];
+	
+	// Random bytes from the patterns' alphabet, with a long run of prefixes and no suffix in the middle
+	const char alphabet[] = "<>ab;x";
+	NSMutableData *stream = [NSMutableData data];
+	uint32_t random = 12345;
+	for (NSUInteger i=0; i<6000; i++) {
+		if (i == 3000) {
+			NSMutableData *prefixes = [NSMutableData dataWithLength:5000];
+			memset([prefixes mutableBytes], '<', [prefixes length]);
+			[stream appendData:prefixes];
+		}
+		random = random * 1103515245 + 12345;
+		[stream appendBytes:&alphabet[(random >> 16) % (sizeof(alphabet) - 1)] length:1];
+	}
+	[stream appendData:ORSTStringToData_(@"#END#")];
+	for (NSUInteger offset=0; offset<[stream length]; offset+=37) {
+		[self.port receiveData:[stream subdataWithRange:NSMakeRange(offset, MIN((NSUInteger)37, [stream length] - offset))]];
+	}
+	
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+	for (NSUInteger i=0; i<[literalDescriptors count]; i++) {
+		ORSSerialPacketDescriptor *literal = literalDescriptors[i];
+		ORSSerialPacketDescriptor *evaluator = evaluatorDescriptors[i];
+		XCTAssertGreaterThan([(NSArray *)evaluator.userInfo count], (NSUInteger)0, @"Stream should contain packets for descriptor %lu.", (unsigned long)i);
+		XCTAssertEqualObjects(literal.userInfo, evaluator.userInfo, @"Automaton and evaluator found different packets for descriptor %lu.", (unsigned long)i);
+	}
+}
+
+- (void)testReceiveWindowWrapping
+{
+	// Three kinds of matcher scanning the same shared receive window
+	NSMutableArray *literalPackets = [NSMutableArray array];
+	NSMutableArray *incrementalPackets = [NSMutableArray array];
+	NSMutableArray *regexPackets = [NSMutableArray array];
+	ORSSerialPacketDescriptor *literal = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"<" suffixString:@">" maximumPacketLength:16 userInfo:literalPackets];
+	ORSSerialPacketDescriptor *incremental = [[ORSSerialPacketDescriptor alloc] initWithMaximumPacketLength:16
+																								   userInfo:incrementalPackets
+																				incrementalEvaluatorFactory:^{ return [[ORSTIncrementalPacketEvaluator alloc] init]; }];
+	NSRegularExpression *regex = [NSRegularExpression regularExpressionWithPattern:@"^#[0-9]+#$" options:0 error:NULL];
+	ORSSerialPacketDescriptor *regexDescriptor = [[ORSSerialPacketDescriptor alloc] initWithRegularExpression:regex maximumPacketLength:16 userInfo:regexPackets];
+	XCTestExpectation *expectation = [self expectationWithDescription:@"End of stream"];
+	ORSSerialPacketDescriptor *endDescriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketData:ORSTStringToData_(@"$END$") userInfo:@{ORSTStringToData_(@"$END$"): expectation}];
+	for (ORSSerialPacketDescriptor *descriptor in @[literal, incremental, regexDescriptor, endDescriptor]) {
+		[self.port startListeningForPacketsMatchingDescriptor:descriptor];
+	}
+	
+	// Each literal packet contains the start of an incremental one that only ends after it. Once the
+	// literal packet has consumed its bytes, that start is gone, so only the real incremental packets match.
+	self.port.usesExclusivePacketMatching = YES;
+	NSMutableArray *expectedLiteralPackets = [NSMutableArray array];
+	NSMutableArray *expectedIncrementalPackets = [NSMutableArray array];
+	NSMutableArray *expectedRegexPackets = [NSMutableArray array];
+	NSMutableData *stream = [NSMutableData data];
+	for (NSUInteger i=0; i<4000; i++) {
+		NSData *literalPacket = ORSTStringToData_(([NSString stringWithFormat:@"<%05lu!xx>", (unsigned long)i]));
+		NSData *incrementalPacket = ORSTStringToData_(([NSString stringWithFormat:@"!%05lu;", (unsigned long)i]));
+		NSData *regexPacket = ORSTStringToData_(([NSString stringWithFormat:@"#%05lu#", (unsigned long)i]));
+		[stream appendData:literalPacket];
+		[stream appendData:ORSTStringToData_(@"yy;")];
+		[stream appendData:incrementalPacket];
+		[stream appendData:regexPacket];
+		[expectedLiteralPackets addObject:literalPacket];
+		[expectedIncrementalPackets addObject:incrementalPacket];
+		[expectedRegexPackets addObject:regexPacket];
+	}
+	[stream appendData:ORSTStringToData_(@"$END$")];
+	
+	// Over a hundred kilobytes, far more than the window holds, in chunks that don't line up with
+	// packets, so many packets straddle the point where the window wraps around
+	for (NSUInteger offset=0, chunk=0; offset<[stream length]; offset+=chunk) {
+		chunk = MIN((NSUInteger)(61 + offset % 113), [stream length] - offset);
+		[self.port receiveData:[stream subdataWithRange:NSMakeRange(offset, chunk)]];
+	}
+	
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+	XCTAssertEqualObjects(literalPackets, expectedLiteralPackets, @"Literal packets not delivered intact.");
+	XCTAssertEqualObjects(incrementalPackets, expectedIncrementalPackets, @"Consumed data matched, or incremental packets not delivered intact.");
+	XCTAssertEqualObjects(regexPackets, expectedRegexPackets, @"Regular expression packets not delivered intact.");
+}
+
+- (void)testPipelinedResponsesMatchedByCorrelationTag
+{
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPacketDescriptor:[self defaultPacketDescriptorWithUserInfo:nil] correlationTagExtractor:^id(NSData *packetData) {
+		if ([packetData length] < 3) return nil;
+		return [packetData subdataWithRange:NSMakeRange(1, 1)];
+	}];
+	
+	XCTestExpectation *expectationA = [self expectationWithDescription:@"Response to request a"];
+	XCTestExpectation *expectationB = [self expectationWithDescription:@"Response to request b"];
+	ORSSerialRequest *requestA = [ORSSerialRequest requestWithDataToSend:ORSTStringToData_(@"a")
+																userInfo:@{@"response": ORSTStringToData_(@"!a1;"), @"expectation": expectationA}
+														 timeoutInterval:-1
+													  responseDescriptor:descriptor
+														  correlationTag:ORSTStringToData_(@"a")];
+	ORSSerialRequest *requestB = [ORSSerialRequest requestWithDataToSend:ORSTStringToData_(@"b")
+																userInfo:@{@"response": ORSTStringToData_(@"!b2;"), @"expectation": expectationB}
+														 timeoutInterval:-1
+													  responseDescriptor:descriptor
+														  correlationTag:ORSTStringToData_(@"b")];
+	
+	// The port isn't open, so nothing is actually written, but both requests are still pending
+	self.port.maximumPendingRequestCount = 2;
+	[self.port sendRequest:requestA];
+	[self.port sendRequest:requestB];
+	XCTAssertEqualObjects(self.port.pendingRequests, (@[requestA, requestB]), @"Both requests should be pending.");
+	
+	// Responses arrive out of order
+	[self.port receiveData:ORSTStringToData_(@"!b2;!a")];
+	[self.port receiveData:ORSTStringToData_(@"1;")];
+	
+	[self waitForExpectationsWithTimeout:0.5 handler:^(NSError *error) {
+		if (error) {
+			NSLog(@"expectations failed: %@", error);
+		}
+	}];
+	XCTAssertEqual([self.port.pendingRequests count], (NSUInteger)0, @"No requests should be pending once both are answered.");
+}
+
 - (void)testPacketDescriptorsPropertyAdd
 {
 	XCTAssertNotNil(self.port.packetDescriptors, @"-[ORSSerialPort packetDescriptors] returned nil.");
@@ -354,9 +821,20 @@
 
 - (void)serialPort:(ORSSerialPort *)serialPort didReceivePacket:(NSData *)packetData matchingDescriptor:(ORSSerialPacketDescriptor *)descriptor
 {
+	if ([descriptor.userInfo isKindOfClass:[NSMutableArray class]]) {
+		[(NSMutableArray *)descriptor.userInfo addObject:packetData];
+		return;
+	}
 	NSDictionary *userInfo = (NSDictionary *)descriptor.userInfo;
 	XCTestExpectation *expectation = userInfo[packetData];
 	[expectation fulfill];
 }
 
+- (void)serialPort:(ORSSerialPort *)serialPort didReceiveResponse:(NSData *)responseData toRequest:(ORSSerialRequest *)request
+{
+	NSDictionary *userInfo = (NSDictionary *)request.userInfo;
+	XCTAssertEqualObjects(responseData, userInfo[@"response"], @"Response delivered for the wrong request.");
+	[userInfo[@"expectation"] fulfill];
+}
+
 @end
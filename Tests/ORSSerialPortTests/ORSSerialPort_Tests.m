@@ -8,11 +8,522 @@
 
 #import <Cocoa/Cocoa.h>
 #import <XCTest/XCTest.h>
+#import <ORSSerial/ORSSerial.h>
 
-@interface ORSSerialPort_Tests : XCTestCase
+@interface ORSSerialPort (Private)
+
+- (void)modemLinesDidChange:(int)modemLines previousModemLines:(int)previousModemLines errorCode:(int)errorCode;
+
+@end
+
+// The parts of the framework's private ORSSerialModemLineMonitor class used by the tests
+@protocol ORSTModemLineMonitor <NSObject>
+
+- (id)startMonitoringFileDescriptor:(int)fileDescriptor handler:(void(^)(int modemLines, int previousModemLines, int errorCode))handler;
+- (void)stopMonitoring:(id)token;
+
+@property (nonatomic, readonly) NSTimeInterval minimumPollInterval;
+@property (nonatomic, readonly) NSTimeInterval maximumPollInterval;
+
+@end
+
+// Pseudo terminal whose modem lines are watched, as they would be for a real serial port
+@interface ORSTModemLinePseudoTerminalTransport : ORSSerialPseudoTerminalTransport
+@end
+
+@implementation ORSTModemLinePseudoTerminalTransport
+
+- (BOOL)supportsModemLines { return YES; }
+
+@end
+
+@interface ORSSerialPort_Tests : XCTestCase <ORSSerialPortDelegate>
+
+@property (nonatomic, strong) ORSSerialPort *port;
+@property (nonatomic, strong) XCTestExpectation *closeExpectation;
+@property (nonatomic, strong) XCTestExpectation *removalExpectation;
 
 @end
 
 @implementation ORSSerialPort_Tests
 
+- (void)setUp
+{
+	[super setUp];
+	self.port = [[ORSSerialPort alloc] initWithDevice:-1];
+}
+
+- (void)tearDown
+{
+	[super tearDown];
+	self.port.delegate = nil;
+	self.port = nil;
+}
+
+#pragma mark - Test Cases
+
+- (void)testMaximumReadLength
+{
+	XCTAssertEqual(self.port.maximumReadLength, (NSUInteger)16384, @"Unexpected default maximum read length.");
+	self.port.maximumReadLength = 65536;
+	XCTAssertEqual(self.port.maximumReadLength, (NSUInteger)65536, @"Maximum read length not set.");
+	self.port.maximumReadLength = 0;
+	XCTAssertEqual(self.port.maximumReadLength, (NSUInteger)1, @"Maximum read length of 0 not clamped to 1.");
+}
+
+- (void)testDelegateQueue
+{
+	XCTAssertEqual(self.port.delegateQueue, dispatch_get_main_queue(), @"Delegate queue should default to main queue.");
+	dispatch_queue_t queue = dispatch_queue_create("com.openreelsoftware.ORSSerialPortTests.delegateQueue", 0);
+	self.port.delegateQueue = queue;
+	XCTAssertEqual(self.port.delegateQueue, queue, @"Delegate queue not set.");
+	self.port.delegateQueue = nil;
+	XCTAssertEqual(self.port.delegateQueue, dispatch_get_main_queue(), @"Setting delegate queue to nil should restore main queue.");
+}
+
+- (void)testSendingToClosedPort
+{
+	XCTAssertEqual(self.port.writeHighWaterMark, (NSUInteger)65536, @"Unexpected default write high water mark.");
+	__block BOOL completionHandlerCalled = NO;
+	BOOL queued = [self.port sendData:[NSData dataWithBytes:"abc" length:3] completionHandler:^(NSError *error) {
+		completionHandlerCalled = YES;
+	}];
+	XCTAssertFalse(queued, @"Data shouldn't be queued on a closed port.");
+	XCTAssertEqual(self.port.queuedWriteLength, (NSUInteger)0, @"Closed port shouldn't have queued data.");
+	[[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+	XCTAssertFalse(completionHandlerCalled, @"Completion handler shouldn't be called when data isn't queued.");
+}
+
+- (void)testWriteCoalescingSettings
+{
+	XCTAssertEqual(self.port.writeCoalescingInterval, 0.0, @"Write coalescing should be off by default.");
+	XCTAssertEqual(self.port.maximumWriteBatchLength, (NSUInteger)16384, @"Unexpected default maximum write batch length.");
+	self.port.writeCoalescingInterval = 0.0002;
+	XCTAssertEqual(self.port.writeCoalescingInterval, 0.0002, @"Write coalescing interval not set.");
+	self.port.writeCoalescingInterval = -1.0;
+	XCTAssertEqual(self.port.writeCoalescingInterval, 0.0, @"Negative write coalescing interval not clamped to 0.");
+	self.port.maximumWriteBatchLength = 0;
+	XCTAssertEqual(self.port.maximumWriteBatchLength, (NSUInteger)1, @"Maximum write batch length of 0 not clamped to 1.");
+	XCTAssertEqual(self.port.writeCallCount, (NSUInteger)0, @"Closed port shouldn't have made write calls.");
+}
+
+- (void)testWriteCoalescing
+{
+	ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	port.writeCoalescingInterval = 0.01;
+	port.delegate = self;
+	[port open];
+	
+	// Small frames sent back to back should share write calls
+	NSMutableData *expected = [NSMutableData data];
+	NSMutableArray *expectations = [NSMutableArray array];
+	for (NSUInteger i=0; i<20; i++) {
+		NSData *frame = [[NSString stringWithFormat:@"!frame%02lu;", (unsigned long)i] dataUsingEncoding:NSASCIIStringEncoding];
+		[expected appendData:frame];
+		XCTestExpectation *sendExpectation = [self expectationWithDescription:@"Frame sent"];
+		[port sendData:frame completionHandler:^(NSError *error) {
+			XCTAssertNil(error, @"Sending coalesced frame failed.");
+			[sendExpectation fulfill];
+		}];
+		[expectations addObject:sendExpectation];
+	}
+	[self waitForExpectations:expectations timeout:2.0 enforceOrder:YES];
+	
+	XCTAssertGreaterThan(port.writeCallsSavedByCoalescing, (NSUInteger)0, @"No write calls saved by coalescing.");
+	XCTAssertLessThan(port.writeCallCount, (NSUInteger)20, @"Each frame was written separately.");
+	
+	NSMutableData *received = [NSMutableData dataWithLength:[expected length]];
+	NSUInteger receivedLength = 0;
+	while (receivedLength < [expected length]) {
+		ssize_t length = read(transport.peerFileDescriptor, (uint8_t *)[received mutableBytes] + receivedLength, [expected length] - receivedLength);
+		if (length <= 0) break;
+		receivedLength += length;
+	}
+	XCTAssertEqualObjects(received, expected, @"Peer didn't receive the frames complete and in order.");
+	port.delegate = nil;
+	[port close];
+}
+
+- (void)testQueuedRequestPriorities
+{
+	ORSSerialRequest *(^request)(ORSSerialRequestPriority) = ^(ORSSerialRequestPriority priority) {
+		return [ORSSerialRequest requestWithDataToSend:[NSData data] userInfo:nil timeoutInterval:-1 responseDescriptor:[self responseDescriptor] correlationTag:nil priority:priority deadline:nil];
+	};
+	
+	// The port isn't open, so the first request stays pending and the rest are queued
+	ORSSerialRequest *pending = request(ORSSerialRequestPriorityNormal);
+	ORSSerialRequest *low = request(ORSSerialRequestPriorityLow);
+	ORSSerialRequest *normal1 = request(ORSSerialRequestPriorityNormal);
+	ORSSerialRequest *high = request(ORSSerialRequestPriorityHigh);
+	ORSSerialRequest *normal2 = request(ORSSerialRequestPriorityNormal);
+	for (ORSSerialRequest *each in @[pending, low, normal1, high, normal2]) [self.port sendRequest:each];
+	
+	XCTAssertEqualObjects(self.port.pendingRequest, pending, @"First request should be pending.");
+	XCTAssertEqualObjects(self.port.queuedRequests, (@[high, normal1, normal2, low]), @"Requests not queued in priority order.");
+	
+	[self.port cancelQueuedRequest:normal1];
+	[self.port sendRequest:request(ORSSerialRequestPriorityLow)]; // Runs after the cancellation
+	XCTAssertFalse([self.port.queuedRequests containsObject:normal1], @"Cancelled request still queued.");
+	XCTAssertEqual([self.port.queuedRequests count], (NSUInteger)4, @"Unexpected number of queued requests.");
+}
+
+- (void)testRequestTimeouts
+{
+	self.port.delegate = self;
+	self.port.maximumPendingRequestCount = 2;
+	
+	// The port isn't open, so neither request can be answered
+	XCTestExpectation *shortExpectation = [self expectationWithDescription:@"Short timeout"];
+	XCTestExpectation *longExpectation = [self expectationWithDescription:@"Long timeout"];
+	NSDate *start = [NSDate date];
+	[self.port sendRequest:[ORSSerialRequest requestWithDataToSend:[NSData data] userInfo:longExpectation timeoutInterval:0.3 responseDescriptor:[self responseDescriptor]]];
+	[self.port sendRequest:[ORSSerialRequest requestWithDataToSend:[NSData data] userInfo:shortExpectation timeoutInterval:0.05 responseDescriptor:[self responseDescriptor]]];
+	
+	[self waitForExpectations:@[shortExpectation, longExpectation] timeout:2.0 enforceOrder:YES];
+	XCTAssertGreaterThanOrEqual(-[start timeIntervalSinceNow], 0.3, @"Request timed out early.");
+}
+
+- (void)testQueuedRequestDeadlines
+{
+	self.port.delegate = self;
+	
+	// The port isn't open, so the first request stays pending until it times out, long after the deadline
+	ORSSerialRequest *pending = [ORSSerialRequest requestWithDataToSend:[NSData data] userInfo:nil timeoutInterval:-1 responseDescriptor:[self responseDescriptor]];
+	XCTestExpectation *expiredExpectation = [self expectationWithDescription:@"Request expired"];
+	ORSSerialRequest *queued = [ORSSerialRequest requestWithDataToSend:[NSData data] userInfo:expiredExpectation timeoutInterval:-1 responseDescriptor:[self responseDescriptor] correlationTag:nil priority:ORSSerialRequestPriorityNormal deadline:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+	[self.port sendRequest:pending];
+	[self.port sendRequest:queued];
+	XCTAssertEqualObjects(self.port.queuedRequests, @[queued], @"Request should be queued behind the pending one.");
+	
+	[self waitForExpectations:@[expiredExpectation] timeout:2.0];
+	XCTAssertEqualObjects(self.port.pendingRequest, pending, @"Pending request shouldn't be affected.");
+	XCTAssertEqual([self.port.queuedRequests count], (NSUInteger)0, @"Expired request still queued.");
+	XCTAssertEqual(self.port.statistics.queuedRequestCount, (NSUInteger)0, @"Expired request still counted as queued.");
+	
+	// A request whose deadline has already passed is never sent
+	XCTestExpectation *lateExpectation = [self expectationWithDescription:@"Late request expired"];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:[[ORSSerialLoopbackTransport alloc] init]];
+	port.delegate = self;
+	[port open];
+	ORSSerialRequest *late = [ORSSerialRequest requestWithDataToSend:[NSData dataWithBytes:"?" length:1] userInfo:lateExpectation timeoutInterval:-1 responseDescriptor:[self responseDescriptor] correlationTag:nil priority:ORSSerialRequestPriorityNormal deadline:[NSDate dateWithTimeIntervalSinceNow:-1.0]];
+	XCTAssertFalse([port sendRequest:late], @"Expired request reported as sent.");
+	[self waitForExpectations:@[lateExpectation] timeout:2.0];
+	XCTAssertNil(port.pendingRequest, @"Expired request shouldn't be pending.");
+	port.delegate = nil;
+	[port close];
+}
+
+- (void)testLoopbackTransport
+{
+	ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	XCTAssertEqualObjects(port.path, transport.path, @"Port path should come from its transport.");
+	port.delegate = self;
+	[port open];
+	XCTAssertTrue(port.isOpen, @"Loopback port didn't open.");
+	
+	XCTestExpectation *packetExpectation = [self expectationWithDescription:@"Packet received"];
+	[port startListeningForPacketsMatchingDescriptor:[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:packetExpectation]];
+	XCTAssertEqual(write(transport.peerFileDescriptor, "xx!hello;", 9), (ssize_t)9, @"Couldn't write to peer.");
+	
+	XCTestExpectation *sendExpectation = [self expectationWithDescription:@"Data sent"];
+	[port sendData:[@"ping" dataUsingEncoding:NSASCIIStringEncoding] completionHandler:^(NSError *error) {
+		XCTAssertNil(error, @"Sending to loopback port failed.");
+		[sendExpectation fulfill];
+	}];
+	[self waitForExpectations:@[packetExpectation, sendExpectation] timeout:2.0];
+	
+	char received[4];
+	XCTAssertEqual(read(transport.peerFileDescriptor, received, sizeof(received)), (ssize_t)4, @"Peer didn't receive sent data.");
+	XCTAssertEqual(memcmp(received, "ping", 4), 0, @"Peer received wrong data.");
+	port.delegate = nil;
+	[port close];
+}
+
+- (void)testSharedReactor
+{
+	// Enough ports that several share each reactor queue
+	NSMutableArray *transports = [NSMutableArray array];
+	NSMutableArray *ports = [NSMutableArray array];
+	NSMutableArray *expectations = [NSMutableArray array];
+	for (NSUInteger i=0; i<16; i++) {
+		ORSSerialPseudoTerminalTransport *transport = [[ORSSerialPseudoTerminalTransport alloc] init];
+		ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+		port.usesSharedReactor = YES;
+		port.delegate = self;
+		[port open];
+		XCTAssertTrue(port.isOpen, @"Port using the shared reactor didn't open.");
+		
+		XCTestExpectation *packetExpectation = [self expectationWithDescription:@"Packet received"];
+		[port startListeningForPacketsMatchingDescriptor:[[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:packetExpectation]];
+		XCTAssertEqual(write(transport.peerFileDescriptor, "!hello;", 7), (ssize_t)7, @"Couldn't write to peer.");
+		XCTestExpectation *sendExpectation = [self expectationWithDescription:@"Data sent"];
+		[port sendData:[@"ping" dataUsingEncoding:NSASCIIStringEncoding] completionHandler:^(NSError *error) {
+			XCTAssertNil(error, @"Sending through the shared reactor failed.");
+			[sendExpectation fulfill];
+		}];
+		[transports addObject:transport];
+		[ports addObject:port];
+		[expectations addObjectsFromArray:@[packetExpectation, sendExpectation]];
+	}
+	[self waitForExpectations:expectations timeout:5.0];
+	
+	for (ORSSerialPseudoTerminalTransport *transport in transports) {
+		char received[4];
+		XCTAssertEqual(read(transport.peerFileDescriptor, received, sizeof(received)), (ssize_t)4, @"Peer didn't receive sent data.");
+		XCTAssertEqual(memcmp(received, "ping", 4), 0, @"Peer received wrong data.");
+	}
+	
+	// A port closing with unsendable data mustn't hold up the others sharing its reactor queue
+	ORSSerialPort *stuckPort = ports[0];
+	[stuckPort sendData:[NSMutableData dataWithLength:4 * 1024 * 1024]];
+	self.closeExpectation = [self expectationWithDescription:@"Other ports closed"];
+	self.closeExpectation.expectedFulfillmentCount = [ports count] - 1;
+	self.closeExpectation.assertForOverFulfill = NO;
+	for (ORSSerialPort *port in ports) [port close];
+	[self waitForExpectations:@[self.closeExpectation] timeout:1.0];
+	for (ORSSerialPort *port in ports) {
+		if (port != stuckPort) XCTAssertFalse(port.isOpen, @"Port using the shared reactor didn't close.");
+	}
+	[self expectationForPredicate:[NSPredicate predicateWithFormat:@"isOpen == NO"] evaluatedWithObject:stuckPort handler:nil];
+	[self waitForExpectationsWithTimeout:5.0 handler:nil];
+	self.closeExpectation = nil;
+	for (ORSSerialPort *port in ports) port.delegate = nil;
+}
+
+- (void)testClosingWhilePeerIsNotReading
+{
+	ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	port.delegate = self;
+	[port open];
+	
+	// Far more than the loopback connection can buffer, and the peer never reads any of it
+	XCTestExpectation *sendExpectation = [self expectationWithDescription:@"Send cancelled"];
+	[port sendData:[NSMutableData dataWithLength:4 * 1024 * 1024] completionHandler:^(NSError *error) {
+		XCTAssertEqual(error.code, (NSInteger)ECANCELED, @"Unsent data should fail with ECANCELED.");
+		[sendExpectation fulfill];
+	}];
+	self.closeExpectation = [self expectationWithDescription:@"Port closed"];
+	[port close];
+	[self waitForExpectations:@[sendExpectation, self.closeExpectation] timeout:5.0];
+	
+	XCTAssertFalse(port.isOpen, @"Port should be closed.");
+	self.closeExpectation = nil;
+	port.delegate = nil;
+}
+
+- (void)testModemLinePollingBackOff
+{
+	id<ORSTModemLineMonitor> monitor = [[NSClassFromString(@"ORSSerialModemLineMonitor") alloc] init];
+	XCTAssertNotNil(monitor, @"Couldn't create a modem line monitor.");
+	XCTAssertLessThan(monitor.minimumPollInterval, 0.01, @"Changed lines should be polled more often than every 10 ms.");
+	XCTAssertEqualWithAccuracy(monitor.maximumPollInterval, 0.05, 0.0001, @"Unchanged lines should back off to 50 ms.");
+	
+	ORSSerialPseudoTerminalTransport *transport = [[ORSSerialPseudoTerminalTransport alloc] init];
+	int descriptor = [transport openFileDescriptor];
+	XCTAssertGreaterThanOrEqual(descriptor, 0, @"Couldn't open pseudo terminal.");
+	
+	XCTestExpectation *initialExpectation = [self expectationWithDescription:@"Initial modem lines"];
+	__block NSUInteger callCount = 0;
+	__block int firstErrorCode = 0;
+	id token = [monitor startMonitoringFileDescriptor:descriptor handler:^(int modemLines, int previousModemLines, int errorCode) {
+		if (++callCount == 1) {
+			firstErrorCode = errorCode;
+			[initialExpectation fulfill];
+		}
+	}];
+	[self waitForExpectations:@[initialExpectation] timeout:1.0];
+	
+	// 2, 4, 8, 16, 32 and then 50 ms between polls is about 110 ms
+	[[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.4]];
+	[monitor stopMonitoring:token]; // Waits for any poll in progress
+	uint64_t pollInterval = [[token valueForKey:@"pollInterval"] unsignedLongLongValue];
+	XCTAssertEqual(pollInterval, (uint64_t)(monitor.maximumPollInterval * NSEC_PER_SEC), @"Poll interval didn't back off to the maximum.");
+	if (firstErrorCode == 0) XCTAssertEqual(callCount, (NSUInteger)1, @"Handler called though the lines stayed the same.");
+	[transport closeFileDescriptor:descriptor];
+}
+
+- (void)testStoppingModemLineMonitoringFromHandler
+{
+	id<ORSTModemLineMonitor> monitor = [[NSClassFromString(@"ORSSerialModemLineMonitor") alloc] init];
+	
+	// A pipe has no modem lines, so every poll fails, and failures are retried at the maximum interval
+	int pipeDescriptors[2];
+	XCTAssertEqual(pipe(pipeDescriptors), 0, @"Couldn't create a pipe.");
+	XCTestExpectation *expectation = [self expectationWithDescription:@"Monitoring stopped"];
+	NSMutableArray *callDates = [NSMutableArray array];
+	__block id token = nil;
+	token = [monitor startMonitoringFileDescriptor:pipeDescriptors[0] handler:^(int modemLines, int previousModemLines, int errorCode) {
+		XCTAssertEqual(errorCode, ENOTTY, @"Unexpected error polling a pipe.");
+		[callDates addObject:[NSDate date]];
+		if ([callDates count] == 3) {
+			[monitor stopMonitoring:token]; // Mustn't deadlock on the monitor's own queue
+			[expectation fulfill];
+		}
+	}];
+	[self waitForExpectations:@[expectation] timeout:2.0];
+	[[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+	
+	XCTAssertEqual([callDates count], (NSUInteger)3, @"Handler called after monitoring was stopped.");
+	for (NSUInteger i=1; i<[callDates count]; i++) {
+		NSTimeInterval interval = [callDates[i] timeIntervalSinceDate:callDates[i-1]];
+		XCTAssertGreaterThanOrEqual(interval, monitor.maximumPollInterval * 0.9, @"Failing descriptor polled too often.");
+	}
+	close(pipeDescriptors[0]);
+	close(pipeDescriptors[1]);
+}
+
+- (void)testModemLinesRemovedFromSystem
+{
+	ORSTModemLinePseudoTerminalTransport *transport = [[ORSTModemLinePseudoTerminalTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	port.delegateQueue = dispatch_queue_create("com.openreelsoftware.ORSSerialPortTests.delegateQueue", 0);
+	port.delegate = self;
+	[port open];
+	XCTAssertTrue(port.isOpen, @"Port didn't open.");
+	
+	// ENXIO from TIOCMGET is how the monitor finds out a USB adapter was unplugged. It's delivered
+	// on the monitor's queue, which the cleanup mustn't block.
+	self.removalExpectation = [self expectationWithDescription:@"Port removed"];
+	self.closeExpectation = [self expectationWithDescription:@"Port closed"];
+	[port modemLinesDidChange:0 previousModemLines:0 errorCode:ENXIO];
+	[self waitForExpectations:@[self.removalExpectation, self.closeExpectation] timeout:5.0 enforceOrder:YES];
+	XCTAssertFalse(port.isOpen, @"Removed port should be closed.");
+	
+	self.removalExpectation = nil;
+	self.closeExpectation = nil;
+	port.delegate = nil;
+}
+
+- (void)testStatistics
+{
+	ORSSerialPortStatistics *statistics = self.port.statistics;
+	XCTAssertEqual(statistics.bytesReceived, (uint64_t)0, @"Closed port shouldn't have received data.");
+	XCTAssertEqual(statistics.requestRoundTripTimes.count, (uint64_t)0, @"Closed port shouldn't have round trip times.");
+	XCTAssertEqual([statistics.requestRoundTripTimes valueAtPercentile:99], (uint64_t)0, @"Empty histogram should return 0.");
+	
+	ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	port.delegate = self;
+	[port open];
+	XCTestExpectation *packetExpectation = [self expectationWithDescription:@"Packet received"];
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:packetExpectation];
+	[port startListeningForPacketsMatchingDescriptor:descriptor];
+	XCTAssertEqual(write(transport.peerFileDescriptor, "!hello;", 7), (ssize_t)7, @"Couldn't write to peer.");
+	[self waitForExpectations:@[packetExpectation] timeout:2.0];
+	
+	statistics = port.statistics;
+	XCTAssertEqual(statistics.bytesReceived, (uint64_t)7, @"Unexpected number of bytes received.");
+	XCTAssertEqual(statistics.readSizes.maximum, (uint64_t)7, @"Unexpected read size.");
+	XCTAssertEqual(statistics.packetCount, (uint64_t)1, @"Unexpected packet count.");
+	XCTAssertEqual([statistics packetCountForDescriptor:descriptor], (uint64_t)1, @"Unexpected packet count for descriptor.");
+	XCTAssertEqual(statistics.receiveToDelegateLatencies.count, (uint64_t)1, @"Receive to delegate latency not recorded.");
+	port.delegate = nil;
+	[port close];
+}
+
+- (void)testListeningForDescriptorsWhileReceiving
+{
+	ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+	ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+	port.delegate = self;
+	[port open];
+	const NSUInteger packetCount = 50;
+	XCTestExpectation *packetExpectation = [self expectationWithDescription:@"Packets received"];
+	packetExpectation.expectedFulfillmentCount = packetCount;
+	ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:packetExpectation];
+	[port startListeningForPacketsMatchingDescriptor:descriptor];
+	
+	// Descriptors come and go on another thread while packets for the one that stays are being parsed
+	ORSSerialPacketDescriptor *literalDescriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"#" suffixString:@";" maximumPacketLength:20 userInfo:nil];
+	ORSSerialPacketDescriptor *lineDescriptor = [[ORSSerialPacketDescriptor alloc] initWithLineTerminatorString:@"\n" maximumPacketLength:20 userInfo:nil];
+	XCTestExpectation *churnExpectation = [self expectationWithDescription:@"Descriptors added and removed"];
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+		for (NSUInteger i=0; i<1000; i++) {
+			[port startListeningForPacketsMatchingDescriptor:literalDescriptor];
+			[port startListeningForPacketsMatchingDescriptor:lineDescriptor];
+			[port stopListeningForPacketsMatchingDescriptor:literalDescriptor];
+			[port stopListeningForPacketsMatchingDescriptor:lineDescriptor];
+		}
+		[churnExpectation fulfill];
+	});
+	for (NSUInteger i=0; i<packetCount; i++) {
+		XCTAssertEqual(write(transport.peerFileDescriptor, "!hello;", 7), (ssize_t)7, @"Couldn't write to peer.");
+	}
+	[self waitForExpectations:@[packetExpectation, churnExpectation] timeout:5.0];
+	
+	XCTAssertEqualObjects(port.packetDescriptors, @[descriptor], @"Only the descriptor that stayed should be installed.");
+	port.delegate = nil;
+	[port close];
+}
+
+- (void)testExclusivePacketMatching
+{
+	XCTAssertFalse(self.port.usesExclusivePacketMatching, @"Exclusive packet matching should be off by default.");
+	
+	for (NSNumber *exclusive in @[@NO, @YES]) {
+		ORSSerialLoopbackTransport *transport = [[ORSSerialLoopbackTransport alloc] init];
+		ORSSerialPort *port = [ORSSerialPort serialPortWithTransport:transport];
+		port.delegate = self;
+		port.usesExclusivePacketMatching = [exclusive boolValue];
+		[port open];
+		XCTestExpectation *packetExpectation = [self expectationWithDescription:@"Packets received"];
+		packetExpectation.expectedFulfillmentCount = 2;
+		ORSSerialPacketDescriptor *descriptor = [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:packetExpectation];
+		NSMutableArray *lines = [NSMutableArray array];
+		ORSSerialPacketDescriptor *lineDescriptor = [[ORSSerialPacketDescriptor alloc] initWithLineTerminatorString:@"\n" maximumPacketLength:20 userInfo:lines];
+		[port startListeningForPacketsMatchingDescriptor:descriptor];
+		[port startListeningForPacketsMatchingDescriptor:lineDescriptor];
+		XCTAssertEqual(write(transport.peerFileDescriptor, "x!hello;yz\n!hello;", 18), (ssize_t)18, @"Couldn't write to peer.");
+		[self waitForExpectations:@[packetExpectation] timeout:2.0];
+		
+		// The line ends before the second packet, so it's been delivered by now
+		NSString *line = [exclusive boolValue] ? @"yz\n" : @"x!hello;yz\n";
+		XCTAssertEqualObjects(lines, @[[line dataUsingEncoding:NSASCIIStringEncoding]], @"Unexpected lines received.");
+		port.delegate = nil;
+		[port close];
+	}
+}
+
+#pragma mark - Utilities
+
+- (ORSSerialPacketDescriptor *)responseDescriptor
+{
+	return [[ORSSerialPacketDescriptor alloc] initWithPrefixString:@"!" suffixString:@";" maximumPacketLength:20 userInfo:nil];
+}
+
+#pragma mark - ORSSerialPortDelegate
+
+- (void)serialPortWasRemovedFromSystem:(ORSSerialPort *)serialPort
+{
+	[self.removalExpectation fulfill];
+}
+
+- (void)serialPortWasClosed:(ORSSerialPort *)serialPort
+{
+	[self.closeExpectation fulfill];
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort didReceivePacket:(NSData *)packetData matchingDescriptor:(ORSSerialPacketDescriptor *)descriptor
+{
+	if ([descriptor.userInfo isKindOfClass:[NSMutableArray class]]) {
+		[(NSMutableArray *)descriptor.userInfo addObject:packetData];
+		return;
+	}
+	XCTAssertEqualObjects(packetData, [@"!hello;" dataUsingEncoding:NSASCIIStringEncoding], @"Unexpected packet received.");
+	[(XCTestExpectation *)descriptor.userInfo fulfill];
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort requestDidTimeout:(ORSSerialRequest *)request
+{
+	[(XCTestExpectation *)request.userInfo fulfill];
+}
+
+- (void)serialPort:(ORSSerialPort *)serialPort requestDidExpire:(ORSSerialRequest *)request
+{
+	[(XCTestExpectation *)request.userInfo fulfill];
+}
+
 @end